@@ -1,13 +1,30 @@
 ////////////////////////////////////////////////////////////////////////////////
 /*  LUXSimBST.hh
 *
-* This is the header for the Binary Search Tree
+* This is the header for the time-ordered event record. It keeps only the
+* earliest numEvents decays offered to it, in a max-heap keyed on the decay
+* time, so a candidate later than everything kept is rejected in constant time
+* and no empty placeholder nodes are needed. Once events start being taken
+* off the front, the heap is sorted in place and consumed in time order.
+*
+* In streaming mode there is no bound: the record is a min-heap that events
+* are added to while the run goes on, and the earliest is always on top. The
+* manager keeps it topped up from the sources' event streams. A sorted record
+* that is added to becomes the same kind of min-heap. Every operation is
+* iterative, and none is worse than O(log n) apart from GetLast and PopLast on
+* a min-heap, which look through its leaves.
 *
 ********************************************************************************
 * Change log
 *  21 Jul 2011 - Initial Submission (Nick)
 *  14 Jul 2012 - Add to decayNode variables to accept all generators (Nick)
 *  22 Aug 2012 - Fix BST timing to *ns and add warning messages (Nick)
+*  17 Oct 2026 - Replaced the pre-built binary search tree with a bounded
+*                max-heap that only holds the earliest numEvents decays (agent)
+*  17 Oct 2026 - Added GetCutoffTime (agent)
+*  17 Oct 2026 - Added the streaming mode (agent)
+*  17 Oct 2026 - Keeps track of the most events it has held at once (agent)
+*  17 Oct 2026 - Inserting into a sorted record turns it into a min-heap (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -25,6 +42,7 @@
 
 //  C++ includes
 //
+#include <cfloat>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -39,14 +57,14 @@ struct decayNode {
     // IDs used to call GenereateFromEventList methods
     G4int sourceByVolumeID;//for manager->geometry
     G4int sourcesID;//geometry->generators
-    decayNode *left;
-    decayNode *right;
+    // Insertion count, so that decays at identical times keep their order
+    long long insertOrder;
 };
 
 class LUXSimBST
 {
   public:
-    LUXSimBST( G4int, G4double, G4double, G4int );
+    LUXSimBST( G4int, G4bool streamingMode = false );
     ~LUXSimBST();
     void Insert( Isotope*, G4double, G4ThreeVector, G4int, G4int);
     decayNode *GetEarliest();
@@ -54,24 +72,40 @@ class LUXSimBST
     void PopEarliest();
     void PopLast();
     void PrintNodes();
-    inline G4bool HasNodes() { return hasNodes; };
-    inline G4int GetNumNonemptyNodes() { return numNonemptyNodes; };
-    
+    inline G4bool HasNodes() { return GetNumNonemptyNodes() > 0; };
+    inline G4int GetNumNonemptyNodes()
+        { return (G4int)nodes.size() - firstNode; };
+    // The most events held at once, and the memory that took (bytes, not
+    // counting particle names too long to fit in the string itself)
+    inline G4int GetPeakNumNodes() { return peakNumNodes; };
+    inline G4double GetPeakMemory()
+        { return (G4double)peakCapacity*sizeof(decayNode); };
+    // Decays at or after this time would be turned away by Insert
+    inline G4double GetCutoffTime() {
+        if( numEvents <= 0 ) return -DBL_MAX;
+        if( minHeap || sorted || GetNumNonemptyNodes() < numEvents )
+            return DBL_MAX;
+        return nodes.front().timeOfEvent;
+    };
+
     typedef decayNode pubDecayNode;
 
   private:
+    void SortNodes();
+    G4int GetLatestInMinHeap();
+
     G4int numEvents;
-    G4int numNonemptyNodes;
-    G4int numNodes;
-    G4bool hasNodes;
-    decayNode *topNode;
-    decayNode *Insert( Isotope*, G4double, G4ThreeVector, G4int, G4int,
-        decayNode* );
-    void PrintNodes( decayNode* );
+    long long numInserted;
 
-    G4int nodeCount;
-    G4int warningsWritten,warningsWritten1e4, warningsWritten1e5;
-    std::vector<Isotope*> allIsotopes;
-  
+    // While the list is being built, nodes is a max-heap on the decay time.
+    // After SortNodes it is in time order, and the events before firstNode
+    // have already been used. When streaming, or once a sorted record is added
+    // to, nodes is a min-heap instead and firstNode stays at 0.
+    std::vector<decayNode> nodes;
+    G4bool sorted;
+    G4bool minHeap;
+    G4int firstNode;
+    G4int peakNumNodes;
+    size_t peakCapacity;
 };
 #endif
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimEventsFile.hh
+*
+* This is the header file for the reader used by the EventsFile generator. The
+* events file lists energy deposits, one per line, as
+*
+*	<event number> <particle ID> <energy (keV)> <x (cm)> <y (cm)> <z (cm)>
+*
+* with the deposits of each event on consecutive lines. The reader also takes
+* the binary version of the file written by tools/LUXSimEventsFileConverter,
+* which it memory-maps instead of parsing. Either way, the deposits are indexed
+* by event so that any event can be fetched directly.
+*
+* The binary file is a header (format tag, version, number of deposits, number
+* of events), the deposits as eventsFileDeposit structs, and then the index:
+* the position of the first deposit of each event, plus one entry for the end.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LUXSimEventsFile_HH
+#define LUXSimEventsFile_HH 1
+
+//
+//	C/C++ includes
+//
+#include <vector>
+
+//
+//	GEANT4 includes
+//
+#include "globals.hh"
+
+//
+//	Definitions
+//
+#define EVENTSFILE_TAG 0x4C584556
+#define EVENTSFILE_VERSION 1
+
+//	One deposit, in the units of the text file
+struct eventsFileDeposit {
+	G4int eventNumber;
+	G4int particleID;
+	G4double energy_keV;
+	G4double position_cm[3];
+};
+
+struct eventsFileHeader {
+	G4int formatTag;
+	G4int version;
+	long long numDeposits;
+	long long numEvents;
+};
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+class LUXSimEventsFile
+{
+	public:
+		LUXSimEventsFile();
+		~LUXSimEventsFile();
+
+		void Open( G4String fileName );
+		void Close();
+
+		G4int GetNumEvents() { return numEvents; };
+		long long GetNumDeposits() { return numDeposits; };
+
+		//	Returns the deposits of the index'th event in the file (not the
+		//	event number written in the file), and how many there are
+		const eventsFileDeposit *GetEvent( G4int index, G4int &numInEvent );
+
+	private:
+		G4bool OpenBinary( G4String fileName );
+		void ReadText( G4String fileName );
+
+	private:
+		long long numDeposits;
+		G4int numEvents;
+
+		//	These point either into the vectors below (text files) or into
+		//	the mapped file (binary files)
+		const eventsFileDeposit *deposits;
+		const long long *eventStart;
+
+		std::vector<eventsFileDeposit> depositStorage;
+		std::vector<long long> eventStartStorage;
+
+		void *mappedFile;
+		size_t mappedSize;
+};
+
+#endif
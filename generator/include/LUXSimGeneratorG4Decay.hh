@@ -6,6 +6,7 @@
 ********************************************************************************
 * Change log
 *    06-Oct-2015 - Initial submission (David W)
+*    17-Oct-2026 - Removed uiString, now that the ion is set directly (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,7 +58,6 @@ class LUXSimGeneratorG4Decay : public LUXSimSource
 
     private:
         G4ParticleDefinition *ion ;
-        G4String uiString;
         G4int nucleusA;
         G4int nucleusZ;
 };
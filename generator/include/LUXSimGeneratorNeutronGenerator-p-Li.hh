@@ -7,6 +7,8 @@
 * Change log
 *    25 August 2011 - Initial submission (Mike)
 *    14-Jul-2012 - GenerateEvent changed to use binary search tree (Nick)
+*    17-Oct-2026 - The spectrum is loaded from a data file, and sampled from
+*                  CDFs built over the angle window (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +21,11 @@
 //
 #include "globals.hh"
 
+//
+//    C/C++ includes
+//
+#include <vector>
+
 //
 //    LUXSim includes
 //
@@ -40,6 +47,10 @@ class LUXSimGeneratorpLithium : public LUXSimSource
         //void GenerateEvent( G4GeneralParticleSource*, G4Event* );
 
     private:
+        void LoadSpectrum( G4String );
+        G4double GetCountsAtAngle( G4double, G4int );
+        void BuildAngleWindow();
+        G4double SampleLinear( G4double, G4double, G4double );
         void GetNeutronEnergy();
 
 
@@ -48,18 +59,25 @@ class LUXSimGeneratorpLithium : public LUXSimSource
         G4ParticleDefinition *neutronDef;
         G4ParticleDefinition *gammaDef;
         
-        G4double neutronAnglePDF[28000];
-        G4double neutronEnergyPDF[28000];
-        G4double neutronCountPDF[28000];
+        //    The spectrum, as counts on a grid of cos(polar angle) and
+        //    energy (keV), stored [angle][energy]
+        G4int numAngles;
+        G4int numEnergies;
+        std::vector<G4double> spectrumAngles;
+        std::vector<G4double> spectrumEnergies;
+        std::vector<G4double> spectrumCounts;
     
-        G4double energy;
-        G4double angle;
+        //    The angle window cut into slices at the grid rows, the counts at
+        //    the slice edges [edge][energy], the CDF over the slices, and the
+        //    CDF over the energy bins of each slice [slice][bin]
+        std::vector<G4double> sliceEdges;
+        std::vector<G4double> sliceCounts;
+        std::vector<G4double> sliceCDF;
+        std::vector<G4double> energyCDF;
     
         G4double neutronEnergy;
         G4double neutronAngle;
     
-        G4double testcount;
-    
         G4double lowang;
         G4double highang;
         G4double lowangDegrees;
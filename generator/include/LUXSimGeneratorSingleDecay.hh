@@ -9,6 +9,7 @@
 *   04-Mar-12 - Fixed bug where primary particle was both the LUXSource default
 *               and the user specified SingleDecay (Nick)
 *   14-Jul-12 - GenerateEvent method changed to use binary search tree (Nick)
+*   17-Oct-26 - Removed uiString, now that the ion is set directly (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,7 +57,6 @@ class LUXSimGeneratorSingleDecay : public LUXSimSource
     private:
         G4ParticleDefinition *ion ;
         //std::stringstream uiStream;
-        G4String uiString;
         G4int nucleusA;
         G4int nucleusZ;
 
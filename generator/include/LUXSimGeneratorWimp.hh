@@ -10,6 +10,8 @@
 *                 escape velocities. (Daniel)
 *   14-Jul-2012 - GenerateEvent replaced with GenerateEventList and 
 *                 GenerateFromEventList (Nick)
+*   17-Oct-26 - Added the table of recoil spectra, which are worked out once
+*               per WIMP mass and isotope (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +19,12 @@
 #ifndef LUXSimGeneratorWimp_HH
 #define LUXSimGeneratorWimp_HH 1
 
+//
+//	C/C++ includes
+//
+#include <map>
+#include <vector>
+
 //
 //	GEANT4 includes
 //
@@ -45,8 +53,19 @@ class LUXSimGeneratorWimp : public LUXSimSource
 
     private:
         G4double dR(G4double, G4double, G4double);
+        void BuildRecoilSpectra( G4double wimpMass );
         G4ParticleDefinition *ion;
 
+        //  The recoil spectrum of a WIMP mass on one xenon isotope, as the end
+        //  point of the spectrum and the cumulative distribution of its bins.
+        //  The spectra are kept by WIMP mass (in GeV), one per isotope, for
+        //  as long as the generator is around.
+        struct recoilSpectrum {
+            G4double endPoint;//keV
+            std::vector<G4double> cdf;
+        };
+        std::map< G4double, std::vector<recoilSpectrum> > recoilSpectra;
+
 };
 
 #endif
@@ -6,6 +6,8 @@
 ********************************************************************************
 * Change log
 *  21 Jul 2011 - Initial Submission (Nick)
+*  17 Oct 2026 - Name and GetParticleName return references, since the event
+*                list copies them for every event (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,13 +39,13 @@ class Isotope
       Isotope( G4String, G4int, G4int, G4double );//All Generators except...
       Isotope( G4String, G4int, G4int, G4String, G4double );//SingleParticle
       
-      inline G4String Name() { return name; };
+      inline const G4String &Name() { return name; };
       void AddDaughter( Isotope*, G4double );
       Isotope *GetNextDaughter();
       inline G4int GetZ() { return Z; };
       inline G4int GetA() { return A; };
       inline G4double GetHalflife() { return halflife; };
-      inline G4String GetParticleName() { return particleName; };
+      inline const G4String &GetParticleName() { return particleName; };
       inline G4double GetEnergy() { return energy; };
       inline void SetPopulation( G4double pop ) { population = pop; };
       inline G4double GetPopulation() { return population; };
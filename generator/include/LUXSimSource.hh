@@ -19,6 +19,7 @@
 *                 so DetectorComponent stops asking for new decays after the
 *                 recordTree timeWindow is reaches (Nick)
 *   18-Dec-2015 - Added a GenerateEvent for the muon generator (David W) (merged into git by Doug T)
+*   17-Oct-2026 - Added GetIon, SetIon and SetNucleusLimits (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +102,16 @@ class LUXSimSource
 		virtual G4ParticleDefinition *GetParticleDefinition()
 			{ return G4Gamma::Definition(); };
 
+		//	These set the primary ion and the radioactive decay limits
+		//	directly, rather than with the /gps/ion and /grdm/nucleusLimits
+		//	commands, so that generating a primary doesn't go through the UI.
+		//	Ions are looked up in the ion table once and then cached.
+		G4ParticleDefinition *GetIon( G4int Z, G4int A,
+				G4double excitationEnergy = 0 );
+		void SetIon( G4GeneralParticleSource*, G4int Z, G4int A,
+				G4double excitationEnergy = 0, G4int charge = 0 );
+		void SetNucleusLimits( G4int A, G4int Z );
+
     protected:
 		LUXSimManager *luxManager;
 	
@@ -1,210 +1,198 @@
 ////////////////////////////////////////////////////////////////////////////////
 /*  LUXSimBST.cc
 *
-* This is the code for the Binary Search Tree
+* This is the code for the time-ordered event record
 *
 ********************************************************************************
 * Change log
 *  21 Jul 2011 - Initial Submission (Nick)
-*  14 Jul 2012 - Edit PrintNode to be useful for all sources instead of just 
-*                the Decay Chain. Add ParticleName and Energy to node for 
+*  14 Jul 2012 - Edit PrintNode to be useful for all sources instead of just
+*                the Decay Chain. Add ParticleName and Energy to node for
 *                Wimp and SingleParticle  (Nick)
 *  22 Aug 2012 - BST timing bug fixed with *ns units. Warning also added (Nick)
 *  25 Apr 2014 - Plugged a memory leak where the empty isotopes weren't getting
 *                deleted between subsequent calls to /LUXSim/beamOn (Kareem)
 *  19 May 2014 - Changed the print order of the PrintNodes method so that the
 *                output is time-ordered (Kareem)
+*  17 Oct 2026 - The record is now a max-heap bounded at numEvents instead of
+*                a binary search tree seeded with empty nodes. Late candidates
+*                are rejected on arrival rather than trimmed afterwards. (agent)
+*  17 Oct 2026 - Added the streaming mode, where the record is an unbounded
+*                min-heap that events are added to and taken from while the
+*                run goes on (agent)
+*  17 Oct 2026 - Records the peak number of events held, and the memory used
+*                (agent)
+*  17 Oct 2026 - A decay inserted after the record has been sorted turns it
+*                into a min-heap instead of being inserted in place, so no
+*                insert costs more than O(log n). GetLast and PopLast work on
+*                the min-heap too. (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
 #include "globals.hh"
 #include "LUXSimBST.hh"
 #include <iostream>
-#include <list>
+#include <algorithm>
 #include <fstream>
 
-LUXSimBST::LUXSimBST( G4int numInitLevels, G4double windowStart, G4double 
-        windowEnd, G4int numEvts )
+////////////////////////////////////////////////////////////////////////////////
+//  Orders nodes by decay time, and by insertion order for identical times. The
+//  heap keeps the "largest" node, i.e., the latest decay, on top.
+static G4bool DecayNodeLater( const decayNode &a, const decayNode &b )
 {
-  //  Record the total number of events so that they can get popped off the
-  //  end of the search tree as necessary
-  numEvents = numEvts;
-  numNonemptyNodes = 0;
-  numNodes = 0;
+    if( a.timeOfEvent != b.timeOfEvent )
+        return a.timeOfEvent < b.timeOfEvent;
+    return a.insertOrder < b.insertOrder;
+}
 
-  nodeCount=0;
-  warningsWritten=0;
-  warningsWritten1e4=0;
-  warningsWritten1e5=0;
+////////////////////////////////////////////////////////////////////////////////
+//  The reverse order, for the min-heap of the streaming mode and of a record
+//  that is added to after it has been sorted
+static G4bool DecayNodeEarlier( const decayNode &a, const decayNode &b )
+{
+    return DecayNodeLater( b, a );
+}
 
-  //  Create the first level with a node in the middle of the decay time space
-  topNode = new decayNode;
-  topNode->Z = 0;
-  topNode->A = 0;
-  topNode->particleName = "";
-  topNode->energy = 0;
-  topNode->timeOfEvent = (windowEnd + windowStart)*1.e9*ns/2. ;//in nanoseconds
-  topNode->sourceByVolumeID=-1;
-  topNode->sourcesID=-1;
-  topNode->left = 0;
-  topNode->right = 0;
-  
-  //  Now step through each additional initialization level, creating the
-  //  other emptry nodes, always chopping the remaining space into halves.
-  //  Note that the topmost level is level 1, so we start here with level 2.
-  Isotope *tmpIso = 0;
-  
-  for( G4int i=2; i<=numInitLevels; i++ ) {
-    G4double timeStep = (windowEnd + windowStart)/pow(2,i) *1.e9*ns ;//nanoseconds
-    G4double runningTime = windowStart*1.e9*ns + timeStep;//ns
-    G4int numPointsInLevel = (G4int) pow( 2, i-1 );
-    //if(numPointsInLevel<100)std::cout << "BST nodePoint " << numPointsInLevel 
-    //           << " times created: " << std::endl;
-    for( G4int j=0; j<numPointsInLevel; j++ ) {
-      tmpIso = new Isotope( "Empty", 0, 0, 0 );
-      allIsotopes.push_back( tmpIso );
-      Insert( tmpIso, runningTime, G4ThreeVector(0,0,0), -1, -1, topNode );
-      //if(numPointsInLevel<100) std::cout << j << ":" << runningTime/ns << " ";
-      runningTime += 2*timeStep ;
-    }
-    //if(numPointsInLevel<100) std::cout << "\n" << std::endl;
-  }
-  G4cout << "Finished building empty nodes in BST" << G4endl;
-  
-  hasNodes = true;
+////////////////////////////////////////////////////////////////////////////////
+LUXSimBST::LUXSimBST( G4int numEvts, G4bool streamingMode )
+{
+  //  Only the earliest numEvents decays are ever kept, unless streaming
+  numEvents = numEvts;
+  numInserted = 0;
+  sorted = false;
+  minHeap = streamingMode;
+  firstNode = 0;
+  peakNumNodes = 0;
+  peakCapacity = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 LUXSimBST::~LUXSimBST()
 {
-    for( G4int i=0; i<(G4int)allIsotopes.size(); i++ )
-        delete allIsotopes[i];
-    allIsotopes.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void LUXSimBST::Insert( Isotope *iso, G4double theTime, G4ThreeVector Pos, 
+void LUXSimBST::Insert( Isotope *iso, G4double theTime, G4ThreeVector Pos,
                   G4int sourceByVolumeID, G4int sourcesID )
 {
-    nodeCount=0;
     // Time sent and received in nanoseconds
-    Insert( iso, theTime, Pos, sourceByVolumeID, sourcesID, topNode );
-
-    if( nodeCount>1000 && warningsWritten<10) {
-        G4cout << "    Filling BST in progress. BST depth reached: " << nodeCount 
-               << " (Max 10 warnings)" << G4endl;
-        G4cout << "      time of event: " << theTime/ns << " ns" << G4endl;
-        warningsWritten++;
+    if( numEvents <= 0 )
+        return;
+
+    //  Once the record is full, a decay later than the latest one kept can
+    //  never make it into the run, so don't bother building its node
+    if( !minHeap && !sorted && GetNumNonemptyNodes() >= numEvents &&
+            theTime >= nodes.front().timeOfEvent )
+        return;
+
+    decayNode newNode;
+    newNode.Z = iso->GetZ();
+    newNode.A = iso->GetA();
+    newNode.timeOfEvent = (theTime);//set in nanoseconds
+    newNode.pos = Pos;
+    newNode.sourceByVolumeID = sourceByVolumeID;
+    newNode.sourcesID = sourcesID;
+    // used only for SingleParticle and SingleDecay respectively
+    newNode.particleName = iso->GetParticleName();
+    newNode.energy = iso->GetEnergy();
+    newNode.insertOrder = numInserted++;
+
+    if( sorted ) {
+        //  Events are already being used. Inserting in place would move every
+        //  later event, but what is left of a sorted list is already a
+        //  min-heap, so carry on as one.
+        nodes.erase( nodes.begin(), nodes.begin() + firstNode );
+        firstNode = 0;
+        sorted = false;
+        minHeap = true;
     }
-    if( nodeCount>10000 && warningsWritten1e4<10 ) {
-        G4cout << "    Warning BST depth exceeding 10000. (Max 10 warnings)" << G4endl;
-        G4cout << "      time of event: " << theTime/ns << " ns" << G4endl;
-        warningsWritten1e4++;
-    }
-    if( nodeCount>100000 && warningsWritten1e5<10 ) {
-        G4cout << "    Warning BST depth exceeding 100000 !!! "
-               << " (Max 10 warnings)" << G4endl;
-        G4cout << "      time of event: " << theTime/ns << " ns" << G4endl;
-        warningsWritten1e5++;
+
+    if( minHeap ) {
+        nodes.push_back( newNode );
+        std::push_heap( nodes.begin(), nodes.end(), DecayNodeEarlier );
+    } else if( GetNumNonemptyNodes() < numEvents ) {
+        nodes.push_back( newNode );
+        std::push_heap( nodes.begin(), nodes.end(), DecayNodeLater );
+    } else {
+        //  Replace the latest decay in the record with this one
+        std::pop_heap( nodes.begin(), nodes.end(), DecayNodeLater );
+        nodes.back() = newNode;
+        std::push_heap( nodes.begin(), nodes.end(), DecayNodeLater );
     }
 
-    //  We don't want more events in the window than asked for, so if the tree
-    //  gets too big, pop the last one from the BST.
-    if( numNonemptyNodes > numEvents+2 )
-        PopLast();
+    if( GetNumNonemptyNodes() > peakNumNodes )
+        peakNumNodes = GetNumNonemptyNodes();
+    if( nodes.capacity() > peakCapacity )
+        peakCapacity = nodes.capacity();
 }
+
 ////////////////////////////////////////////////////////////////////////////////
-decayNode *LUXSimBST::Insert( Isotope *iso, G4double theTime, G4ThreeVector Pos,
-    G4int sourceByVolumeID, G4int sourcesID, decayNode *searchNode )
+void LUXSimBST::SortNodes()
 {
-    decayNode *newNode = searchNode;
+    //  A min-heap is never sorted, since events may keep arriving
+    if( sorted || minHeap )
+        return;
 
-    if( !searchNode ) {
-        newNode = new decayNode;
+    std::sort_heap( nodes.begin(), nodes.end(), DecayNodeLater );
+    sorted = true;
+    firstNode = 0;
+}
 
-        newNode->Z = iso->GetZ();
-        newNode->A = iso->GetA();
-        newNode->timeOfEvent = (theTime);//set in nanoseconds
-        newNode->pos = Pos;
-        newNode->left = 0;
-        newNode->right = 0;
-        newNode->sourceByVolumeID = sourceByVolumeID;
-        newNode->sourcesID = sourcesID;
-        // used only for SingleParticle and SingleDecay respectively
-        newNode->particleName = iso->GetParticleName();
-        newNode->energy = iso->GetEnergy();
-        
-        numNodes++;
-        if( newNode->Z )
-            numNonemptyNodes++;
-        
-    } else if( theTime < searchNode->timeOfEvent ) {
-        nodeCount++;
-        searchNode->left = Insert( iso, theTime, Pos, sourceByVolumeID,
-                sourcesID, searchNode->left );
-    }
-    else {
-        nodeCount++;
-        searchNode->right = Insert( iso, theTime, Pos, sourceByVolumeID,
-                sourcesID, searchNode->right );
-    }
+////////////////////////////////////////////////////////////////////////////////
+decayNode *LUXSimBST::GetEarliest()
+{
+    SortNodes();
+    if( !GetNumNonemptyNodes() )
+        return 0;
 
-    return newNode;
+    //  For a min-heap, firstNode is 0 and this is the top of it
+    return &nodes[firstNode];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-decayNode *LUXSimBST::GetEarliest()
+G4int LUXSimBST::GetLatestInMinHeap()
 {
-    decayNode *tmpNode = topNode;
-    while( tmpNode->left )
-        tmpNode = tmpNode->left;
-    
-    return tmpNode;
+    //  The latest node of a min-heap is one of the leaves, which are the
+    //  second half of it
+    G4int latest = (G4int)nodes.size()/2;
+    for( G4int i=latest+1; i<(G4int)nodes.size(); i++ )
+        if( DecayNodeLater( nodes[latest], nodes[i] ) )
+            latest = i;
+    return latest;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decayNode *LUXSimBST::GetLast()
 {
-    decayNode *tmpNode = topNode;
-    while( tmpNode->right )
-        tmpNode = tmpNode->right;
-    
-    return tmpNode;
+    if( !GetNumNonemptyNodes() )
+        return 0;
+    if( minHeap )
+        return &nodes[GetLatestInMinHeap()];
+    if( !sorted )
+        return &nodes.front();
+
+    return &nodes.back();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void LUXSimBST::PopEarliest()
 {
-    //  Start with the top node, and find the last node that actually branches
-    //  to the left.
-    decayNode *tmpNode = topNode;
-    if( topNode ) {
-        if( tmpNode->left ) {
-            while( ((decayNode*)(tmpNode->left))->left )
-                tmpNode = tmpNode->left;
-        
-            decayNode *earliestNode = tmpNode->left;
-        
-            if( earliestNode->right )
-                tmpNode->left = earliestNode->right;
-            else
-                tmpNode->left = 0;
-            
-            if( earliestNode->Z )
-                numNonemptyNodes--;
-            delete earliestNode;
-
-        } else if( tmpNode->right ) {
-            //  The top node is the earliest node
-            topNode = topNode->right;
-            if( tmpNode->Z )
-                numNonemptyNodes--;
-            delete tmpNode;
-        } else {
-            //  The top node is the only node
-            topNode = 0;
-            hasNodes = false;
+    if( minHeap ) {
+        if( GetNumNonemptyNodes() ) {
+            std::pop_heap( nodes.begin(), nodes.end(), DecayNodeEarlier );
+            nodes.pop_back();
         }
+        return;
+    }
+
+    SortNodes();
+    if( GetNumNonemptyNodes() )
+        firstNode++;
+
+    //  Give back the memory of the used events every so often
+    if( firstNode > 1048576 && firstNode > GetNumNonemptyNodes() ) {
+        nodes.erase( nodes.begin(), nodes.begin() + firstNode );
+        firstNode = 0;
     }
 }
 
@@ -212,65 +200,54 @@ void LUXSimBST::PopEarliest()
 ////////////////////////////////////////////////////////////////////////////////
 void LUXSimBST::PopLast()
 {
-  //  Start with the top node, and find the last node that actually branches
-  //  to the right.
-  decayNode *tmpNode = topNode;
-  if( topNode ) {
-    if( tmpNode->right ) {
-      while( ((decayNode*)(tmpNode->right))->right )
-        tmpNode = tmpNode->right;
-    
-      decayNode *lastNode = tmpNode->right;
-      
-      if( lastNode->left )
-        tmpNode->right = lastNode->left;
-      else
-        tmpNode->right = 0;
-      
-      if( lastNode->Z != 0 )
-        numNonemptyNodes--;
-      delete lastNode;
-
-    } else if( tmpNode->left ) {
-      //  The top node is the last node
-      topNode = topNode->left;
-      if( tmpNode->Z )
-        numNonemptyNodes--;
-      delete tmpNode;
-    } else {
-      //  The top node is the only node
-      topNode = 0;
-      hasNodes = false;
-    }
+  if( !GetNumNonemptyNodes() )
+    return;
+
+  if( minHeap ) {
+    //  Move the last node into the latest one's place. The latest is a leaf,
+    //  so the moved node can only need to go up.
+    G4int latest = GetLatestInMinHeap();
+    nodes[latest] = nodes.back();
+    nodes.pop_back();
+    if( latest < (G4int)nodes.size() )
+      std::push_heap( nodes.begin(), nodes.begin() + latest + 1,
+              DecayNodeEarlier );
+    return;
   }
-}
 
-////////////////////////////////////////////////////////////////////////////////
-void LUXSimBST::PrintNodes()
-{
-  PrintNodes( topNode );
+  if( !sorted )
+    std::pop_heap( nodes.begin(), nodes.end(), DecayNodeLater );
+  nodes.pop_back();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void LUXSimBST::PrintNodes( decayNode *tmpNode )
+void LUXSimBST::PrintNodes()
 {
-    if( tmpNode->left )
-      PrintNodes( tmpNode->left );
-    if( tmpNode->Z ) {
-      G4cout << "RecordTreePrint:Z_a_t_(name) <|> volID srcID: " 
-      //G4cout << "RecordTreePrint:Z_A_t.pos.1_2: " 
-              << tmpNode->Z << " " << tmpNode->A << " " 
+    //  A min-heap is printed from a sorted copy, so that it stays a heap
+    std::vector<decayNode> ordered;
+    std::vector<decayNode> *toPrint = &nodes;
+    G4int first = firstNode;
+    if( minHeap ) {
+        ordered = nodes;
+        std::sort( ordered.begin(), ordered.end(), DecayNodeLater );
+        toPrint = &ordered;
+        first = 0;
+    } else
+        SortNodes();
+
+    for( G4int i=first; i<(G4int)toPrint->size(); i++ ) {
+      decayNode *tmpNode = &(*toPrint)[i];
+      G4cout << "RecordTreePrint:Z_a_t_(name) <|> volID srcID: "
+      //G4cout << "RecordTreePrint:Z_A_t.pos.1_2: "
+              << tmpNode->Z << " " << tmpNode->A << " "
               << tmpNode->timeOfEvent << " ";
-      if(tmpNode->particleName != "" )  
+      if(tmpNode->particleName != "" )
           G4cout << tmpNode->particleName << "_" << tmpNode->energy;
-      G4cout << "\t<|> " 
+      G4cout << "\t<|> "
           //    << tmpNode->pos.getX() << " "
           //    << tmpNode->pos.getY() << " "
-          //    << tmpNode->pos.getZ() << " _|\t" 
+          //    << tmpNode->pos.getZ() << " _|\t"
               << tmpNode->sourceByVolumeID << " "
               << tmpNode->sourcesID << G4endl;
-        //<< ", left = " << tmpNode->left << ", right = " << tmpNode->right
     }
-    if( tmpNode->right )
-      PrintNodes( tmpNode->right );
 }
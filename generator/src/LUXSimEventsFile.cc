@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimEventsFile.cc
+*
+* This is the code file for the reader used by the EventsFile generator. See
+* the header for the text and binary formats.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <fstream>
+#include <cstdlib>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//
+//	LUXSim includes
+//
+#include "LUXSimEventsFile.hh"
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LUXSimEventsFile()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimEventsFile::LUXSimEventsFile()
+{
+	numDeposits = 0;
+	numEvents = 0;
+	deposits = NULL;
+	eventStart = NULL;
+	mappedFile = NULL;
+	mappedSize = 0;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					~LUXSimEventsFile()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimEventsFile::~LUXSimEventsFile()
+{
+	Close();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Close()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimEventsFile::Close()
+{
+	if( mappedFile )
+		munmap( mappedFile, mappedSize );
+	mappedFile = NULL;
+	mappedSize = 0;
+
+	std::vector<eventsFileDeposit>().swap( depositStorage );
+	std::vector<long long>().swap( eventStartStorage );
+
+	numDeposits = 0;
+	numEvents = 0;
+	deposits = NULL;
+	eventStart = NULL;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Open()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimEventsFile::Open( G4String fileName )
+{
+	Close();
+
+	std::ifstream file( fileName.c_str(), std::ios::binary );
+	if( !file.is_open() ) {
+		G4cout<<G4endl<<G4endl<<G4endl;
+		G4cout<<"Events File Not Found!"<<G4endl;
+		G4cout<<G4endl<<G4endl<<G4endl;
+		exit(0);
+	}
+
+	//	Binary files are recognized by their format tag, not their name
+	G4int formatTag = 0;
+	file.read( (char*)(&formatTag), sizeof(G4int) );
+	file.close();
+
+	if( formatTag == EVENTSFILE_TAG ) {
+		if( !OpenBinary( fileName ) ) {
+			G4cout << "Could not read the binary events file " << fileName
+				   << G4endl;
+			exit(0);
+		}
+	} else
+		ReadText( fileName );
+
+	G4cout << "Events file " << fileName << ": " << numEvents << " events, "
+		   << numDeposits << " deposits" << G4endl;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					OpenBinary()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimEventsFile::OpenBinary( G4String fileName )
+{
+	G4int fd = open( fileName.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return false;
+
+	struct stat fileStat;
+	if( fstat( fd, &fileStat ) != 0 ||
+			(size_t)fileStat.st_size < sizeof(eventsFileHeader) ) {
+		close( fd );
+		return false;
+	}
+
+	size_t fileSize = fileStat.st_size;
+	void *mapped = mmap( NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( mapped == MAP_FAILED )
+		return false;
+
+	const eventsFileHeader *header = (const eventsFileHeader*)mapped;
+	size_t expectedSize = sizeof(eventsFileHeader) +
+			header->numDeposits*sizeof(eventsFileDeposit) +
+			(header->numEvents+1)*sizeof(long long);
+	if( header->version != EVENTSFILE_VERSION || fileSize != expectedSize ) {
+		munmap( mapped, fileSize );
+		return false;
+	}
+
+	mappedFile = mapped;
+	mappedSize = fileSize;
+	numDeposits = header->numDeposits;
+	numEvents = (G4int)header->numEvents;
+	deposits = (const eventsFileDeposit*)((const char*)mapped +
+			sizeof(eventsFileHeader));
+	eventStart = (const long long*)(deposits + numDeposits);
+
+	return true;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadText()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimEventsFile::ReadText( G4String fileName )
+{
+	std::ifstream file( fileName.c_str() );
+
+	eventsFileDeposit deposit;
+	while( 1 ) {
+		file >> deposit.eventNumber >> deposit.particleID
+			 >> deposit.energy_keV >> deposit.position_cm[0]
+			 >> deposit.position_cm[1] >> deposit.position_cm[2];
+		if( file.fail() )
+			break;
+
+		//	A new event starts wherever the event number changes
+		if( depositStorage.empty() ||
+				depositStorage.back().eventNumber != deposit.eventNumber )
+			eventStartStorage.push_back( depositStorage.size() );
+		depositStorage.push_back( deposit );
+	}
+	eventStartStorage.push_back( depositStorage.size() );
+
+	numDeposits = depositStorage.size();
+	numEvents = eventStartStorage.size() - 1;
+	deposits = numDeposits ? &depositStorage[0] : NULL;
+	eventStart = &eventStartStorage[0];
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+const eventsFileDeposit *LUXSimEventsFile::GetEvent( G4int index,
+		G4int &numInEvent )
+{
+	if( index < 0 || index >= numEvents ) {
+		numInEvent = 0;
+		return NULL;
+	}
+
+	numInEvent = (G4int)(eventStart[index+1] - eventStart[index]);
+	if( DEBUGGING )
+		G4cout << "Events file event " << index << " (event number "
+			   << deposits[eventStart[index]].eventNumber << "), "
+			   << numInEvent << " deposits" << G4endl;
+
+	return deposits + eventStart[index];
+}
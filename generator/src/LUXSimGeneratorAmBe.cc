@@ -1168,8 +1168,8 @@ void LUXSimGeneratorAmBe::GenerateEventList( G4ThreeVector position,
 {
     G4int a=-1; G4int z=-1;
     G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );    
 }
 
@@ -10,6 +10,10 @@
 *                 (Nick)
 *    22 Aug 2012 - Fix RecordTreeInsert to insert in *ns (Nick)
 *    24 Aug 2012 - Add time unit specification to variables (Nick)
+*    17 Oct 2026 - Populations are sized for the manager's event list rather
+*                  than for the events of this process (agent)
+*    17 Oct 2026 - The primary ion and nucleus limits are set directly rather
+*                  than with UI commands (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -295,7 +299,7 @@ void LUXSimGeneratorDecayChain::CalculatePopulationsInEventList(G4double
     //Isotope *origIso = isoArrayTh[0]; 
     //G4double Th228pop = populationTh[3];
     No = initialActivity * origIso->GetHalflife() / log(2.);
-    G4int numEvents = luxManager->GetNumEvents();
+    G4int numEvents = luxManager->GetNumEventListEvents();
     while( numEvents > No )
         No *= 2;
     G4double totalRate;
@@ -433,15 +437,8 @@ void LUXSimGeneratorDecayChain::GenerateFromEventList( G4GeneralParticleSource
     particleGun->GetCurrentSource()->GetPosDist()->SetCentreCoords(pos);
     particleGun->GetCurrentSource()->SetParticleTime( time*ns );
 
-    std::stringstream uistring;
-    uistring.str("");
-    uistring << "/gps/ion " << zee << " " << ehh << " 0 0" ;
-    UI->ApplyCommand(uistring.str());
-    uistring.clear();
-    uistring.str("");
-    uistring << "/grdm/nucleusLimits " << ehh << " " << ehh << " " << 
-                                          zee << " " << zee ;
-    UI->ApplyCommand(uistring.str());
+    SetIon( particleGun, zee, ehh );
+    SetNucleusLimits( ehh, zee );
 
     particleGun->GeneratePrimaryVertex(event);
     luxManager->AddPrimaryParticle( GetParticleInfo(particleGun) );
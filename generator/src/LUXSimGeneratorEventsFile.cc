@@ -6,6 +6,7 @@
 ********************************************************************************
 * Change log
 *   12 May 14 - Initial submission, for gamma-X event generation. (Kevin)
+*   17 Oct 26 - Ions are set directly rather than with /gps/ion
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,8 +54,8 @@ void LUXSimGeneratorEventsFile::GenerateEventList( G4ThreeVector position,
 {
     G4int a=-1; G4int z=-1;
     G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );
 }
 
@@ -68,7 +69,6 @@ void LUXSimGeneratorEventsFile::GenerateFromEventList( G4GeneralParticleSource
     G4int particleID;
     G4ThreeVector pos;
     G4int numDeposits = luxManager->NextEventToGenerate();
-    char command[100];
     for(G4int i = 0; i < numDeposits; i++) {
         pos = luxManager->NextPositionToGenerate();    
         G4double timeDelay = (firstNode->timeOfEvent)/ns;//stored as seconds
@@ -93,10 +93,7 @@ void LUXSimGeneratorEventsFile::GenerateFromEventList( G4GeneralParticleSource
             particleID = particleID/1000;
             G4int element = particleID;
             //Set the ion
-            sprintf(command, "/gps/ion  %d %d %d %d", element, isotope, charge, 0);
-
-           //Input the command string
-           UI->ApplyCommand(command);
+            SetIon( particleGun, element, isotope, 0., charge );
         }
         particleGun->GetCurrentSource()->GetAngDist()->
           SetParticleMomentumDirection( GetRandomDirection() );
@@ -6,6 +6,7 @@
 ********************************************************************************
 * Change log
 *   06-Oct-2015 - Initial submission (David W)
+*   17-Oct-2026 - Ions are set directly rather than with /gps/ion (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -72,8 +73,8 @@ void LUXSimGeneratorG4Decay::GenerateEventList(G4ThreeVector position,
 {
   //name, z, a, particlename, energy                                                                                    
   G4double halflife=0;
-  Isotope *currentIso = new Isotope(name, z, a, halflife);
-  luxManager->RecordTreeInsert( currentIso, time, position,
+  Isotope currentIso(name, z, a, halflife);
+  luxManager->RecordTreeInsert( &currentIso, time, position,
 				sourceByVolumeID, sourcesID );
   
 }
@@ -95,11 +96,7 @@ void LUXSimGeneratorG4Decay::GenerateFromEventList( G4GeneralParticleSource
   particleGun->GetCurrentSource()->GetPosDist()->SetCentreCoords(pos);
   particleGun->GetCurrentSource()->SetParticleTime( time*ns );
 
-  std::stringstream uiStream ;
-  uiStream.str("") ;
-  uiStream << "/gps/ion " << nucleusZ << " " << nucleusA << " 0 0" ;
-  uiString = uiStream.str() ;
-  UI->ApplyCommand( uiString );
+  SetIon( particleGun, nucleusZ, nucleusA );
 
   particleGun->GetCurrentSource()->GetAngDist()->SetParticleMomentumDirection( GetRandomDirection() );
   particleGun->GetCurrentSource()->GetEneDist()->SetMonoEnergy( 0.*keV );
@@ -204,19 +201,14 @@ std::vector<G4ParticleDefinition*> LUXSimGeneratorG4Decay::ProcessParticleDefs(s
       radTableCopy = radDecay->LoadDecayTable(*particleDefs[i]);
       if(radTableCopy->entries()==1){
 	G4ParticleDefinition *fakeParticle;
-	std::stringstream fakeUiStream;
-	G4String fakeUiString;
 	G4int ZZ;
 	G4int AA;
 	std::vector<int> v;
 	particleGun->GetCurrentSource()->SetParticleDefinition( ion );	
-	fakeUiStream.str("");
 	GetPDG(particleDefs[i]->GetPDGEncoding(),v);  // get PDG 
 	ZZ=100*v[3]+10*v[4]+v[5];                     // get atomic number 
 	AA=100*v[6]+10*v[7]+v[8];                     // get mass number    
-	fakeUiStream << "/gps/ion " << ZZ << " " << AA << " 0 0" ;
-	fakeUiString = fakeUiStream.str() ;
-	UI->ApplyCommand( fakeUiString );
+	SetIon( particleGun, ZZ, AA );
 	fakeParticle = particleGun->GetParticleDefinition();	
 	particleDefsKeep_tmp.push_back(fakeParticle);
       }
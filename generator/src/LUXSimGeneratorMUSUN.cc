@@ -126,10 +126,10 @@ void LUXSimGeneratorMUSUN::GenerateEventList(G4double time)
   G4ThreeVector position( 0,0,0 );
   G4int a=-1; G4int z=-1;
   G4double hl=-1;
-  Isotope *currentIso = new Isotope(name, z, a, hl);
+  Isotope currentIso(name, z, a, hl);
   G4int sourceByVolumeID = 0;
   G4int sourcesID = 0;
-  luxManager->RecordTreeInsert( currentIso, time, position, 
+  luxManager->RecordTreeInsert( &currentIso, time, position, 
 				sourceByVolumeID, sourcesID );
 }
 
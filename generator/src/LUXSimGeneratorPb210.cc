@@ -6,6 +6,8 @@
 ********************************************************************************
 * Change log
 *   07-Nov-2012 - Adapted from LUXSimGeneratorU238.cc. (Dave)
+*   17-Oct-2026 - The primary ion and nucleus limits are set directly rather
+*                 than with UI commands (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,8 +45,8 @@ void LUXSimGeneratorPb210::GenerateEventList( G4ThreeVector position,
                 G4int sourceByVolumeID, G4int sourcesID, G4double time)
 {
     G4int a=-1; G4int z=-1; G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );    
 }
 
@@ -67,18 +69,18 @@ void LUXSimGeneratorPb210::GenerateFromEventList( G4GeneralParticleSource
     probability = G4UniformRand();
     
     if( probability < 1./3. ) {
-        UI->ApplyCommand( "/gps/ion 82 210 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 210 210 82 82" );
+        SetIon( particleGun, 82, 210 );
+        SetNucleusLimits( 210, 82 );
     } else if( probability < 2./3. ) {
-        UI->ApplyCommand( "/grdm/nucleusLimits 210 210 83 83" );
-        UI->ApplyCommand( "/gps/ion 83 210 0 0" );
+        SetNucleusLimits( 210, 83 );
+        SetIon( particleGun, 83, 210 );
     } else {
         if( G4UniformRand() < .9999987) {
-            UI->ApplyCommand( "/grdm/nucleusLimits 210 210 84 84" );
-            UI->ApplyCommand( "/gps/ion 84 210 0 0" );
+            SetNucleusLimits( 210, 84 );
+            SetIon( particleGun, 84, 210 );
         } else {
-            UI->ApplyCommand( "/grdm/nucleusLimits 206 206 81 81" );
-            UI->ApplyCommand( "/gps/ion 81 206 0 0" );
+            SetNucleusLimits( 206, 81 );
+            SetIon( particleGun, 81, 206 );
         }
     }
 
@@ -6,6 +6,8 @@
 ********************************************************************************
 * Change log
 *   2013-02-16 DCM - Original version (adapted from U238 generator)
+*   2026-10-17 - The primary ion and nucleus limits are set directly rather
+*                than with UI commands
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,8 +45,8 @@ void LUXSimGeneratorRa226::GenerateEventList( G4ThreeVector position,
                 G4int sourceByVolumeID, G4int sourcesID, G4double time)
 {
     G4int a=-1; G4int z=-1; G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );    
 }
 
@@ -67,27 +69,27 @@ void LUXSimGeneratorRa226::GenerateFromEventList( G4GeneralParticleSource
     probability = G4UniformRand();
     
     if( probability < 1./activityMultiplier ) {
-        UI->ApplyCommand( "/gps/ion 88 226 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 226 226 88 88" );
+        SetIon( particleGun, 88, 226 );
+        SetNucleusLimits( 226, 88 );
     } else if( probability < 2./activityMultiplier ) {
-        UI->ApplyCommand( "/gps/ion 86 222 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 222 222 86 86" );
+        SetIon( particleGun, 86, 222 );
+        SetNucleusLimits( 222, 86 );
     } else if( probability < 3./activityMultiplier ) {
-        UI->ApplyCommand( "/gps/ion 84 218 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 218 218 84 84" );
+        SetIon( particleGun, 84, 218 );
+        SetNucleusLimits( 218, 84 );
     } else if( probability < 4./activityMultiplier ) {
-        UI->ApplyCommand( "/gps/ion 82 214 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 214 214 82 82" );
+        SetIon( particleGun, 82, 214 );
+        SetNucleusLimits( 214, 82 );
     } else if( probability < 5./activityMultiplier ) {
-        UI->ApplyCommand( "/gps/ion 83 214 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 214 214 83 83" );
+        SetIon( particleGun, 83, 214 );
+        SetNucleusLimits( 214, 83 );
     } else {
         if( G4UniformRand() < .99979) {
-            UI->ApplyCommand( "/grdm/nucleusLimits 214 214 84 84" );
-            UI->ApplyCommand( "/gps/ion 84 214 0 0" );
+            SetNucleusLimits( 214, 84 );
+            SetIon( particleGun, 84, 214 );
         } else {
-            UI->ApplyCommand( "/grdm/nucleusLimits 210 210 81 81" );
-            UI->ApplyCommand( "/gps/ion 81 210 0 0" );
+            SetNucleusLimits( 210, 81 );
+            SetIon( particleGun, 81, 210 );
         }
     }
 
@@ -6,6 +6,8 @@
 ********************************************************************************
 * Change log
 *	16-February-2015 - file creation (Simon), copying from Rn222 generator
+*	17-October-2026 - The primary ion and nucleus limits are set directly
+*					  rather than with UI commands
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,8 +51,8 @@ void LUXSimGeneratorRn220::GenerateEventList( G4ThreeVector position,
 {
     G4int a=-1; G4int z=-1;
     G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );    
 }
 
@@ -74,34 +76,34 @@ void LUXSimGeneratorRn220::GenerateFromEventList( G4GeneralParticleSource
 
   	//radon220
   	if( probability < 1./5. ) {
-  		UI->ApplyCommand( "/gps/ion 86 220 0 0" );
-  		UI->ApplyCommand( "/grdm/nucleusLimits 220 220 86 86" );
+  		SetIon( particleGun, 86, 220 );
+  		SetNucleusLimits( 220, 86 );
   	}
   	//polonium216
   	else if( probability < 2./5. ) {
-  		UI->ApplyCommand( "/gps/ion 84 216 0 0" );
-  		UI->ApplyCommand( "/grdm/nucleusLimits 216 216 84 84" );
+  		SetIon( particleGun, 84, 216 );
+  		SetNucleusLimits( 216, 84 );
   	}
   	//lead212
   	else if( probability < 3./5. ) {
-  		UI->ApplyCommand( "/gps/ion 82 212 0 0" );
-  		UI->ApplyCommand( "/grdm/nucleusLimits 212 212 82 82" );
+  		SetIon( particleGun, 82, 212 );
+  		SetNucleusLimits( 212, 82 );
   	} 
   	//bismuth212
   	else if( probability < 4./5. ) {
-  		UI->ApplyCommand( "/gps/ion 83 212 0 0" );
-  		UI->ApplyCommand( "/grdm/nucleusLimits 212 212 83 83" );
+  		SetIon( particleGun, 83, 212 );
+  		SetNucleusLimits( 212, 83 );
   	} 		
   	else {
   	//thalium208
         	if( G4UniformRand() < 0.3594 ) {
-           	 UI->ApplyCommand( "/gps/ion 81 208 0 0" );
-           	 UI->ApplyCommand( "/grdm/nucleusLimits 208 208 81 81" );
+           	 SetIon( particleGun, 81, 208 );
+           	 SetNucleusLimits( 208, 81 );
             	 } 
   	//polonium212
 		else {
-           	 UI->ApplyCommand( "/gps/ion 84 212 0 0" );
-           	 UI->ApplyCommand( "/grdm/nucleusLimits 212 212 84 84" );
+           	 SetIon( particleGun, 84, 212 );
+           	 SetNucleusLimits( 212, 84 );
             	}
 	}
 
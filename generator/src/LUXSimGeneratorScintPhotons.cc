@@ -44,8 +44,8 @@ void LUXSimGeneratorScintPhotons::GenerateEventList( G4ThreeVector position,
                 G4int sourceByVolumeID, G4int sourcesID, G4double time)
 {
     G4int z=1; G4int a=1; G4double hl=1;
-  	Isotope *currentIso = new Isotope(name, z, a, hl);//
-  	luxManager->RecordTreeInsert( currentIso, time, position, 
+  	Isotope currentIso(name, z, a, hl);//
+  	luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );
 }
 
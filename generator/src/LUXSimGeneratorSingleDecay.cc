@@ -11,6 +11,8 @@
 *				stdout for every event (Kareem)
 *   30-Apr-2010 - Added primaryParticle recording (Nick)
 *   14-Jul-2012 - GenerateEventList methods of binary search tree (Nick)
+*   17-Oct-2026 - The primary ion and nucleus limits are set directly rather
+*                 than with UI commands (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,8 +60,8 @@ void LUXSimGeneratorSingleDecay::GenerateEventList( G4ThreeVector position,
 
     //name, z, e, particlename, energy
     G4double halflife=0;
-  	Isotope *currentIso = new Isotope(name, z, a, halflife);
-  	luxManager->RecordTreeInsert( currentIso, time, position, 
+  	Isotope currentIso(name, z, a, halflife);
+  	luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );
 		
 	
@@ -89,18 +91,8 @@ void LUXSimGeneratorSingleDecay::GenerateFromEventList( G4GeneralParticleSource
     //    isoproperty->GetLifeTime();
     //G4double G4RIsotopeTable::GetMeanLifeTime(G4int Z, G4int A, G4double& aE)
    
-    std::stringstream uiStream ;
-    uiStream.str("") ;
-    uiStream << "/gps/ion " << nucleusZ << " " << nucleusA << " 0 0" ;
-    uiString = uiStream.str() ;
-	UI->ApplyCommand( uiString );
-    
-    uiStream.clear() ;  //removes error cache
-    uiStream.str("") ;
-    uiStream << "/grdm/nucleusLimits " << nucleusA << " " << nucleusA << " " << 
-        nucleusZ << " " << nucleusZ ;
-    uiString = uiStream.str() ;
-	UI->ApplyCommand( uiString ) ;
+    SetIon( particleGun, nucleusZ, nucleusA );
+    SetNucleusLimits( nucleusA, nucleusZ );
     
 	particleGun->GetCurrentSource()->GetAngDist()->SetParticleMomentumDirection(
 			GetRandomDirection() );
@@ -53,8 +53,8 @@ void LUXSimGeneratorSingleParticle::GenerateEventList( G4ThreeVector position,
 {
 
     G4int z=-1; G4int a=-1;
-  	Isotope *currentIso = new Isotope(name, z, a, pname, energy);
-  	luxManager->RecordTreeInsert( currentIso, time, position, 
+  	Isotope currentIso(name, z, a, pname, energy);
+  	luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );	
 }
 
@@ -9,6 +9,8 @@
 *    27-May-2009 - This generator now works (Kareem)
 *   30-Apr-2010 - Added primaryParticle recording (Nick)
 *   14-Jul-2012 - GenerateEventList methods of binary search tree (Nick)
+*   17-Oct-2026 - The primary ion and nucleus limits are set directly rather
+*                 than with UI commands (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,8 +54,8 @@ void LUXSimGeneratorTh232::GenerateEventList( G4ThreeVector position,
 {
     G4int a=-1; G4int z=-1;
     G4double hl=-1;
-    Isotope *currentIso = new Isotope(name, z, a, hl);
-    luxManager->RecordTreeInsert( currentIso, time, position, 
+    Isotope currentIso(name, z, a, hl);
+    luxManager->RecordTreeInsert( &currentIso, time, position, 
                   sourceByVolumeID, sourcesID );    
 }
 
@@ -77,39 +79,39 @@ void LUXSimGeneratorTh232::GenerateFromEventList( G4GeneralParticleSource
 
       
     if( probability < 1./10. ) {
-        UI->ApplyCommand( "/gps/ion 90 232 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 232 232 90 90" );
+        SetIon( particleGun, 90, 232 );
+        SetNucleusLimits( 232, 90 );
     } else if( probability < 2./10. ) {
-        UI->ApplyCommand( "/gps/ion 88 228 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 228 228 88 88" );
+        SetIon( particleGun, 88, 228 );
+        SetNucleusLimits( 228, 88 );
     } else if( probability < 3./10. ) {
-        UI->ApplyCommand( "/gps/ion 89 228 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 228 228 89 89" );
+        SetIon( particleGun, 89, 228 );
+        SetNucleusLimits( 228, 89 );
     } else if( probability < 4./10. ) {
-        UI->ApplyCommand( "/gps/ion 90 228 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 228 228 90 90" );
+        SetIon( particleGun, 90, 228 );
+        SetNucleusLimits( 228, 90 );
     } else if( probability < 5./10. ) {
-        UI->ApplyCommand( "/gps/ion 88 224 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 224 224 88 88" );
+        SetIon( particleGun, 88, 224 );
+        SetNucleusLimits( 224, 88 );
     } else if( probability < 6./10. ) {
-        UI->ApplyCommand( "/gps/ion 86 220 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 220 220 86 86" );
+        SetIon( particleGun, 86, 220 );
+        SetNucleusLimits( 220, 86 );
     } else if( probability < 7./10. ) {
-        UI->ApplyCommand( "/gps/ion 84 216 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 216 216 84 84" );
+        SetIon( particleGun, 84, 216 );
+        SetNucleusLimits( 216, 84 );
     } else if( probability < 8./10. ) {
-        UI->ApplyCommand( "/gps/ion 82 212 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 212 212 82 82" );
+        SetIon( particleGun, 82, 212 );
+        SetNucleusLimits( 212, 82 );
     } else if( probability < 9./10. ) {
-        UI->ApplyCommand( "/gps/ion 83 212 0 0" );
-        UI->ApplyCommand( "/grdm/nucleusLimits 212 212 83 83" );
+        SetIon( particleGun, 83, 212 );
+        SetNucleusLimits( 212, 83 );
     } else {
         if( G4UniformRand() < 0.3594 ) {
-            UI->ApplyCommand( "/grdm/nucleusLimits 208 208 81 81" );
-            UI->ApplyCommand( "/gps/ion 81 208 0 0" );
+            SetNucleusLimits( 208, 81 );
+            SetIon( particleGun, 81, 208 );
         } else {
-            UI->ApplyCommand( "/grdm/nucleusLimits 212 212 84 84" );
-            UI->ApplyCommand( "/gps/ion 84 212 0 0" );
+            SetNucleusLimits( 212, 84 );
+            SetIon( particleGun, 84, 212 );
         }
     }
 
@@ -9,6 +9,11 @@
 *   14-Jul-2012 - Modified to account for earth and galactic
 * 				    escape velocities (Daniel)
 *   14-Jul-2012 - GenerateEventList methods of binary search tree (Nick)
+*   17-Oct-2026 - The recoil spectrum of each WIMP mass and isotope is worked
+*                 out once, when the mass is first seen in GenerateEventList,
+*                 and sampled by a binary search of its cumulative distribution
+*                 (agent)
+*   17-Oct-2026 - The ion is set directly rather than with /gps/ion (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +33,26 @@
 //  Other Includes
 //
 #include <sstream>
+#include <algorithm>
+
+//
+//  Definitions
+//
+//  Bins the recoil spectrum is integrated in
+#define NUM_RECOIL_BINS 5000
+
+//  The xenon isotopes: A, natural abundance (%) and mass (GeV)
+static const G4double XeData[9][3] = {
+    {132, 26.9086, 122.8679},
+    {129, 26.4006, 120.074},
+    {131, 21.2324, 121.9373},
+    {134, 10.4357, 124.7321},
+    {136, 8.857, 126.5968},
+    {130, 4.071, 121.0043},
+    {128, 1.9102, 119.1414},
+    {124, .0953, 115.4176},
+    {126, .0892, 117.2791},
+};
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimGeneratorWimp()
@@ -175,6 +200,57 @@ G4double LUXSimGeneratorWimp::dR(G4double ER, G4double mWimp, G4double mXenon){
   return dR;
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					BuildRecoilSpectra()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimGeneratorWimp::BuildRecoilSpectra( G4double wimpMass )
+{
+  //None of this depends on the event, so it is only done the first time a
+  //WIMP mass (in GeV) is seen, for all the isotopes at once
+  if( recoilSpectra.find( wimpMass ) != recoilSpectra.end() ) return;
+
+  std::vector<recoilSpectrum> &spectra = recoilSpectra[wimpMass];
+  spectra.resize( 9 );
+  G4double Rdist [NUM_RECOIL_BINS];
+  for(G4int isotope = 0; isotope < 9; isotope++){
+  	//Find the zero point.
+  	G4double zeroPoint = 1;
+  	G4double lowerBound = 0;
+  	while(dR(zeroPoint,wimpMass,XeData[isotope][2]) > 0) zeroPoint *= 2;
+  	for(G4int i = 0; (zeroPoint - lowerBound)/zeroPoint > 1e-13; i++){
+  		if(dR((zeroPoint+lowerBound)/2,wimpMass,XeData[isotope][2]) > 0){
+  			lowerBound = (zeroPoint+lowerBound)/2;
+  		}
+  		else{
+  			zeroPoint = (zeroPoint+lowerBound)/2;
+  		}
+  	}
+  	zeroPoint = (zeroPoint+lowerBound)/2;
+
+  	//Integrate dR to get the probability distribution
+  	Rdist[NUM_RECOIL_BINS-1] = 0;
+  	for(G4int i = NUM_RECOIL_BINS-2; i >= 0; i--){ //integration: trapezoids
+    		Rdist[i] = dR(i*zeroPoint/4999.,wimpMass,XeData[isotope][2]);
+    		Rdist[i] += dR((i+1)*zeroPoint/4999.,wimpMass,XeData[isotope][2]);
+    		Rdist[i] /=2;
+    		Rdist[i] *= (zeroPoint/4999.); //width
+    		Rdist[i] += Rdist[i+1]; //last bin evaluated
+  	}
+
+  	//Normalize the distribution, and keep it as a cumulative one so that
+  	//the bin can be found by a binary search
+  	G4double sum = 0;
+  	for(G4int i = 0; i < NUM_RECOIL_BINS; i++) sum += Rdist[i];
+  	spectra[isotope].endPoint = zeroPoint;
+  	spectra[isotope].cdf.resize( NUM_RECOIL_BINS );
+  	G4double running = 0;
+  	for(G4int i = 0; i < NUM_RECOIL_BINS; i++){
+  		running += Rdist[i];
+  		spectra[isotope].cdf[i] = running/sum;
+  	}
+  }
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					GenerateEventList()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -182,10 +258,14 @@ void LUXSimGeneratorWimp::GenerateEventList( G4ThreeVector position,
             G4int sourceByVolumeID, G4int sourcesID, G4double wimpMass,
             G4double time)
 {
+    //  The spectra of a new mass are worked out here, before the run, rather
+    //  than when its first event is generated
+    BuildRecoilSpectra( wimpMass/GeV );
+
     G4int a=-1; G4int z=-1;
     G4String pname="Wimp";
-  	Isotope *currentIso = new Isotope(name, z, a, pname, wimpMass);
-    luxManager->RecordTreeInsert(currentIso,time, position,sourceByVolumeID,sourcesID);
+  	Isotope currentIso(name, z, a, pname, wimpMass);
+    luxManager->RecordTreeInsert(&currentIso,time, position,sourceByVolumeID,sourcesID);
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -194,23 +274,9 @@ void LUXSimGeneratorWimp::GenerateEventList( G4ThreeVector position,
 void LUXSimGeneratorWimp::GenerateFromEventList( G4GeneralParticleSource 
             *particleGun, G4Event *event, decayNode *firstNode )
 {
-    std::stringstream command (std::stringstream::in | std::stringstream::out);
-  
     G4ThreeVector pos = G4ThreeVector(firstNode->pos);
     G4double timeDelay = (firstNode->timeOfEvent)/ns;
 
-    G4double XeData[9][3] = {
-    {132, 26.9086, 122.8679},
-    {129, 26.4006, 120.074},
-    {131, 21.2324, 121.9373},
-    {134, 10.4357, 124.7321},
-    {136, 8.857, 126.5968},
-    {130, 4.071, 121.0043},
-    {128, 1.9102, 119.1414},
-    {124, .0953, 115.4176},
-    {126, .0892, 117.2791},
-    };
-
     particleGun->GetCurrentSource()->SetParticleDefinition( ion );
     particleGun->GetCurrentSource()->GetAngDist()->SetParticleMomentumDirection(
 		        GetRandomDirection() );
@@ -223,61 +289,26 @@ void LUXSimGeneratorWimp::GenerateFromEventList( G4GeneralParticleSource
   		i -= XeData[isotope][1];
   	}
 
-  	//Set the energy
+    //Set the energy from the recoil spectrum of this mass and isotope
     G4double wimpMass = (firstNode->energy)/GeV;//saved as kev
-  	//Set the energy (a many step process)
-  	//Find the zero point.
-  	G4double zeroPoint = 1;
-  	G4double lowerBound = 0;
-  	while(dR(zeroPoint,wimpMass,XeData[isotope][2]) > 0) zeroPoint *= 2;
-  	for(G4int i = 0; (zeroPoint - lowerBound)/zeroPoint > 1e-13; i++){
-  		if(dR((zeroPoint+lowerBound)/2,wimpMass,XeData[isotope][2]) > 0){
-  			lowerBound = (zeroPoint+lowerBound)/2;
-  		}
-  		else{
-  			zeroPoint = (zeroPoint+lowerBound)/2;
-  		}
-  	}
-  	zeroPoint = (zeroPoint+lowerBound)/2;
-
-  	//Integrate dR to get the probability distribution
-  	G4double Rdist [5000];
-  	Rdist[4999] = 0;
-  	for(G4int i = 4998; i >= 0; i--){ //integration: trapezoids
-    		Rdist[i] = dR(i*zeroPoint/4999.,wimpMass,XeData[isotope][2]);
-    		Rdist[i] += dR((i+1)*zeroPoint/4999.,wimpMass,XeData[isotope][2]);
-    		Rdist[i] /=2;
-    		Rdist[i] *= (zeroPoint/4999.); //width
-    		Rdist[i] += Rdist[i+1]; //last bin evaluated
-  	}
-
-  	//Normalize the distribution
-  	G4double sum = 0;
-  	for(G4int i = 0; i < 5000; i++) sum += Rdist[i];
-  	for(G4int i = 0; i < 5000; i++) Rdist[i] /= sum;
+    BuildRecoilSpectra( wimpMass );
+    const recoilSpectrum &spectrum = recoilSpectra[wimpMass][isotope];
 
   	//Find the bin to get the energy from
   	G4double prob = G4UniformRand(); //the value to search the distribution with
-  	G4int bin = 0;
-  	while(bin < 5000){
-  		prob -= Rdist[bin];
-  		if(prob <= 0) break;
-  		bin++;
-  	}
+  	G4int bin = std::lower_bound( spectrum.cdf.begin(), spectrum.cdf.end(),
+            prob ) - spectrum.cdf.begin();
 
   	//Select an energy from the bin
   	prob = G4UniformRand();
-  	G4double recoilEnergy = zeroPoint*((bin+prob)/4999.);
+  	G4double recoilEnergy = spectrum.endPoint*((bin+prob)/4999.);
 
   	//Finally, set the energy
   	particleGun->GetCurrentSource()->GetEneDist()->SetMonoEnergy( 
                   recoilEnergy*keV );
 
   	//Set the ion
-    command << "/gps/ion 54 " << XeData[isotope][0] << " 0 0" << std::endl;
-  	
-  	//Input the command string
-  	UI->ApplyCommand(command.str());
+    SetIon( particleGun, 54, (G4int)XeData[isotope][0] );
 
   	particleGun->GeneratePrimaryVertex( event );
     luxManager->AddPrimaryParticle( GetParticleInfo(particleGun) );
@@ -11,6 +11,9 @@
 *	28-Apr-09 - Added check to see if any sources have been explicitly set, and
 *				if not, just generate the primary vertex (Kareem)
 *	18-May-13 - Added emission time for primaries (Chao)
+*	17-Oct-26 - Reseed the randomization engine for each event if per-event
+*				seeds are turned on (agent)
+*	17-Oct-26 - The per-event seed counts from randomFirstEvent (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -50,6 +53,12 @@ LUXSimPrimaryGeneratorAction::~LUXSimPrimaryGeneratorAction()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimPrimaryGeneratorAction::GeneratePrimaries( G4Event *event )
 {
+	//	This is the first thing that happens in an event, so it's where the
+	//	per-event seed has to be set
+	if( luxManager->GetPerEventSeeds() )
+		luxManager->SeedEvent( luxManager->GetRandomFirstEvent() +
+				event->GetEventID() );
+	
 	//	Have the management class determine which event is next and generate
 	//	that event
 	if( luxManager->GetTotalSimulationActivity() )
@@ -19,13 +19,28 @@
 *                 All sources are added to the binary search tree (Nick)
 *   18-May-2013 - Added emission time for primaries (Chao)
 *   18-Dec-2015 -Overloaded a GenerateEventList for muon generator (David W) (merged into git by Doug T)
+*   17-Oct-2026 - Added GetIon, SetIon and SetNucleusLimits, which do what the
+*                 /gps/ion and /grdm/nucleusLimits commands do without going
+*                 through the UI (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+//	C/C++ includes
+//
+#include <map>
+#include <sstream>
+
 //
 //	GEANT4 includes
 //
 #include "globals.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4GenericIon.hh"
+#include "G4ProcessTable.hh"
+#include "G4RadioactiveDecay.hh"
+#include "G4NucleusLimits.hh"
 
 //
 //	LUXSim includes
@@ -33,6 +48,18 @@
 #include "LUXSimSource.hh"
 #include "LUXSimDetectorComponent.hh"
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//	Ion lookup
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//	Ions already looked up, by Z*1000+A and excitation energy. The ion table
+//	owns the definitions, so all the sources share these.
+typedef std::pair<G4int, G4double> ionKey;
+static std::map<ionKey, G4ParticleDefinition*> ionCache;
+
+//	The radioactive decay process of the generic ion, once found
+static G4RadioactiveDecay *radioactiveDecay = 0;
+static G4bool lookedForRadioactiveDecay = false;
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimSource()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -139,3 +166,67 @@ G4ThreeVector LUXSimSource::GetRandomDirection()
 
 	return direction;
 }
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetIon()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4ParticleDefinition *LUXSimSource::GetIon( G4int Z, G4int A,
+		G4double excitationEnergy )
+{
+	ionKey key( Z*1000 + A, excitationEnergy );
+	std::map<ionKey, G4ParticleDefinition*>::iterator found =
+			ionCache.find( key );
+	if( found != ionCache.end() )
+		return found->second;
+
+	G4ParticleDefinition *theIon = G4ParticleTable::GetParticleTable()->
+			GetIonTable()->GetIon( Z, A, excitationEnergy );
+	if( !theIon ) {
+		G4cout << "Ion with Z=" << Z << " A=" << A << " E*="
+			   << excitationEnergy/keV << " keV is not defined" << G4endl;
+		return 0;
+	}
+
+	ionCache[key] = theIon;
+	return theIon;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetIon()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimSource::SetIon( G4GeneralParticleSource *particleGun, G4int Z,
+		G4int A, G4double excitationEnergy, G4int charge )
+{
+	//	Same as "/gps/ion Z A charge excitationEnergy/keV"
+	G4ParticleDefinition *theIon = GetIon( Z, A, excitationEnergy );
+	if( !theIon )
+		return;
+
+	particleGun->GetCurrentSource()->SetParticleDefinition( theIon );
+	particleGun->GetCurrentSource()->SetParticleCharge( charge*eplus );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetNucleusLimits()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimSource::SetNucleusLimits( G4int A, G4int Z )
+{
+	//	Same as "/grdm/nucleusLimits A A Z Z". If the generic ion has no
+	//	radioactive decay process to set the limits on directly, the command is
+	//	used after all.
+	if( !lookedForRadioactiveDecay ) {
+		radioactiveDecay = dynamic_cast<G4RadioactiveDecay*>(
+				G4ProcessTable::GetProcessTable()->FindProcess(
+				"RadioactiveDecay", G4GenericIon::Definition() ) );
+		lookedForRadioactiveDecay = true;
+	}
+
+	if( radioactiveDecay ) {
+		radioactiveDecay->SetNucleusLimits( G4NucleusLimits( A, A, Z, Z ) );
+		return;
+	}
+
+	std::stringstream command;
+	command << "/grdm/nucleusLimits " << A << " " << A << " " << Z << " " << Z;
+	UI->ApplyCommand( command.str() );
+}
@@ -39,6 +39,17 @@
 *   14-Oct-14 - Added Set methods for the mass and volume (Kareem)
 *   28-Aug-15 - Changed the source stucture and AddSource method to accomodate
 *                           point sources (David W)
+*   17-Oct-26 - Added the flag marking the component as part of the active
+*               liquid xenon target (agent)
+*   17-Oct-26 - The event record is passed in and handed out by reference, and
+*               keeps its capacity from one event to the next (agent)
+*   17-Oct-26 - Added the acceptance voxel grid used by GetEventLocation (agent)
+*   17-Oct-26 - Added CalculateSolidVolume and GetSolidHash for the threaded,
+*               cached volume calculation (agent)
+*   17-Oct-26 - Sources record which GenerateEventList they use, and event
+*               positions can be drawn in bulk (agent)
+*   17-Oct-26 - Added StartEventStreams and GenerateStreamEvent for the
+*               streamed event list (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -54,6 +65,7 @@
 //	GEANT4 includes
 //
 #include "G4PVPlacement.hh"
+#include "geomdefs.hh"
 #include "globals.hh"
 
 //
@@ -75,8 +87,19 @@ class LUXSimSource;
 class LUXSimDetectorComponent : public G4PVPlacement
 {
 	public:
+		//	Which of the sources' GenerateEventList methods a source uses
+		enum sourceKind {
+			kDefaultSource,
+			kDecayChainSource,
+			kSingleDecaySource,
+			kSingleParticleSource,
+			kWimpSource,
+			kMUSUNSource
+		};
+		
 		struct source {
 			LUXSimSource *type;
+			sourceKind kind;
 			G4double activity;
 			G4double ratio;
             G4int mass; //single decay
@@ -141,10 +164,14 @@ class LUXSimDetectorComponent : public G4PVPlacement
 		inline void SetRecordLevelThermElec( G4int level )
 				{ recordLevelThermElec = level; };
 		
-		void AddDeposition( LUXSimManager::stepRecord aStepRecord )
+		//	The event record is reused for every event: ClearRecord() only
+		//	resets its size, so once the buffer has grown to fit the largest
+		//	event so far, recording steps doesn't allocate anything.
+		void AddDeposition( const LUXSimManager::stepRecord &aStepRecord )
 				{ eventRecord.push_back(aStepRecord);};
 		void ClearRecord() { eventRecord.clear(); };
-		std::vector<LUXSimManager::stepRecord> GetEventRecord()
+		void ReserveRecord( G4int size ) { eventRecord.reserve( size ); };
+		const std::vector<LUXSimManager::stepRecord> &GetEventRecord()
 				{ return eventRecord; };
 		
 		void SetID( G4int ID ) { compID = ID; };
@@ -159,7 +186,10 @@ class LUXSimDetectorComponent : public G4PVPlacement
 		void GenerateFromEventList( G4GeneralParticleSource*, G4Event*,
                 decayNode* );
         void GenerateEventList(G4int);
+        void StartEventStreams(G4int);
+        void GenerateStreamEvent( G4int, G4int, G4double );
 		void DetermineCenterAndExtent( G4PVPlacement* );
+		void BuildAcceptanceGrid( G4double numSamples );
 		G4ThreeVector GetGlobalCenter() { return globalCenter; };
         G4ThreeVector GetMinXYZ() { return minXYZ; };
         G4ThreeVector GetMaxXYZ() { return maxXYZ; };
@@ -174,8 +204,21 @@ class LUXSimDetectorComponent : public G4PVPlacement
 		
 		G4bool GetCapturePhotons() { return capturePhotons; };
 		
+		G4bool GetLiquidXenonTarget() { return liquidXenonTarget; };
+		void SetLiquidXenonTarget( G4bool val ) { liquidXenonTarget = val; };
+		
 	private:
 		G4ThreeVector GetEventLocation();
+		void GetEventLocations( G4int num,
+				std::vector<G4ThreeVector> &positions );
+		G4ThreeVector GetVoxelPoint( G4int index, const G4double *u );
+		void GenerateDecayChainEventList( G4int sourceByVolumeID, G4int i );
+		void InsertEvent( G4int sourceByVolumeID, G4int i,
+				G4ThreeVector position, G4double time );
+		EInside ClassifyVoxel( G4ThreeVector center, G4double halfDiagonal );
+		G4String GetAcceptanceGridGeometry();
+		G4double CalculateSolidVolume();
+		G4String GetSolidHash();
 
 	private:
 
@@ -196,12 +239,26 @@ class LUXSimDetectorComponent : public G4PVPlacement
 		G4RotationMatrix globalOrientation;
 		G4double xPos, yPos, zPos;
 		G4double prob;
+		
+		//	The acceptance grid divides the bounding box into equal voxels and
+		//	lists the ones that are at least partly inside this component.
+		//	Voxels that may also hold points outside it (in the mother, or in
+		//	a daughter) are flagged as mixed.
+		G4bool acceptanceGridBuilt;
+		G4String acceptanceGridGeometry;
+		G4double acceptanceGridTarget;
+		G4ThreeVector voxelOrigin;
+		G4ThreeVector voxelSize;
+		G4int numVoxels[3];
+		std::vector<G4int> acceptanceVoxels;
+		std::vector<G4bool> acceptanceVoxelMixed;
     
         G4double volume;
         G4double mass;
         G4int volumePrecision;
 
 		G4bool capturePhotons;
+		G4bool liquidXenonTarget;
 		
 		LUXSimManager *luxManager;		
 		G4Navigator *navigator;
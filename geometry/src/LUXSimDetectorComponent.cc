@@ -65,14 +65,54 @@
 *   28-Aug-15 - Edited AddSource method and EventPosition calculation to 
 *               accommodate point sources (David W)
 *   18-Dec-2015 - Muon generator Code (David W) (merged into git by Doug T)
+*   17-Oct-2026 - The component ID starts out at 0 until BeamOn assigns it
+*                 (agent)
+*   17-Oct-2026 - Components start out flagged as outside the liquid xenon
+*                 target (agent)
+*   17-Oct-2026 - The event list is generated for the manager's event list
+*                 size, which covers the events before randomFirstEvent (agent)
+*   17-Oct-2026 - GetEventLocation samples from a voxel grid of the parts of
+*                 the bounding box that are inside the component, built by
+*                 BuildAcceptanceGrid as fine as the run needs and kept while
+*                 the geometry stays the same, and only asks the navigator
+*                 about voxels that straddle a boundary (agent)
+*   17-Oct-2026 - CalculateVolume samples on several threads, each chunk of
+*                 samples with its own random number stream, and caches the
+*                 result by solid and precision in memory and in the volume
+*                 cache file (agent)
+*   17-Oct-2026 - The volume is calculated on at most the number of threads
+*                 set in the manager (one by default) and CPUs the process may
+*                 use, and on one thread for solids whose Inside() isn't
+*                 thread-safe (agent)
+*   17-Oct-2026 - The volume cache file is rewritten through a temporary file
+*                 with one line per entry, instead of being appended to (agent)
+*   17-Oct-2026 - GenerateEventList works in batches: the arrival times are
+*                 drawn together, cut at the event list's cutoff, and the
+*                 positions are drawn in bulk for just the events kept. The
+*                 kind of each source is worked out once, in AddSource. (agent)
+*   17-Oct-2026 - Added StartEventStreams and GenerateStreamEvent, so that
+*                 sources other than decay chains can hand out their events
+*                 one at a time as the run needs them (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+//	C/C++ includes
+//
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
 //
 //	CLHEP includes
 //
 #include "Randomize.hh"
+#include "CLHEP/Random/MTwistEngine.h"
 
 //
 //	GEANT4 includes
@@ -90,6 +130,9 @@
 #include "G4VoxelLimits.hh"
 #include "G4AffineTransform.hh"
 #include "G4Material.hh"
+#include "G4VSolid.hh"
+#include "G4DisplacedSolid.hh"
+#include "G4ReflectedSolid.hh"
 
 //
 //	LUXSim includes
@@ -99,6 +142,175 @@
 #include "LUXSimMaterials.hh"
 #include "LUXSimSource.hh"
 
+//
+//	Definitions
+//
+//	The fewest and most voxels an acceptance grid is divided into. In between,
+//	a grid gets one voxel for each position the run is expected to draw from
+//	it: classifying a voxel costs about what a rejected draw does, so a finer
+//	grid than that would take longer to build than it could ever save.
+#define MIN_ACCEPTANCE_VOXELS 4096
+#define MAX_ACCEPTANCE_VOXELS 1048576
+
+//	The volume samples are split into this many chunks, each with its own
+//	random number stream, so the result doesn't depend on the number of threads
+#define NUM_VOLUME_CHUNKS 64
+
+//	Events made at a time by GenerateEventList
+#define EVENT_LIST_BATCH_SIZE 4096
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//	Volume sampling and caching
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+struct volumeChunk {
+	const G4VSolid *solid;
+	G4double min[3];
+	G4double max[3];
+	G4double targetInsideSamples;
+	long seed;
+	G4double totalSamples;
+	G4double insideSamples;
+};
+
+struct volumeThread {
+	std::vector<volumeChunk> *chunks;
+	G4int firstChunk;
+	G4int chunkStride;
+};
+
+//	Whether G4VSolid::Inside can be called on the solid from several threads at
+//	once. Only the plain CSG solids below are known to keep nothing between
+//	calls; the polycones and polyhedra cache the last phi they were asked about
+//	in their sides, and the twisted and tessellated solids keep state too, so
+//	anything not on the list is taken not to be safe. Boolean, displaced and
+//	reflected solids are only as safe as what they're made of.
+static G4bool IsThreadSafeSolid( G4VSolid *solid )
+{
+	if( !solid )
+		return true;
+	
+	static const char *statelessTypes[] = { "G4Box", "G4Tubs", "G4Cons",
+			"G4Sphere", "G4Orb", "G4Trd", "G4Trap", "G4Para", "G4Torus",
+			"G4Ellipsoid", "G4EllipticalTube" };
+	G4String type = solid->GetEntityType();
+	for( G4int i=0; i<(G4int)(sizeof(statelessTypes)/sizeof(char*)); i++ )
+		if( type == statelessTypes[i] )
+			return true;
+	
+	if( type == "G4UnionSolid" || type == "G4SubtractionSolid" ||
+			type == "G4IntersectionSolid" )
+		return IsThreadSafeSolid( solid->GetConstituentSolid(0) ) &&
+				IsThreadSafeSolid( solid->GetConstituentSolid(1) );
+	if( type == "G4DisplacedSolid" )
+		return IsThreadSafeSolid(
+				((G4DisplacedSolid*)solid)->GetConstituentMovedSolid() );
+	if( type == "G4ReflectedSolid" )
+		return IsThreadSafeSolid(
+				((G4ReflectedSolid*)solid)->GetConstituentMovedSolid() );
+	
+	return false;
+}
+
+//	The number of CPUs this process is allowed to run on, e.g., by the batch
+//	system
+static G4int GetNumAllowedCPUs()
+{
+	cpu_set_t cpus;
+	CPU_ZERO( &cpus );
+	if( !sched_getaffinity( 0, sizeof(cpus), &cpus ) )
+		return CPU_COUNT( &cpus );
+	
+	return (G4int)sysconf( _SC_NPROCESSORS_ONLN );
+}
+
+//	Throws points in the bounding box until each chunk has its inside hits.
+//	This only calls G4VSolid::Inside, so any number of these can run on the
+//	same solid at once if IsThreadSafeSolid says so.
+static void *SampleVolumeChunks( void *arg )
+{
+	volumeThread *theThread = (volumeThread*)arg;
+	std::vector<volumeChunk> &chunks = *(theThread->chunks);
+	for( G4int i=theThread->firstChunk; i<(G4int)chunks.size();
+			i+=theThread->chunkStride ) {
+		volumeChunk &chunk = chunks[i];
+		CLHEP::MTwistEngine engine( chunk.seed );
+		G4double extent[3];
+		for( G4int j=0; j<3; j++ )
+			extent[j] = chunk.max[j] - chunk.min[j];
+		chunk.totalSamples = chunk.insideSamples = 0;
+		while( chunk.insideSamples < chunk.targetInsideSamples ) {
+			chunk.totalSamples++;
+			G4ThreeVector position( extent[0]*engine.flat() + chunk.min[0],
+					extent[1]*engine.flat() + chunk.min[1],
+					extent[2]*engine.flat() + chunk.min[2] );
+			if( chunk.solid->Inside(position) != kOutside )
+				chunk.insideSamples++;
+		}
+	}
+	return NULL;
+}
+
+//	The cached volumes, by solid hash, component name and precision
+static std::map<G4String,G4double> volumeCache;
+static G4String volumeCacheFileRead = "";
+
+static void ReadVolumeCache( G4String fileName )
+{
+	if( fileName == volumeCacheFileRead )
+		return;
+	volumeCacheFileRead = fileName;
+	
+	std::ifstream cacheFile( fileName.c_str() );
+	G4String line;
+	while( cacheFile.good() && getline( cacheFile, line ) ) {
+		//	hash precision volume(mm3) component name
+		std::istringstream entry( line );
+		G4String hash, name;
+		G4int precision;
+		G4double cachedVolume;
+		if( !(entry >> hash >> precision >> cachedVolume) )
+			continue;
+		getline( entry >> std::ws, name );
+		std::ostringstream key;
+		key << hash << " " << precision << " " << name;
+		volumeCache[key.str()] = cachedVolume;
+	}
+}
+
+//	Adds the entries already in the file (perhaps from another job) to the
+//	cache, then writes the whole cache, one line per entry, to a temporary
+//	file that is renamed over the old one. Other jobs reading the file see
+//	either the old one or the new one, never a partial line. Two jobs writing
+//	at once can lose an entry, which only means it gets calculated again.
+static void WriteVolumeCache( G4String fileName )
+{
+	volumeCacheFileRead = "";
+	ReadVolumeCache( fileName );
+	
+	std::ostringstream tempName;
+	tempName << fileName << ".tmp." << getpid();
+	std::ofstream cacheFile( tempName.str().c_str() );
+	cacheFile.precision( 17 );
+	std::map<G4String,G4double>::iterator it;
+	for( it = volumeCache.begin(); it != volumeCache.end(); it++ ) {
+		std::istringstream key( it->first );
+		G4String hash, name;
+		G4int precision;
+		key >> hash >> precision;
+		getline( key >> std::ws, name );
+		cacheFile << hash << " " << precision << " " << it->second << " "
+				  << name << "\n";
+	}
+	cacheFile.close();
+	
+	if( !cacheFile.good() ||
+			rename( tempName.str().c_str(), fileName.c_str() ) ) {
+		G4cout << "Couldn't write the volume cache file " << fileName
+			   << G4endl;
+		remove( tempName.str().c_str() );
+	}
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimDetectorComponent()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -182,6 +394,7 @@ void LUXSimDetectorComponent::Initialize()
 	eventRecord.clear();
 	sources.clear();
 	capturePhotons = false;
+	liquidXenonTarget = false;
 	
 	globalCenter = G4ThreeVector(0,0,0);
     minXYZ = G4ThreeVector(0,0,0);
@@ -194,9 +407,14 @@ void LUXSimDetectorComponent::Initialize()
 	recordLevel = 0;
 	recordLevelOptPhot = 0;
 	recordLevelThermElec = 0;
+	compID = 0;
     
     volume = mass = -1;
     volumePrecision = 100000000;
+    
+    acceptanceGridBuilt = false;
+    acceptanceGridTarget = 0;
+    numVoxels[0] = numVoxels[1] = numVoxels[2] = 0;
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -219,6 +437,20 @@ void LUXSimDetectorComponent::AddSource( LUXSimSource *type, G4double act,
     temp.particleEnergy = parEnergy;
     temp.pointSource = pointSource;
     temp.posSource = posSource;
+    G4String typeName = type->GetName();
+    if( typeName.find("DecayChain") < G4String::npos )
+        temp.kind = kDecayChainSource;
+    else if( typeName.find("SingleDecay") < G4String::npos ||
+            typeName.find("G4Decay") < G4String::npos )
+        temp.kind = kSingleDecaySource;
+    else if( typeName.find("SingleParticle") < G4String::npos )
+        temp.kind = kSingleParticleSource;
+    else if( typeName.find("Wimp") < G4String::npos )
+        temp.kind = kWimpSource;
+    else if( typeName.find("MUSUN") < G4String::npos )
+        temp.kind = kMUSUNSource;
+    else
+        temp.kind = kDefaultSource;
 //	temp.wimpMass = wimpMass;
 	sources.push_back( temp );
 }
@@ -282,17 +514,23 @@ void LUXSimDetectorComponent::GenerateFromEventList( G4GeneralParticleSource
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimDetectorComponent::GenerateEventList(G4int sourceByVolumeID)
 {
-    G4ThreeVector eventPosition;
     // Acitivty units in Bq, time units in seconds
     G4double startParticleTime;
     // Generate numOfEvents for all sources
-    G4int numOfEvents = luxManager->GetNumEvents();
+    G4int numOfEvents = luxManager->GetNumEventListEvents();
     G4double windowEndTime = luxManager->GetWindowEndTime();
     if( windowEndTime > 0 ) windowEndTime*=1.e9*ns;//convert s->ns
 
     //source activity and activity multiplier
     G4double sourceActivity = 0.;
 
+    // Events are made in batches: the arrival times of a whole batch are drawn
+    // at once, the batch is cut where the event list is full and would turn
+    // every later event away, or just after the first event past the window
+    // end, and only then are the positions drawn
+    std::vector<G4double> eventTimes( EVENT_LIST_BATCH_SIZE );
+    std::vector<G4ThreeVector> eventPositions;
+
     for( G4int i=0; i<(G4int)sources.size(); i++ ) {
         sourceActivity = sources[i].activity 
                            * sources[i].type->GetActivityMultiplier();
@@ -305,91 +543,158 @@ void LUXSimDetectorComponent::GenerateEventList(G4int sourceByVolumeID)
         G4cout << "  Progress: " << i+1 << " of " << sources.size() 
                << " in this volume " << G4endl;
 
-        if( sources[i].type->GetName().find("DecayChain") < G4String::npos ) {
-            // Time is determined by DecayChain GenerateEventList method
-            sources[i].type->CalculatePopulationsInEventList( 
-                            sources[i].sourceAge, sources[i].activity, 
-                            sources[i].parentIsotope );
-            // Each DecayChain needs to generate events with the specific
-            // Population just calculated before moving to the next
-            G4cout << "Adding DecayChain to BST" << G4endl;
-            for( G4int j=0; j<numOfEvents; j++ ) {
-	        if( sources[i].pointSource ) eventPosition = sources[i].posSource;
-	        else eventPosition = GetEventLocation();
-                sources[i].type->GenerateEventList( eventPosition, 
-                              sourceByVolumeID, i, sources[i].parentIsotope );
-                if( sources[i].type->GetParentDecayTime() > windowEndTime/s )
-                    j = numOfEvents;
-            }
-        }
-        else if( sources[i].type->GetName().find("SingleDecay")<G4String::npos ||
-		     sources[i].type->GetName().find("G4Decay")<G4String::npos )
-        {
-            for( G4int j=0; j<numOfEvents; j++ ) {
-	        if( sources[i].pointSource ) eventPosition = sources[i].posSource;
-                else eventPosition = GetEventLocation();
-                startParticleTime += ( -log(G4UniformRand())
-                                       / sourceActivity )*s ;
-                if( startParticleTime > windowEndTime ) j = numOfEvents;
-                sources[i].type->GenerateEventList( eventPosition,
-                              sourceByVolumeID, i, sources[i].mass,
-                              sources[i].number, startParticleTime/ns );
-            }
-        }
-        else if(sources[i].type->GetName().find("SingleParticle")<G4String::npos)
-        {
-            for( G4int j=0; j<numOfEvents; j++ ) {
-	        if( sources[i].pointSource ) eventPosition = sources[i].posSource;
-		else eventPosition = GetEventLocation();
-                startParticleTime += ( -log(G4UniformRand())
-                                       / sourceActivity )*s ;
-                if( startParticleTime > windowEndTime ) j = numOfEvents;
-                sources[i].type->GenerateEventList( eventPosition,
-                              sourceByVolumeID, i, sources[i].particleName,
-                              sources[i].particleEnergy, startParticleTime/ns );
-            }
+        if( sources[i].kind == kDecayChainSource ) {
+            GenerateDecayChainEventList( sourceByVolumeID, i );
+            continue;
         }
-        else if(sources[i].type->GetName().find("Wimp")<G4String::npos)
-        {
-            for( G4int j=0; j<numOfEvents; j++ ) {
-                if( sources[i].pointSource ) eventPosition = sources[i].posSource;  
-		else eventPosition = GetEventLocation();
-                startParticleTime += ( -log(G4UniformRand())
-                                       / sourceActivity )*s ;
-                if( startParticleTime > windowEndTime ) j = numOfEvents;
-                sources[i].type->GenerateEventList( eventPosition,
-                              sourceByVolumeID, i, sources[i].particleEnergy,
-                              startParticleTime/ns);
+
+        G4int numGenerated = 0;
+        G4bool pastCutoff = false;
+        while( numGenerated < numOfEvents && !pastCutoff ) {
+            G4int batchSize = numOfEvents - numGenerated;
+            if( batchSize > EVENT_LIST_BATCH_SIZE )
+                batchSize = EVENT_LIST_BATCH_SIZE;
+            numGenerated += batchSize;
+
+            CLHEP::RandExponential::shootArray( batchSize, &eventTimes[0],
+                    1./sourceActivity );
+            G4double cutoff = luxManager->GetEventListCutoff()*ns;
+            G4int numInBatch = 0;
+            while( numInBatch < batchSize ) {
+                startParticleTime += eventTimes[numInBatch]*s;
+                if( startParticleTime > windowEndTime ) {
+                    // The first event past the window still goes to the
+                    // source, as it always has, and is turned away there
+                    eventTimes[numInBatch++] = startParticleTime/ns;
+                    pastCutoff = true;
+                    break;
+                }
+                if( startParticleTime >= cutoff ) {
+                    pastCutoff = true;
+                    break;
+                }
+                eventTimes[numInBatch++] = startParticleTime/ns;
             }
+
+            // MUSUN picks its own positions
+            if( sources[i].kind == kMUSUNSource )
+                eventPositions.assign( numInBatch, G4ThreeVector() );
+            else if( sources[i].pointSource )
+                eventPositions.assign( numInBatch, sources[i].posSource );
+            else
+                GetEventLocations( numInBatch, eventPositions );
+
+            for( G4int j=0; j<numInBatch; j++ )
+                InsertEvent( sourceByVolumeID, i, eventPositions[j],
+                        eventTimes[j] );
         }
-		else if (sources[i].type->GetName().find("MUSUN")<G4String::npos)
-		{
-			for (G4int j = 0; j<numOfEvents; j++) {
-				if (sources[i].pointSource) eventPosition = sources[i].posSource;
-				else eventPosition = GetEventLocation();
-				startParticleTime += (-log(G4UniformRand())
-					/ sourceActivity)*s;
-				if (startParticleTime > windowEndTime) j = numOfEvents;
-				sources[i].type->GenerateEventList(startParticleTime / ns);
-			}
-		}
-        else {
-            for( G4int j=0; j<numOfEvents; j++ ) {
-                if( sources[i].pointSource ) eventPosition = sources[i].posSource;
-		else eventPosition = GetEventLocation();
-                startParticleTime += ( -log(G4UniformRand()) 
-                                      / sourceActivity  )*s ;
-                if( startParticleTime > windowEndTime ) j = numOfEvents;
-                sources[i].type->GenerateEventList( eventPosition,
-                                sourceByVolumeID, i, startParticleTime/ns );
-            }
+        G4cout << "  Time of primary events range from 0.*ns to " 
+               << startParticleTime/ns << "*ns" << G4endl;
+    }
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//				    	GenerateDecayChainEventList()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::GenerateDecayChainEventList(
+        G4int sourceByVolumeID, G4int i )
+{
+    G4int numOfEvents = luxManager->GetNumEventListEvents();
+    G4double windowEndTime = luxManager->GetWindowEndTime();
+    if( windowEndTime > 0 ) windowEndTime*=1.e9*ns;//convert s->ns
+
+    // Time is determined by DecayChain GenerateEventList method
+    sources[i].type->CalculatePopulationsInEventList( 
+                    sources[i].sourceAge, sources[i].activity, 
+                    sources[i].parentIsotope );
+    // Each DecayChain needs to generate events with the specific
+    // Population just calculated before moving to the next
+    G4cout << "Adding DecayChain to BST" << G4endl;
+    G4ThreeVector eventPosition;
+    for( G4int j=0; j<numOfEvents; j++ ) {
+        if( sources[i].pointSource ) eventPosition = sources[i].posSource;
+        else eventPosition = GetEventLocation();
+        sources[i].type->GenerateEventList( eventPosition, 
+                      sourceByVolumeID, i, sources[i].parentIsotope );
+        if( sources[i].type->GetParentDecayTime() > windowEndTime/s )
+            j = numOfEvents;
+    }
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//				    	InsertEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::InsertEvent( G4int sourceByVolumeID, G4int i,
+        G4ThreeVector position, G4double time )
+{
+    //  Hands one event of source i to the source's GenerateEventList, which
+    //  puts it in the event list. Time is in ns, and the position is ignored
+    //  by MUSUN sources.
+    switch( sources[i].kind ) {
+        case kSingleDecaySource:
+            sources[i].type->GenerateEventList( position, sourceByVolumeID, i,
+                    sources[i].mass, sources[i].number, time );
+            break;
+        case kSingleParticleSource:
+            sources[i].type->GenerateEventList( position, sourceByVolumeID, i,
+                    sources[i].particleName, sources[i].particleEnergy, time );
+            break;
+        case kWimpSource:
+            sources[i].type->GenerateEventList( position, sourceByVolumeID, i,
+                    sources[i].particleEnergy, time );
+            break;
+        case kMUSUNSource:
+            sources[i].type->GenerateEventList( time );
+            break;
+        default:
+            sources[i].type->GenerateEventList( position, sourceByVolumeID, i,
+                    time );
+            break;
+    }
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//				    	StartEventStreams()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::StartEventStreams( G4int sourceByVolumeID )
+{
+    //  Used instead of GenerateEventList when the events are streamed. Every
+    //  source but the decay chains becomes a stream in the manager, which asks
+    //  for its events one at a time through GenerateStreamEvent as the run
+    //  gets to them. Decay chains keep the state of the chain in the generator
+    //  from one decay to the next, so their events are still made up front.
+    for( G4int i=0; i<(G4int)sources.size(); i++ ) {
+        G4cout << "Adding source " << sources[i].type->GetName() 
+               << " in "<< ((LUXSimDetectorComponent*)(this))->GetName();
+        if( sources[i].kind == kDecayChainSource ) {
+            G4cout << " to binary search tree (BST)." << G4endl;
+            GenerateDecayChainEventList( sourceByVolumeID, i );
+        } else {
+            G4cout << " as an event stream." << G4endl;
+            luxManager->AddEventStream( sourceByVolumeID, i,
+                    sources[i].activity
+                    * sources[i].type->GetActivityMultiplier() );
         }
-        if( !(sources[i].type->GetName().find("DecayChain") < G4String::npos) ) 
-            G4cout << "  Time of primary events range from 0.*ns to " 
-                   << startParticleTime/ns << "*ns" << G4endl;
     }
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//				    	GenerateStreamEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::GenerateStreamEvent( G4int sourceByVolumeID,
+        G4int sourcesID, G4double time )
+{
+    //  Time in ns
+    G4ThreeVector eventPosition;
+    if( sources[sourcesID].kind != kMUSUNSource ) {
+        if( sources[sourcesID].pointSource )
+            eventPosition = sources[sourcesID].posSource;
+        else
+            eventPosition = GetEventLocation();
+    }
+    InsertEvent( sourceByVolumeID, sourcesID, eventPosition, time );
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					DetermineCenterAndExtent()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -472,6 +777,151 @@ void LUXSimDetectorComponent::DetermineCenterAndExtent( G4PVPlacement *ref )
 	maxZ += 10.*nm;
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetAcceptanceGridGeometry()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4String LUXSimDetectorComponent::GetAcceptanceGridGeometry()
+{
+	//	Everything the acceptance grid depends on: the bounding box and where
+	//	it sits, and the solids and placements of this component and its
+	//	daughters. A grid built for the same description can be reused.
+	std::ostringstream description;
+	description.precision( 17 );
+	description << minX << " " << maxX << " " << minY << " " << maxY << " "
+				<< minZ << " " << maxZ << " " << globalCenter << " "
+				<< globalOrientation << G4endl;
+	GetLogicalVolume()->GetSolid()->StreamInfo( description );
+	for( G4int i=0; i<GetLogicalVolume()->GetNoDaughters(); i++ ) {
+		G4VPhysicalVolume *daughter = GetLogicalVolume()->GetDaughter(i);
+		description << daughter->IsReplicated() << " "
+					<< daughter->GetTranslation() << " ";
+		if( daughter->GetRotation() )
+			description << *(daughter->GetRotation());
+		description << G4endl;
+		daughter->GetLogicalVolume()->GetSolid()->StreamInfo( description );
+	}
+	return G4String( description.str() );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					BuildAcceptanceGrid()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::BuildAcceptanceGrid( G4double numSamples )
+{
+	//	Divide the bounding box from DetermineCenterAndExtent into roughly
+	//	cubic voxels, and keep the ones that aren't entirely outside this
+	//	component. The voxels are classified with the solids' safety distances,
+	//	which never overestimate, so a voxel is only called inside or outside
+	//	when it really is. numSamples is about how many positions the run will
+	//	draw from this component, and sets how fine the grid is.
+	
+	//	Point sources never sample the volume
+	G4bool sampled = false;
+	for( G4int i=0; i<(G4int)sources.size(); i++ )
+		if( !sources[i].pointSource )
+			sampled = true;
+	if( !sampled )
+		return;
+	
+	G4double targetVoxels = numSamples;
+	if( targetVoxels < MIN_ACCEPTANCE_VOXELS )
+		targetVoxels = MIN_ACCEPTANCE_VOXELS;
+	if( targetVoxels > MAX_ACCEPTANCE_VOXELS )
+		targetVoxels = MAX_ACCEPTANCE_VOXELS;
+	
+	//	The grid from an earlier BeamOn is kept if the geometry hasn't changed
+	//	and it's at least as fine as this run needs
+	G4String geometry = GetAcceptanceGridGeometry();
+	if( acceptanceGridBuilt && geometry == acceptanceGridGeometry &&
+			acceptanceGridTarget >= targetVoxels )
+		return;
+	
+	acceptanceVoxels.clear();
+	acceptanceVoxelMixed.clear();
+	acceptanceGridBuilt = true;
+	acceptanceGridGeometry = geometry;
+	acceptanceGridTarget = targetVoxels;
+	
+	G4double extent[3] = { maxX - minX, maxY - minY, maxZ - minZ };
+	G4double side = pow( extent[0]*extent[1]*extent[2] / targetVoxels,
+			1./3. );
+	for( G4int i=0; i<3; i++ ) {
+		numVoxels[i] = 1;
+		if( side > 0 )
+			numVoxels[i] = (G4int)ceil( extent[i]/side );
+		if( numVoxels[i] < 1 )
+			numVoxels[i] = 1;
+		if( numVoxels[i] > 1024 )
+			numVoxels[i] = 1024;
+	}
+	voxelOrigin = G4ThreeVector( minX, minY, minZ );
+	voxelSize = G4ThreeVector( extent[0]/numVoxels[0],
+			extent[1]/numVoxels[1], extent[2]/numVoxels[2] );
+	G4double halfDiagonal = 0.5*voxelSize.mag();
+	
+	G4int numInside = 0;
+	for( G4int i=0; i<numVoxels[0]; i++ )
+		for( G4int j=0; j<numVoxels[1]; j++ )
+			for( G4int k=0; k<numVoxels[2]; k++ ) {
+				G4ThreeVector center = voxelOrigin + G4ThreeVector(
+						(i+0.5)*voxelSize.x(), (j+0.5)*voxelSize.y(),
+						(k+0.5)*voxelSize.z() );
+				EInside in = ClassifyVoxel( center, halfDiagonal );
+				if( in == kOutside )
+					continue;
+				acceptanceVoxels.push_back(
+						(i*numVoxels[1] + j)*numVoxels[2] + k );
+				acceptanceVoxelMixed.push_back( in != kInside );
+				if( in == kInside )
+					numInside++;
+			}
+	
+	G4cout << "Acceptance grid for " << GetName() << ": "
+		   << numVoxels[0] << "x" << numVoxels[1] << "x" << numVoxels[2]
+		   << " voxels, " << numInside << " inside and "
+		   << acceptanceVoxels.size() - numInside << " mixed" << G4endl;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ClassifyVoxel()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+EInside LUXSimDetectorComponent::ClassifyVoxel( G4ThreeVector center,
+		G4double halfDiagonal )
+{
+	//	Returns kInside if every point within halfDiagonal of the center (given
+	//	in this component's frame) is in this component and none of its
+	//	daughters, kOutside if none of them are, and kSurface otherwise.
+	G4VSolid *solid = GetLogicalVolume()->GetSolid();
+	EInside in = solid->Inside( center );
+	if( in == kOutside )
+		return solid->DistanceToIn( center ) >= halfDiagonal ?
+				kOutside : kSurface;
+	if( in != kInside || solid->DistanceToOut( center ) < halfDiagonal )
+		return kSurface;
+	
+	for( G4int i=0; i<GetLogicalVolume()->GetNoDaughters(); i++ ) {
+		G4VPhysicalVolume *daughter = GetLogicalVolume()->GetDaughter(i);
+		if( daughter->IsReplicated() )
+			return kSurface;
+		
+		G4AffineTransform toDaughter( daughter->GetRotation(),
+				daughter->GetTranslation() );
+		toDaughter.Invert();
+		G4ThreeVector daughterPoint = toDaughter.TransformPoint( center );
+		G4VSolid *daughterSolid = daughter->GetLogicalVolume()->GetSolid();
+		in = daughterSolid->Inside( daughterPoint );
+		if( in == kOutside &&
+				daughterSolid->DistanceToIn( daughterPoint ) >= halfDiagonal )
+			continue;
+		if( in == kInside &&
+				daughterSolid->DistanceToOut( daughterPoint ) >= halfDiagonal )
+			return kOutside;
+		return kSurface;
+	}
+	
+	return kInside;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					GetEventLocation()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -482,6 +932,7 @@ G4ThreeVector LUXSimDetectorComponent::GetEventLocation()
 	//	geometry object;
 	G4bool insideVolume = false;
 	G4int counter = 0;
+	G4bool useGrid = acceptanceGridBuilt && acceptanceVoxels.size();
 	while( !insideVolume ) {
 		counter++;
 		if( !(counter%100000) )
@@ -489,17 +940,34 @@ G4ThreeVector LUXSimDetectorComponent::GetEventLocation()
 				   << " attempts to find a point inside the "
 				   << this->GetName() << " volume" << G4endl;
 	
-		//	Find a point at random in the box bounded by the dimensions
-		//	calculated in DetermineCenterAndExtent.
-		xPos = (maxX - minX)*G4UniformRand() + minX;
-		yPos = (maxY - minY)*G4UniformRand() + minY;
-		zPos = (maxZ - minZ)*G4UniformRand() + minZ;
+		G4bool mixedVoxel = true;
+		G4ThreeVector position;
+		if( useGrid ) {
+			//	Every listed voxel is the same size, so picking one uniformly
+			//	and then a point uniformly within it samples the listed voxels
+			//	uniformly. Points in mixed voxels are still checked below.
+			G4double u[4];
+			for( G4int i=0; i<4; i++ )
+				u[i] = G4UniformRand();
+			G4int index = (G4int)( u[0]*acceptanceVoxels.size() );
+			if( index >= (G4int)acceptanceVoxels.size() )
+				index = acceptanceVoxels.size() - 1;
+			mixedVoxel = acceptanceVoxelMixed[index];
+			position = GetVoxelPoint( index, u+1 );
+		} else {
+			//	Find a point at random in the box bounded by the dimensions
+			//	calculated in DetermineCenterAndExtent.
+			xPos = (maxX - minX)*G4UniformRand() + minX;
+			yPos = (maxY - minY)*G4UniformRand() + minY;
+			zPos = (maxZ - minZ)*G4UniformRand() + minZ;
 
-		G4ThreeVector position( xPos, yPos, zPos );
-		position.transform( globalOrientation );
-		position += globalCenter;
+			position = G4ThreeVector( xPos, yPos, zPos );
+			position.transform( globalOrientation );
+			position += globalCenter;
+		}
 		
-		if( navigator->LocateGlobalPointAndSetup( position ) == this ) {
+		if( !mixedVoxel ||
+				navigator->LocateGlobalPointAndSetup( position ) == this ) {
 			insideVolume = true;
 			return position;
 		}
@@ -510,6 +978,58 @@ G4ThreeVector LUXSimDetectorComponent::GetEventLocation()
 	return( G4ThreeVector(0,0,0) );
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetVoxelPoint()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4ThreeVector LUXSimDetectorComponent::GetVoxelPoint( G4int index,
+		const G4double *u )
+{
+	//	The global position of the point at fractions u[0..2] across the
+	//	index'th listed voxel of the acceptance grid
+	G4int voxel = acceptanceVoxels[index];
+	G4int k = voxel % numVoxels[2];
+	G4int j = (voxel / numVoxels[2]) % numVoxels[1];
+	G4int i = voxel / (numVoxels[2]*numVoxels[1]);
+	G4ThreeVector position( voxelOrigin.x() + (i + u[0])*voxelSize.x(),
+			voxelOrigin.y() + (j + u[1])*voxelSize.y(),
+			voxelOrigin.z() + (k + u[2])*voxelSize.z() );
+	position.transform( globalOrientation );
+	position += globalCenter;
+	return position;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetEventLocations()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimDetectorComponent::GetEventLocations( G4int num,
+		std::vector<G4ThreeVector> &positions )
+{
+	//	Same distribution as calling GetEventLocation num times, but with the
+	//	random numbers for the whole batch drawn at once. A point that lands
+	//	outside the component in a mixed voxel is replaced by a fresh draw
+	//	from GetEventLocation, which keeps the distribution uniform.
+	positions.resize( num );
+	if( num <= 0 )
+		return;
+	if( !acceptanceGridBuilt || !acceptanceVoxels.size() ) {
+		for( G4int n=0; n<num; n++ )
+			positions[n] = GetEventLocation();
+		return;
+	}
+	
+	std::vector<G4double> u( 4*num );
+	CLHEP::RandFlat::shootArray( 4*num, &u[0] );
+	for( G4int n=0; n<num; n++ ) {
+		G4int index = (G4int)( u[4*n]*acceptanceVoxels.size() );
+		if( index >= (G4int)acceptanceVoxels.size() )
+			index = acceptanceVoxels.size() - 1;
+		positions[n] = GetVoxelPoint( index, &u[4*n+1] );
+		if( acceptanceVoxelMixed[index] &&
+				navigator->LocateGlobalPointAndSetup( positions[n] ) != this )
+			positions[n] = GetEventLocation();
+	}
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					SetVolumePrecision()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -537,55 +1057,7 @@ G4double LUXSimDetectorComponent::CalculateVolume(
         G4cout << "Calculating the volume of " << GetName() << "... "
                << std::flush;
 
-    //	Next, determine the X, Y, and Z extent of the shape. Augment the
-    //	values by a small buffer to ensure complete coverage of the volume.
-    this->GetLogicalVolume()->GetSolid()->CalculateExtent( kXAxis,
-            G4VoxelLimits(), G4AffineTransform(), minX, maxX );
-    this->GetLogicalVolume()->GetSolid()->CalculateExtent( kYAxis,
-            G4VoxelLimits(), G4AffineTransform(), minY, maxY );
-    this->GetLogicalVolume()->GetSolid()->CalculateExtent( kZAxis,
-            G4VoxelLimits(), G4AffineTransform(), minZ, maxZ );
-    
-    //  This sets the required number of "inside" hits as a function of the
-    //  required precision. The precision is only approximately accurate, but
-    //  it should be in the ballpark.
-    G4int targetInsideSamples = volumePrecision;
-    
-    G4double totalSamples = 0;
-    G4int totalSamplesInt = 0;
-    G4double insideSamples = 0;
-    
-    G4ThreeVector position;
-    EInside in;
-    
-    while( insideSamples < targetInsideSamples ) {
-        totalSamples++;
-        totalSamplesInt++;
-        if( totalSamplesInt == 2000000000 )
-            totalSamplesInt = 0;
-        
-		xPos = (maxX - minX)*G4UniformRand() + minX;
-		yPos = (maxY - minY)*G4UniformRand() + minY;
-		zPos = (maxZ - minZ)*G4UniformRand() + minZ;
-        
-		position = G4ThreeVector( xPos, yPos, zPos );
-        in = GetLogicalVolume()->GetSolid()->Inside(position);
-		
-        if( in != kOutside )
-            insideSamples++;
-        
-        if( !(totalSamplesInt%1000000000) ) {
-            G4cout << "Sampled " << totalSamples << " points in "
-                   << GetName() << "," << G4endl;
-            G4cout << "\t" << insideSamples
-                   << " successful hits, need "
-                   << targetInsideSamples << G4endl;
-        }
-    }
-    
-    G4double outerTestVolume = (maxX-minX) * (maxY-minY) * (maxZ-minZ);
-    
-    volume = outerTestVolume * insideSamples / totalSamples;
+    volume = CalculateSolidVolume();
     
     if( takeOutDaughters ) {
         for( G4int i=0; i<GetLogicalVolume()->GetNoDaughters(); i++ ) {
@@ -606,6 +1078,127 @@ G4double LUXSimDetectorComponent::CalculateVolume(
     return volume;
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetSolidHash()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4String LUXSimDetectorComponent::GetSolidHash()
+{
+	//	A 64-bit FNV-1a hash of the solid's full description, so that any change
+	//	to its shape or dimensions gives a different hash
+	std::ostringstream description;
+	description.precision( 17 );
+	GetLogicalVolume()->GetSolid()->StreamInfo( description );
+	G4String text = description.str();
+	
+	unsigned long long hash = 14695981039346656037ULL;
+	for( G4int i=0; i<(G4int)text.length(); i++ ) {
+		hash ^= (unsigned char)text[i];
+		hash *= 1099511628211ULL;
+	}
+	
+	char hashString[20];
+	sprintf( hashString, "%016llx", hash );
+	return G4String( hashString );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CalculateSolidVolume()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4double LUXSimDetectorComponent::CalculateSolidVolume()
+{
+	//	Monte Carlo volume of this component's solid, daughters included. The
+	//	samples are split into fixed chunks that are shared out among the
+	//	threads, and each chunk's random number stream is seeded from the solid
+	//	hash, so the answer is the same however many threads there are and
+	//	the global random number sequence isn't touched.
+	G4String hash = GetSolidHash();
+	std::ostringstream key;
+	key << hash << " " << volumePrecision << " " << GetName();
+	
+	G4String cacheFileName = luxManager->GetVolumeCacheFile();
+	if( cacheFileName != "" )
+		ReadVolumeCache( cacheFileName );
+	std::map<G4String,G4double>::iterator cached =
+			volumeCache.find( key.str() );
+	if( cached != volumeCache.end() )
+		return cached->second;
+	
+	G4VSolid *solid = GetLogicalVolume()->GetSolid();
+	G4double extentMin[3], extentMax[3];
+	solid->CalculateExtent( kXAxis, G4VoxelLimits(), G4AffineTransform(),
+			extentMin[0], extentMax[0] );
+	solid->CalculateExtent( kYAxis, G4VoxelLimits(), G4AffineTransform(),
+			extentMin[1], extentMax[1] );
+	solid->CalculateExtent( kZAxis, G4VoxelLimits(), G4AffineTransform(),
+			extentMin[2], extentMax[2] );
+	
+	//	This sets the required number of "inside" hits as a function of the
+	//	required precision. The precision is only approximately accurate, but
+	//	it should be in the ballpark.
+	std::vector<volumeChunk> chunks( NUM_VOLUME_CHUNKS );
+	unsigned long long seedBase = strtoull( hash.c_str(), NULL, 16 );
+	for( G4int i=0; i<NUM_VOLUME_CHUNKS; i++ ) {
+		chunks[i].solid = solid;
+		for( G4int j=0; j<3; j++ ) {
+			chunks[i].min[j] = extentMin[j];
+			chunks[i].max[j] = extentMax[j];
+		}
+		chunks[i].targetInsideSamples =
+				ceil( (G4double)volumePrecision/NUM_VOLUME_CHUNKS );
+		chunks[i].seed = (long)( (seedBase + 0x9E3779B97F4A7C15ULL*(i+1)) >>
+				33 );
+	}
+	
+	G4int numThreads = luxManager->GetVolumeThreads();
+	if( numThreads > 1 ) {
+		G4int numCPUs = GetNumAllowedCPUs();
+		if( numThreads > numCPUs )
+			numThreads = numCPUs;
+		if( !IsThreadSafeSolid( solid ) )
+			numThreads = 1;
+	}
+	if( numThreads < 1 )
+		numThreads = 1;
+	if( numThreads > NUM_VOLUME_CHUNKS )
+		numThreads = NUM_VOLUME_CHUNKS;
+	std::vector<volumeThread> threadWork( numThreads );
+	std::vector<pthread_t> threads( numThreads );
+	std::vector<G4bool> started( numThreads, false );
+	for( G4int i=0; i<numThreads; i++ ) {
+		threadWork[i].chunks = &chunks;
+		threadWork[i].firstChunk = i;
+		threadWork[i].chunkStride = numThreads;
+		if( i )
+			started[i] = !pthread_create( &threads[i], NULL,
+					SampleVolumeChunks, &threadWork[i] );
+	}
+	//	This thread does the first share, and any share whose thread couldn't
+	//	be started
+	for( G4int i=0; i<numThreads; i++ )
+		if( !started[i] )
+			SampleVolumeChunks( &threadWork[i] );
+	for( G4int i=1; i<numThreads; i++ )
+		if( started[i] )
+			pthread_join( threads[i], NULL );
+	
+	G4double totalSamples = 0;
+	G4double insideSamples = 0;
+	for( G4int i=0; i<NUM_VOLUME_CHUNKS; i++ ) {
+		totalSamples += chunks[i].totalSamples;
+		insideSamples += chunks[i].insideSamples;
+	}
+	
+	G4double outerTestVolume = (extentMax[0]-extentMin[0]) *
+			(extentMax[1]-extentMin[1]) * (extentMax[2]-extentMin[2]);
+	G4double solidVolume = outerTestVolume * insideSamples / totalSamples;
+	
+	volumeCache[key.str()] = solidVolume;
+	if( cacheFileName != "" )
+		WriteVolumeCache( cacheFileName );
+	
+	return solidVolume;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					CalculateMass()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -18,6 +18,12 @@
 *				  levels 2-4 and optical record levels 3 and 4 (Kareem)
 *   02 Aug 2013 - Superstitiously changed the order of includes (Kareem)
 *   20 Aug 2015 - Added the step process to the output file (Kareem)
+*   17 Oct 2026 - Event records are now serialized into a reusable in-memory
+*                 block that is written out in one go, rather than with one
+*                 write and flush per field (agent)
+*   17 Oct 2026 - Added output format version 2, which records the particle
+*                 and process names as IDs into a name table written once per
+*                 file (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -28,6 +34,7 @@
 //	C/C++ includes
 //
 #include <fstream>
+#include <vector>
 #include <stdio.h>
 #include <iostream>
 #include <sys/types.h>
@@ -56,13 +63,37 @@ class LUXSimOutput
 	public:
 		void RecordEventByVolume( LUXSimDetectorComponent*, G4int );
 		void RecordInputHistory();	
+		void EndOfEvent();
+		void FlushBuffer();
 	
+	private:
+		inline void BufferWrite( const void *data, G4int size ) {
+				outputBuffer.insert( outputBuffer.end(), (const char*)data,
+						(const char*)data + size ); };
+		void WriteStepNameTable();
+
 	private:
 		LUXSimManager *luxManager;
 		
 		G4String fName;
 		ofstream fLUXOutput;
 
+		//	The output buffer holds the serialized records of as many events as
+		//	it takes to reach either the byte or the event threshold. It is
+		//	cleared (but not deallocated) every time it is written to disk.
+		std::vector<char> outputBuffer;
+		G4int bufferSizeThreshold;
+		G4int bufferEventThreshold;
+		G4int bufferedEvents;
+		
+		//	Format 1 is the legacy format with the names written out as
+		//	strings on every step. Format 2 starts with a negative format tag,
+		//	and writes the particle and process names as IDs into the name
+		//	table that is appended at the end of the run.
+		G4int outputFormat;
+		G4int optPhotNameID;
+		G4int thermElecNameID;
+
 		G4int Size;
 		G4int particleNameSize;
 		G4int creatorProcessSize;
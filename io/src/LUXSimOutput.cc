@@ -80,6 +80,26 @@
 *   02-Aug-13 - Cleaned up the output directory handling to avoid crashes (Kareem)
 *   29-Apr-14 - The time stamp now records in local time instead of GMT (Kareem)
 *   28-Sep-15 - Handle the case of the code being in an SVN or Git repo (Kareem)
+*   17-Oct-26 - Event records are serialized into a reusable output buffer and
+*               written with a single write once the byte or event threshold
+*               is reached (and at the end of the run). The per-step flushes
+*               are gone. The on-disk format is unchanged. (agent)
+*   17-Oct-26 - Added output format version 2, selected with
+*               /LUXSim/io/outputFormat. Version 2 files begin with the format
+*               tag -2, followed by the record count and the 64-bit offset of
+*               the name table. Each step then carries three int IDs (particle,
+*               creator process, step process) instead of three strings, and
+*               the name table (count, then length-prefixed names) is written
+*               once at the end of the run. tools/LUXSimFormatConverter turns
+*               these files back into the legacy format. (agent)
+*   17-Oct-26 - A process started with /LUXSim/randomFirstEvent adds the first
+*               event to the file name, so the shards of a job don't write
+*               over each other (agent)
+*   17-Oct-26 - The event record and primary particles are read through const
+*               references instead of being copied for every volume (agent)
+*   17-Oct-26 - With /LUXSim/io/recordRunStatistics, the run statistics summary
+*               is appended to the end of the file as a length-prefixed string
+*               (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -120,6 +140,8 @@ LUXSimOutput::LUXSimOutput()
 	
 	// Create file name with the random number in it
 	RandSeed << luxManager->GetRandomSeed();
+	if( luxManager->GetRandomFirstEvent() )
+		RandSeed << "_" << luxManager->GetRandomFirstEvent();
 	SeedStr = RandSeed.str();
 
 	if( (luxManager->GetOutputName().length() > 0) &&
@@ -142,9 +164,21 @@ LUXSimOutput::LUXSimOutput()
 	fLUXOutput.open(OutNameTmp, ios::out | ios::binary);
 	delete[] OutName;
 	
-	// Set record size placeholder
+	// Set format tag, and the record size and name table offset placeholders
+	outputFormat = luxManager->GetOutputFormat();
+	if( outputFormat > 1 ) {
+		int formatTag = -outputFormat;
+		fLUXOutput.write((char *)(&formatTag), sizeof(int));
+	}
 	int placeholder = 0;
 	fLUXOutput.write((char *)(&placeholder), sizeof(int));
+	if( outputFormat > 1 ) {
+		long long tableOffset = 0;
+		fLUXOutput.write((char *)(&tableOffset), sizeof(long long));
+	}
+	
+	optPhotNameID = luxManager->GetStepNameID( "opticalphoton" );
+	thermElecNameID = luxManager->GetStepNameID( "thermalelectron" );
 
 	struct tm *gm;
 	time_t t;
@@ -236,6 +270,13 @@ LUXSimOutput::LUXSimOutput()
 	system(TempName3.c_str());
 
 	numRecords = 0;
+
+	bufferSizeThreshold = luxManager->GetOutputBufferSize();
+	bufferEventThreshold = luxManager->GetOutputFlushFrequency();
+	bufferedEvents = 0;
+	outputBuffer.clear();
+	if( bufferSizeThreshold > 0 )
+		outputBuffer.reserve( bufferSizeThreshold );
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -243,8 +284,31 @@ LUXSimOutput::LUXSimOutput()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 LUXSimOutput::~LUXSimOutput()
 {
-	fLUXOutput.seekp(0, std::ios_base::beg);
-	fLUXOutput.write((char *)(&numRecords), sizeof(int));
+	FlushBuffer();
+
+	if( outputFormat > 1 ) {
+		long long tableOffset = (long long)fLUXOutput.tellp();
+		WriteStepNameTable();
+		
+		fLUXOutput.seekp(sizeof(int), std::ios_base::beg);
+		fLUXOutput.write((char *)(&numRecords), sizeof(int));
+		fLUXOutput.write((char *)(&tableOffset), sizeof(long long));
+	} else {
+		fLUXOutput.seekp(0, std::ios_base::beg);
+		fLUXOutput.write((char *)(&numRecords), sizeof(int));
+	}
+	
+	//	The run statistics are only known once the run is over, so they can't
+	//	go in the header. They go after everything else instead, where readers
+	//	that stop at the record count (or the name table) never look.
+	if( luxManager->GetRecordRunStatistics() &&
+			luxManager->GetRunStatisticsSummary().length() ) {
+		fLUXOutput.seekp(0, std::ios_base::end);
+		Size = luxManager->GetRunStatisticsSummary().length();
+		fLUXOutput.write((char *)(&Size), sizeof(int));
+		fLUXOutput.write((char *)(luxManager->GetRunStatisticsSummary().c_str()),
+				Size);
+	}
 	
 	fLUXOutput.close();
 	
@@ -285,6 +349,64 @@ void LUXSimOutput::RecordInputHistory()
                 fLUXOutput.write((char *)(DetCompo.c_str()), Size);
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					EndOfEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimOutput::EndOfEvent()
+{
+	//	Called once all the volumes of an event have been serialized. The buffer
+	//	is written to disk when it has grown past the byte threshold, or when
+	//	enough events have accumulated. A threshold of 0 disables that check.
+	bufferedEvents++;
+	
+	if( (bufferSizeThreshold > 0 &&
+			(G4int)outputBuffer.size() >= bufferSizeThreshold) ||
+			(bufferEventThreshold > 0 && bufferedEvents >= bufferEventThreshold) )
+		FlushBuffer();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					FlushBuffer()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimOutput::FlushBuffer()
+{
+	if( outputBuffer.size() ) {
+		fLUXOutput.write( &outputBuffer[0], outputBuffer.size() );
+		fLUXOutput.flush();
+		if( DEBUGGING )
+			G4cout << "Wrote " << outputBuffer.size() << " bytes from "
+				   << bufferedEvents << " events to " << fName << ".tmp"
+				   << G4endl;
+	}
+	
+	//	clear() keeps the capacity, so the same block is reused for the next
+	//	set of events
+	outputBuffer.clear();
+	bufferedEvents = 0;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					WriteStepNameTable()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimOutput::WriteStepNameTable()
+{
+	//	The name table goes at the very end of a version 2 file, since names
+	//	keep being added until the last step of the run. The index of a name
+	//	in this table is the ID used in the step records.
+	const std::vector<G4String> &nameTable = luxManager->GetStepNameTable();
+	
+	G4int numNames = (G4int)nameTable.size();
+	fLUXOutput.write((char *)(&numNames), sizeof(int));
+	for( G4int i=0; i<numNames; i++ ) {
+		Size = nameTable[i].length();
+		fLUXOutput.write((char *)(&Size), sizeof(int));
+		fLUXOutput.write((char *)(nameTable[i].c_str()), Size);
+	}
+	
+	if( DEBUGGING )
+		G4cout << "Wrote " << numNames << " names to the name table" << G4endl;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					RecordEventByVolume()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -324,10 +446,10 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 
 	///////////////////////calculate record size
 
-        std::vector<LUXSimManager::stepRecord> eventRecord =
+        const std::vector<LUXSimManager::stepRecord> &eventRecord =
                         component->GetEventRecord();
 
-        std::vector<LUXSimManager::primaryParticleInfo> primaryPar =
+        const std::vector<LUXSimManager::primaryParticleInfo> &primaryPar =
                         luxManager->GetPrimaryParticles();
 
         totalVolumeEnergy = 0.;
@@ -337,9 +459,9 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
         G4int recordsize3 = 0;
         for( G4int i=0; i<(G4int)eventRecord.size(); i++ ){
                 totalVolumeEnergy += eventRecord[i].energyDeposition;
-                if (eventRecord[i].particleName == "opticalphoton"){
+                if (eventRecord[i].particleNameID == optPhotNameID){
                         totalOptPhotNumber ++;
-                }else if(eventRecord[i].particleName == "thermalelectron"){
+                }else if(eventRecord[i].particleNameID == thermElecNameID){
                         totalThermElecNumber ++; 
 		}else{
                         if ( eventRecord[i].energyDeposition > 0. ){
@@ -357,29 +479,25 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 	////  Primary particle information
 	primaryParSize = (int) primaryPar.size();
 
-        fLUXOutput.write((char *)(&primaryParSize),sizeof(int));
+	BufferWrite( &primaryParSize, sizeof(int) );
 	if ( DEBUGGING ) G4cout<< "\n primaryParSize = "<< primaryParSize <<G4endl;
 	for (int m = 0; m < primaryParSize; m++ ) {
 		Size = primaryPar[m].id.length();
-		fLUXOutput.write((char *)(&Size),sizeof(int));
+		BufferWrite( &Size, sizeof(int) );
 		primaryParName = primaryPar[m].id;
-		fLUXOutput.write((char *)(primaryParName.c_str()),Size);
+		BufferWrite( primaryParName.c_str(), Size );
 		primaryParEnergy_keV = primaryPar[m].energy / keV;
-		fLUXOutput.write((char *)(&primaryParEnergy_keV),sizeof(double));		
+		BufferWrite( &primaryParEnergy_keV, sizeof(double) );
 		primaryParTime_ns = primaryPar[m].time / ns;
-                fLUXOutput.write((char *)(&primaryParTime_ns),sizeof(double));
+		BufferWrite( &primaryParTime_ns, sizeof(double) );
 		primaryParPos_mm[0] = primaryPar[m].position[0] / mm;
-		fLUXOutput.write((char *)(&primaryParPos_mm[0]),sizeof(double));	
 		primaryParPos_mm[1] = primaryPar[m].position[1] / mm;
-		fLUXOutput.write((char *)(&primaryParPos_mm[1]),sizeof(double));
 		primaryParPos_mm[2] = primaryPar[m].position[2] / mm;
-		fLUXOutput.write((char *)(&primaryParPos_mm[2]),sizeof(double));
+		BufferWrite( primaryParPos_mm, 3*sizeof(double) );
 		primaryParDir[0] = primaryPar[m].direction[0];
-		fLUXOutput.write((char *)(&primaryParDir[0]),sizeof(double));
 		primaryParDir[1] = primaryPar[m].direction[1];
-		fLUXOutput.write((char *)(&primaryParDir[1]),sizeof(double));
 		primaryParDir[2] = primaryPar[m].direction[2];
-		fLUXOutput.write((char *)(&primaryParDir[2]),sizeof(double));
+		BufferWrite( primaryParDir, 3*sizeof(double) );
 
 		if( DEBUGGING ) {
 			G4cout<<"primary_ID = "<< primaryParName <<G4endl;
@@ -403,22 +521,19 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 	optPhotRecordLevel = component->GetRecordLevelOptPhot();
 	thermElecRecordLevel = component->GetRecordLevelThermElec();
 	recordLevel = component->GetRecordLevel();
-	fLUXOutput.write((char *)(&recordLevel),sizeof(int));
-	fLUXOutput.write((char *)(&optPhotRecordLevel),sizeof(int));
-        fLUXOutput.write((char *)(&thermElecRecordLevel),sizeof(int));
+	BufferWrite( &recordLevel, sizeof(int) );
+	BufferWrite( &optPhotRecordLevel, sizeof(int) );
+	BufferWrite( &thermElecRecordLevel, sizeof(int) );
 	volume = component->GetID();
-	fLUXOutput.write((char *)(&volume),sizeof(int));
-	fLUXOutput.write((char *)(&eventNum),sizeof(int));
+	BufferWrite( &volume, sizeof(int) );
+	BufferWrite( &eventNum, sizeof(int) );
 
 	//	record steping information according to the specified record level
 	//
-	if( recordLevel>0) fLUXOutput.write((char *)(&totalVolumeEnergy),
-			sizeof(double));
-	if( optPhotRecordLevel >0) fLUXOutput.write((char *)(&totalOptPhotNumber),
-			sizeof(int));
-        if( thermElecRecordLevel >0) fLUXOutput.write((char *)(&totalThermElecNumber),
-                        sizeof(int));
-	fLUXOutput.flush();
+	if( recordLevel>0) BufferWrite( &totalVolumeEnergy, sizeof(double) );
+	if( optPhotRecordLevel >0) BufferWrite( &totalOptPhotNumber, sizeof(int) );
+	if( thermElecRecordLevel >0) BufferWrite( &totalThermElecNumber,
+			sizeof(int) );
 	if( DEBUGGING ) {
 		G4cout << G4endl;
 		G4cout << "OpticalLevel, thermElecLevel, recordLevel, volume, evtN, Edep, NOptPho, NthermEle= "
@@ -438,37 +553,42 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 	if (optPhotRecordLevel > 2 ) recordSize += totalOptPhotNumber;
 	if (thermElecRecordLevel >2 ) recordSize += totalThermElecNumber;
 
-	fLUXOutput.write((char *)(&recordSize),sizeof(int));
-	fLUXOutput.flush();
+	BufferWrite( &recordSize, sizeof(int) );
 	
 	if( recordSize > 0 ) {
 		for( G4int i=0; i<(G4int)eventRecord.size(); i++ ) {
-			if( ( (eventRecord[i].particleName != "opticalphoton") && 
-				(eventRecord[i].particleName != "thermalelectron") &&
+			if( ( (eventRecord[i].particleNameID != optPhotNameID) && 
+				(eventRecord[i].particleNameID != thermElecNameID) &&
 				  ( (eventRecord[i].energyDeposition > 0 && recordLevel == 2) ||
 					recordLevel >2 ) ) ||
 				(optPhotRecordLevel > 2 &&
-						eventRecord[i].particleName == "opticalphoton") ||
+						eventRecord[i].particleNameID == optPhotNameID) ||
 				(thermElecRecordLevel > 2 &&
-                                                eventRecord[i].particleName == "thermalelectron") ) {
-
-				particleName = eventRecord[i].particleName;
-				particleNameSize = particleName.length();
-				fLUXOutput.write((char *)(&particleNameSize), sizeof(int));
-				fLUXOutput.write((char *)(particleName.c_str()),
-						particleNameSize);
-
-				creatorProcess = eventRecord[i].creatorProcess;
-				creatorProcessSize = creatorProcess.length();
-				fLUXOutput.write((char *)(&creatorProcessSize), sizeof(int));
-				fLUXOutput.write((char *)(creatorProcess.c_str()),
-						creatorProcessSize);
-                
-                stepProcess = eventRecord[i].stepProcess;
-                stepProcessSize = stepProcess.length();
-                fLUXOutput.write((char *)(&stepProcessSize), sizeof(int));
-                fLUXOutput.write((char *)(stepProcess.c_str()),
-                        stepProcessSize);
+                                                eventRecord[i].particleNameID == thermElecNameID) ) {
+
+				if( outputFormat > 1 ) {
+					BufferWrite( &eventRecord[i].particleNameID, sizeof(int) );
+					BufferWrite( &eventRecord[i].creatorProcessID, sizeof(int) );
+					BufferWrite( &eventRecord[i].stepProcessID, sizeof(int) );
+				} else {
+					particleName =
+							luxManager->GetStepName( eventRecord[i].particleNameID );
+					particleNameSize = particleName.length();
+					BufferWrite( &particleNameSize, sizeof(int) );
+					BufferWrite( particleName.c_str(), particleNameSize );
+
+					creatorProcess =
+							luxManager->GetStepName( eventRecord[i].creatorProcessID );
+					creatorProcessSize = creatorProcess.length();
+					BufferWrite( &creatorProcessSize, sizeof(int) );
+					BufferWrite( creatorProcess.c_str(), creatorProcessSize );
+
+					stepProcess =
+							luxManager->GetStepName( eventRecord[i].stepProcessID );
+					stepProcessSize = stepProcess.length();
+					BufferWrite( &stepProcessSize, sizeof(int) );
+					BufferWrite( stepProcess.c_str(), stepProcessSize );
+				}
 						
 				data.stepNumber = eventRecord[i].stepNumber;
 				data.particleID = eventRecord[i].particleID;
@@ -484,15 +604,12 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 				data.position[2]=eventRecord[i].position[2];
 				data.stepTime= eventRecord[i].stepTime;
 				
-				fLUXOutput.write((char *)(&data),sizeof(data));
-
-
-				fLUXOutput.flush();
+				BufferWrite( &data, sizeof(data) );
 
 				if (DEBUGGING) {
 					G4cout << "sizeof(data) = " << sizeof(data) << G4endl;
-					G4cout << "particleName, Size= " << particleName << ", "
-						   << particleNameSize << G4endl;
+					G4cout << "particleName= " << luxManager->GetStepName(
+							eventRecord[i].particleNameID ) << G4endl;
 					G4cout << "data.stepNumber= " << data.stepNumber << G4endl;
 					G4cout << "data.particleID= " << data.particleID << G4endl;
 					G4cout << "data.trackID= " << data.trackID << G4endl;
@@ -509,8 +626,8 @@ void LUXSimOutput::RecordEventByVolume( LUXSimDetectorComponent* component,
 						   << data.position[1] << ", " << data.position[2]
 						   << G4endl;
 					G4cout << "data.stepTime= " << data.stepTime << G4endl;
-					G4cout << "creatorProcess, Size= " << creatorProcess << ", "
-						   << creatorProcessSize << G4endl;
+					G4cout << "creatorProcess= " << luxManager->GetStepName(
+							eventRecord[i].creatorProcessID ) << G4endl;
 					G4cout << G4endl << G4endl;
 				}	
 			}
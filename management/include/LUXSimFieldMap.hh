@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimFieldMap.hh
+*
+* This is the header file for the XYZ-dependent field maps. A map holds values
+* on a regular grid, and returns all of them at an arbitrary point with a single
+* linear interpolation. It reads one of two layouts:
+*
+*	- the COMSOL text file of SetGrid, an x/y/z grid with the electric field,
+*	  drift time and S2 x/y position at every grid point
+*	- the R-z tables of SetRZGrid, such as the drift time and radial drift
+*	  files, with one value at every grid point of an R/z grid
+*
+* The grid is read from the text file the first time it is needed, and a binary
+* copy of it is written to the cache directory given to Load (the output
+* directory), since the text files often sit where they can't be written. Later
+* runs (and later jobs) memory-map the binary copy instead of parsing the text
+* again.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Added the R-z table layout, for the drift time and radial
+*				  drift tables (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LUXSimFieldMap_HH
+#define LUXSimFieldMap_HH 1
+
+//
+//	C/C++ includes
+//
+#include <vector>
+
+//
+//	GEANT4 includes
+//
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+class LUXSimFieldMap
+{
+	public:
+		LUXSimFieldMap();
+		~LUXSimFieldMap();
+
+		//	Indices into the array filled by Interpolate, for the COMSOL
+		//	layout. An R-z table fills just the one value, kTableValue.
+		enum { kEField=0, kDriftTime, kS2X, kS2Y, kNumValues };
+		enum { kTableValue=0 };
+
+		//	Returned for any value that can't be interpolated at a point,
+		//	either because the point is off the grid or because one of the
+		//	surrounding grid points is outside the fiducial region
+		static const G4double kOutsideValue;
+
+		void SetGrid( G4int nx, G4int ny, G4int nz, G4ThreeVector minLocation,
+				G4ThreeVector stepSize );
+		//	An R-z table has numZ lines of numR values, the value at R = minR +
+		//	i*step and z = minZ + j*step being the ith on the jth line. Values
+		//	are multiplied by scale as they're read, and negative ones mark
+		//	grid points outside the fiducial region.
+		void SetRZGrid( G4int numR, G4int numZ, G4double minR, G4double minZ,
+				G4double step, G4double scale );
+		//	The binary cache of fileName is looked for, and written, in
+		//	cacheDir
+		void Load( G4String fileName, G4String cacheDir );
+		void Clear();
+
+		G4bool IsLoaded() { return (nodeValues != NULL); };
+		G4String GetFileName() { return loadedFile; };
+
+		G4bool Interpolate( const G4ThreeVector &x, G4double *values );
+
+	private:
+		enum { kCOMSOLLayout=0, kRZTableLayout };
+
+		void SetPlanes( G4int layout, G4int values, G4int nx, G4int ny,
+				G4int nz, G4ThreeVector minLoc, G4ThreeVector step,
+				G4double scale );
+		G4bool ReadCache( G4String cacheName, G4String textName );
+		void WriteCache( G4String cacheName, G4String textName );
+		void ReadText( G4String textName );
+		void ReadRZTable( G4String textName );
+
+	private:
+		G4int layout;
+		G4int numValues;
+		G4double valueScale;
+		//	An R-z table is a grid with a single plane in y, and the R of a
+		//	point in place of its x
+		G4int numPlanes[3];
+		G4double minLocation[3];
+		G4double stepSize[3];
+		G4int numNodes;
+
+		G4String loadedFile;
+
+		//	numValues floats per grid point (for the COMSOL layout the field,
+		//	drift time, S2 x and S2 y), and one status byte per grid point.
+		//	These point either into the vectors below or into the mapped
+		//	cache file.
+		const float *nodeValues;
+		const unsigned char *nodeStatus;
+
+		std::vector<float> valueStorage;
+		std::vector<unsigned char> statusStorage;
+
+		void *mappedCache;
+		size_t mappedSize;
+};
+
+#endif
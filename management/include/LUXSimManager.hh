@@ -100,6 +100,37 @@
 *   28-Sep-15 - Added SVN/Git repo check support (Kareem)
 *   06-Oct-15 - Added methods for G4Decay generator (David W)
 *   18-Dec-2015 - Added muon-nuclear interaction physics (David W, merged in by Doug T)
+*   17-Oct-2026 - Added Get/Set methods for the output buffer size and flush
+*                 frequency (agent)
+*   17-Oct-2026 - The step record now carries interned IDs for the particle,
+*                 creator process and step process names instead of strings.
+*                 Added the per-run name table and the output format version
+*                 (agent)
+*   17-Oct-2026 - Added FindComponent for constant-time volume to component
+*                 lookups (agent)
+*   17-Oct-2026 - Added per-event seeding, the first event number and the
+*                 event list size, so that a job can be split into shards
+*                 (agent)
+*   17-Oct-2026 - Step records and primary particles are passed by reference
+*                 (agent)
+*   17-Oct-2026 - The XYZ-dependent field map is now a LUXSimFieldMap. Added
+*                 GetXYZDependentFieldValues to get the field, drift time and
+*                 S2 position in one call. The drift time and radial drift
+*                 tables are LUXSimFieldMaps too (agent)
+*   17-Oct-2026 - The events file generator reads through LUXSimEventsFile
+*                 instead of queues, and can start at any event in the file
+*                 (agent)
+*   17-Oct-2026 - Added the run statistics, GetComponentByID and the command
+*                 hooks to record the run statistics in the output file (agent)
+*   17-Oct-2026 - Added the FastSim library and connections files, and
+*                 CompileFastSimLibrary to write a library image (agent)
+*   17-Oct-2026 - Added the parametrized S2 switch and its photon detection
+*                 efficiency (agent)
+*   17-Oct-2026 - Added the component volume cache file (agent)
+*   17-Oct-2026 - Added the number of volume calculation threads (agent)
+*   17-Oct-2026 - Added GetEventListCutoff (agent)
+*   17-Oct-2026 - Added the event streams, which hand out the events of each
+*                 source as the run needs them when streamEvents is set (agent)
 *   
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -139,6 +170,9 @@
 class G4UImanager;
 class G4GeneralParticleSource;
 class G4Event;
+class G4ParticleDefinition;
+class G4VProcess;
+class G4VPhysicalVolume;
 
 class LUXSimPhysicsList;
 class LUXSimPhysicsOpticalPhysics;
@@ -152,6 +186,10 @@ class LUXSimSteppingAction;
 class LUXSimOutput;
 class LUXSimMessenger;
 class LUXSimSourceCatalog;
+class LUXSimFieldMap;
+class LUXSimRunStatistics;
+class LUXSimEventsFile;
+struct eventsFileDeposit;
 
         static const int NumPlanesX = 49;  //placeholder value but should be close
 
@@ -215,6 +253,11 @@ class LUXSimManager
 		void BeamOn( G4int );
 		inline G4int GetRandomSeed() { return randomSeed; };
 		void SetRandomSeed( G4int );
+		inline G4bool GetPerEventSeeds() { return perEventSeeds; };
+		inline void SetPerEventSeeds( G4bool val ) { perEventSeeds = val; };
+		void SeedEvent( G4int );
+		inline G4int GetRandomFirstEvent() { return randomFirstEvent; };
+		inline void SetRandomFirstEvent( G4int val ) { randomFirstEvent = val; };
 		
 		//	Input/output methods
         void SetIsSVNRepo( G4bool isSVN ) { IsSVNRepo = isSVN; }
@@ -257,10 +300,31 @@ class LUXSimManager
 	G4double GetXYZDependentS2_X(G4ThreeVector x);
 	G4double GetXYZDependentS2_Y (G4ThreeVector x);
 	G4double GetXYZDependentDriftTime (G4ThreeVector x);
+	G4bool GetXYZDependentFieldValues( const G4ThreeVector &x,
+			G4double *values );
 /**/
         void SetEventProgressFrequency( G4int val ) { eventProgressFrequency = val;};
         G4int GetEventProgressFreqnecy() { return eventProgressFrequency; };
     
+        inline void SetOutputBufferSize( G4int val ) { outputBufferSize = val; };
+        inline G4int GetOutputBufferSize() { return outputBufferSize; };
+        inline void SetOutputFlushFrequency( G4int val )
+                { outputFlushFrequency = val; };
+        inline G4int GetOutputFlushFrequency() { return outputFlushFrequency; };
+        inline void SetOutputFormat( G4int val ) { outputFormat = val; };
+        inline G4int GetOutputFormat() { return outputFormat; };
+        
+        //  Run statistics. The summary of the last finished run is kept so
+        //  that LUXSimOutput can append it to the output file.
+        inline LUXSimRunStatistics *GetRunStatistics()
+                { return runStatistics; };
+        inline void SetRecordRunStatistics( G4bool val )
+                { recordRunStatistics = val; };
+        inline G4bool GetRecordRunStatistics() { return recordRunStatistics; };
+        inline const G4String &GetRunStatisticsSummary()
+                { return runStatisticsSummary; };
+        void EndOfRunStatistics();
+    
         inline G4double Get100keVHack() { return use100keVHack; };
         inline void Set100keVHack( G4double val ) { use100keVHack = val; };
         inline void AddLiquidXenonEnergy( G4double en )
@@ -296,6 +360,14 @@ class LUXSimManager
                 checkVolumeOverlaps = val; }
         G4bool GetCheckVolumeOverlaps() { return checkVolumeOverlaps; };
     
+        //  Component volumes are cached in this file from one run to the
+        //  next. An empty name, the default, turns the cache off.
+        void SetVolumeCacheFile( G4String val ) { volumeCacheFile = val; };
+        G4String GetVolumeCacheFile() { return volumeCacheFile; };
+        //  Most threads a component volume is calculated on
+        void SetVolumeThreads( G4int val ) { volumeThreads = val; };
+        G4int GetVolumeThreads() { return volumeThreads; };
+    
         void SetComponentMass( G4String );
         void SetComponentVolume( G4String );
 
@@ -334,6 +406,10 @@ class LUXSimManager
 		G4int GetComponentRecordLevelThermElec( LUXSimDetectorComponent* );
 		
 		LUXSimDetectorComponent *GetComponentByName( G4String );
+		LUXSimDetectorComponent *FindComponent( G4VPhysicalVolume* );
+		inline LUXSimDetectorComponent *GetComponentByID( G4int id )
+				{ return ( id > 0 && id <= (G4int)luxSimComponents.size() ) ?
+						luxSimComponents[id-1] : NULL; };
 		
 		void SetCollimatorHeight( G4double );
 		void SetCollimatorHoleDiameter( G4double );
@@ -460,10 +536,25 @@ class LUXSimManager
 				{ luxFastSimSkewGaussianS2 = val; };
 		G4bool GetLUXFastSimSkewGaussianS2()
 				{ return luxFastSimSkewGaussianS2; };
+
+		//	Every change to the library or connections file bumps the count,
+		//	so the fast sims know to load the library again
+		void SetFastSimLibrary( G4String val )
+				{ fastSimLibrary = val; fastSimLibraryChanges++; };
+		G4String GetFastSimLibrary() { return fastSimLibrary; };
+		void SetFastSimConnections( G4String val )
+				{ fastSimConnections = val; fastSimLibraryChanges++; };
+		G4String GetFastSimConnections() { return fastSimConnections; };
+		G4int GetFastSimLibraryChanges() { return fastSimLibraryChanges; };
+		void CompileFastSimLibrary( G4String imageFile );
   
          //	Source methods
         void SetSource( G4String );
         void SetPrintEventList( G4bool sel ) { printEventList = sel; };
+        void SetEventListEvents( G4int num ) { eventListEvents = num; };
+        G4int GetNumEventListEvents();
+        void SetStreamEvents( G4bool sel ) { streamEvents = sel; };
+        G4bool GetStreamEvents() { return streamEvents; };
         void ResetSources();
         void BuildEventList();
         void TrimEventList();
@@ -473,6 +564,9 @@ class LUXSimManager
       	G4double GetTotalSimulationActivity() { return totalSimulationActivity;};
         G4bool GetLUXSimSources() { return hasLUXSimSources;};
         void RecordTreeInsert(Isotope*, G4double, G4ThreeVector, G4int, G4int);
+        G4double GetEventListCutoff();
+        void AddEventStream( G4int sourceByVolumeID, G4int sourcesID,
+                G4double rate );
         G4double GetWindowEndTime() {return windowEnd;};
 
         G4double GetGammaXFiducialR() {return gammaXFiducialR;}
@@ -492,6 +586,8 @@ class LUXSimManager
         G4int NextParticleIDToGenerate();
         G4double NextEnergyDepToGenerate();
         G4ThreeVector NextPositionToGenerate();
+        void SetEventsFileFirstEvent( G4int );
+        G4int GetEventsFileFirstEvent() { return eventsFileFirstEvent; };
 
         G4bool GetG4DecayBool(){ return g4decaybool; };
         void SetG4DecayBool(G4bool val){ g4decaybool = val; };
@@ -510,9 +606,9 @@ class LUXSimManager
 		struct stepRecord {
 			G4int stepNumber;
 			G4int particleID;
-			G4String particleName;
-			G4String creatorProcess;
-            G4String stepProcess;
+			G4int particleNameID;
+			G4int creatorProcessID;
+            G4int stepProcessID;
 			G4int trackID;
 			G4int parentID;
 			G4double particleEnergy;
@@ -521,7 +617,19 @@ class LUXSimManager
 			G4double position[3];
 			G4double stepTime;
 		};
-		void AddDeposition( LUXSimDetectorComponent*, stepRecord );
+		void AddDeposition( LUXSimDetectorComponent*, const stepRecord& );
+		
+		//	Name table for the step records. Every distinct particle and process
+		//	name seen during a run gets a small integer ID, which is what the
+		//	step records carry around. The table is cleared at every BeamOn.
+		void ResetStepNameTable();
+		G4int GetStepNameID( const G4String& );
+		G4int GetParticleNameID( const G4ParticleDefinition* );
+		G4int GetProcessNameID( const G4VProcess* );
+		inline const G4String &GetStepName( G4int id )
+				{ return stepNameTable[id]; };
+		inline const std::vector<G4String> &GetStepNameTable()
+				{ return stepNameTable; };
 		G4bool KillPhoton( LUXSimDetectorComponent* );
 		void RecordValues( G4int );
 		void RecordValuesOptPhot( G4int );
@@ -536,9 +644,9 @@ class LUXSimManager
 			G4ThreeVector position;
 			G4ThreeVector direction;
 		};
-		void AddPrimaryParticle( primaryParticleInfo particle )
+		void AddPrimaryParticle( const primaryParticleInfo &particle )
 				{ primaryParticles.push_back( particle );}; 
-		std::vector<primaryParticleInfo> GetPrimaryParticles()
+		const std::vector<primaryParticleInfo> &GetPrimaryParticles()
 				{ return primaryParticles; };
 
 		//	Physics list methods
@@ -549,6 +657,12 @@ class LUXSimManager
         inline G4double GetS1Gain() { return s1gain; };
         inline void SetS2Gain( G4double val ) { s2gain = val; };
         inline G4double GetS2Gain() { return s2gain; };
+        inline void SetParametrizedS2( G4bool val ) { parametrizedS2 = val; };
+        inline G4bool GetParametrizedS2() { return parametrizedS2; };
+        inline void SetParametrizedS2Efficiency( G4double val )
+				{ parametrizedS2Efficiency = val; };
+        inline G4double GetParametrizedS2Efficiency()
+				{ return parametrizedS2Efficiency; };
 		
 		inline void SetDriftElecAttenuation( G4double val )
 				{ driftElecAttenuation = val; };
@@ -592,6 +706,8 @@ class LUXSimManager
 		
 		CLHEP::MTwistEngine randomizationEngine;
 		G4int randomSeed;
+		G4bool perEventSeeds;
+		G4int randomFirstEvent;
 		
 		//	Input/output variables
         G4bool   IsSVNRepo;
@@ -606,6 +722,17 @@ class LUXSimManager
 		G4int numEvents;
 		G4bool alwaysRecordPrimary;
 		G4int eventProgressFrequency;
+        G4int outputBufferSize;
+        G4int outputFlushFrequency;
+        G4int outputFormat;
+        LUXSimRunStatistics *runStatistics;
+        G4bool recordRunStatistics;
+        G4String runStatisticsSummary;
+        
+        std::vector<G4String> stepNameTable;
+        std::map<G4String,G4int> stepNameIDs;
+        std::map<const G4ParticleDefinition*,G4int> particleNameIDs;
+        std::map<const G4VProcess*,G4int> processNameIDs;
         G4double use100keVHack;
         G4double liquidXenonTotalEnergy;
         G4int eventCount;
@@ -621,6 +748,8 @@ class LUXSimManager
 		std::vector<LUXSimDetectorComponent*> luxSimComponents;
 		G4String detectorSelection;
         G4bool checkVolumeOverlaps;
+        G4String volumeCacheFile;
+        G4int volumeThreads;
 		G4String muonVetoSelection;
 		G4String LZVetoSelection;
 		G4String cryoStandSelection;
@@ -668,7 +797,7 @@ class LUXSimManager
 
         G4String EFieldFile;
 
-        double xyzDependentEField[NumPlanesX][NumPlanesY][NumPlanesZ][NumxyzDependentEFieldVars];
+        LUXSimFieldMap *xyzDependentFieldMap;
 
 // XYZ-dependent electric field calculated by Lucie
 
@@ -679,15 +808,18 @@ class LUXSimManager
 
         G4bool DriftTimeFromFile;
         G4String DriftTimeFile;
-        G4double xyzDependentDriftTime[251][598]; // XYZ-dependent drift time calculated from COMSOL
+        LUXSimFieldMap *xyzDependentDriftTimeMap; // R-z drift time table calculated from COMSOL
 
         G4bool RadialDriftFromFile;
         G4String RadialDriftFile;
-        G4double xyzDependentRadialDrift[251][598]; // XYZ-dependent radial drift calculated from COMSOL
+        LUXSimFieldMap *xyzDependentRadialDriftMap; // R-z radial drift table calculated from COMSOL
 
         G4bool luxDoublePheRateFromFile;
 
         G4bool luxFastSimSkewGaussianS2;
+        G4String fastSimLibrary;
+        G4String fastSimConnections;
+        G4int fastSimLibraryChanges;
 
         G4String cavernRockSelection;
 
@@ -704,6 +836,25 @@ class LUXSimManager
         G4bool hasDecayChainSources, printEventList;
         LUXSimBST* recordTree;
 
+        void SkipEarlierEvents();
+        G4int eventListEvents;
+
+        //  When events are streamed, each source is a Poisson process that
+        //  only knows the time of its next event, and the streams are kept in
+        //  a min-heap on that time. AdvanceEventStreams moves the earliest
+        //  ones into the record until the record's earliest event is the
+        //  earliest of all.
+        struct eventStream {
+          G4int sourceByVolumeID;
+          G4int sourcesID;
+          G4double rate;//Bq
+          G4double nextTime;//ns
+        };
+        static G4bool StreamLater( const eventStream&, const eventStream& );
+        void AdvanceEventStreams();
+        G4bool streamEvents;
+        std::vector<eventStream> eventStreams;
+
         G4double gammaXFiducialR;
         G4double gammaXFiducialLoZ;
         G4double gammaXFiducialHiZ;
@@ -727,21 +878,20 @@ class LUXSimManager
 		G4bool opticalDebugging;
         G4double s1gain;
         G4double s2gain;
+        G4bool parametrizedS2;
+        G4double parametrizedS2Efficiency;
 		G4double driftElecAttenuation;
 
         // for evnets file generator
-        std::queue<G4int> qEvtN;
-        std::queue<G4int> qParticleID;
-        std::queue<G4double> qEnergyDep_keV;
-        std::queue<G4double> qPositionX_cm;
-        std::queue<G4double> qPositionY_cm;
-        std::queue<G4double> qPositionZ_cm;
+        LUXSimEventsFile *eventsFileReader;
+        G4int eventsFileFirstEvent;
+        G4int nextEventsFileEvent;
         G4int currentEvtN;
-        std::queue<G4int> currentParticleID;
-        std::queue<G4double> currentEnergyDep_keV;
-        std::queue<G4double> currentX_cm;
-        std::queue<G4double> currentY_cm;
-        std::queue<G4double> currentZ_cm;
+        const eventsFileDeposit *currentDeposits;
+        G4int currentNumDeposits;
+        G4int nextParticleIDDeposit;
+        G4int nextEnergyDepDeposit;
+        G4int nextPositionDeposit;
 
 
 };
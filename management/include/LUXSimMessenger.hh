@@ -71,6 +71,18 @@
 *   26-Sep-14 - Added option to change YBe pig height and diameter (Kevin)
 *   14-Oct-14 - Added component-wise SetMass and SetVolume commands (Kareem)
 *   02-Feb-15 - Added pencil beam command for the LUX DD generator (Kevin)
+*   17-Oct-26 - Added the output buffer size and flush frequency commands
+*               (agent)
+*   17-Oct-26 - Added the output format command (agent)
+*   17-Oct-26 - Added the per-event seeds, random first event and event list
+*               size commands (agent)
+*   17-Oct-26 - Added the events file first event command (agent)
+*   17-Oct-26 - Added the FastSim library, connections and compile commands
+*               (agent)
+*   17-Oct-26 - Added the parametrized S2 commands (agent)
+*   17-Oct-26 - Added the volume cache file command (agent)
+*   17-Oct-26 - Added the volume threads command (agent)
+*   17-Oct-26 - Added the streamEvents command (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -114,6 +126,8 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIdirectory				*LUXSimDir;
 		G4UIcmdWithAnInteger		*LUXSimBeamOnCommand;
 		G4UIcmdWithAnInteger		*LUXSimRandomSeedCommand;
+		G4UIcmdWithABool			*LUXSimPerEventSeedsCommand;
+		G4UIcmdWithAnInteger		*LUXSimRandomFirstEventCommand;
 		
 		//	Input/output commands
 		G4UIdirectory				*LUXSimFileDir;
@@ -121,6 +135,11 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIcmdWithAString			*LUXSimOutputNameCommand;
 		G4UIcmdWithABool			*LUXSimAlwaysRecordPrimaryCommand;
         G4UIcmdWithAnInteger        *LUXSimEventProgressCommand;
+        G4UIcmdWithAnInteger        *LUXSimOutputBufferSizeCommand;
+        G4UIcmdWithAnInteger        *LUXSimOutputFlushFrequencyCommand;
+        G4UIcmdWithAnInteger        *LUXSimOutputFormatCommand;
+        G4UIcmdWithABool            *LUXSimStepStatisticsCommand;
+        G4UIcmdWithABool            *LUXSimRecordRunStatisticsCommand;
         G4UIcmdWithADoubleAndUnit   *LUXSim100keVHackCommand;
 
         // User defined variables commands.
@@ -138,6 +157,8 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIcmdWithADoubleAndUnit	*LUXSimDetectorZCommand;
         G4UIcmdWithAString          *LUXSimComponentSetMassCommand;
         G4UIcmdWithAString          *LUXSimComponentSetVolumeCommand;
+        G4UIcmdWithAString          *LUXSimVolumeCacheFileCommand;
+        G4UIcmdWithAnInteger        *LUXSimVolumeThreadsCommand;
 		G4UIcmdWithAString	    	*LUXSimMuonVetoCommand;
 		G4UIcmdWithAString	    	*LUXSimLZVetoCommand;
 		G4UIcmdWithAString   		*LUXSimCryoStandCommand;
@@ -186,6 +207,9 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIcmdWithABool			*LUXSimLUXDoublePheRateFromFileCommand;
 
 		G4UIcmdWithABool			*LUXFastSimSkewGaussianS2Command;
+		G4UIcmdWithAString			*LUXSimFastSimLibraryCommand;
+		G4UIcmdWithAString			*LUXSimFastSimConnectionsCommand;
+		G4UIcmdWithAString			*LUXSimCompileFastSimLibraryCommand;
                 G4UIcmdWithAString                      *LUXSimCavernRockCommand;
   
 		//	Source commands
@@ -193,6 +217,9 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIcmdWithAString			*LUXSimSourceSetCommand;
 		G4UIcmdWithoutParameter		*LUXSimSourceResetCommand;
 		G4UIcmdWithABool         	*LUXSimSourcePrintCommand;
+		G4UIcmdWithAnInteger		*LUXSimSourceEventListEventsCommand;
+		G4UIcmdWithABool			*LUXSimSourceStreamEventsCommand;
+		G4UIcmdWithAnInteger		*LUXSimEventsFileFirstEventCommand;
 		
 		//	Physics list commands
 		G4UIdirectory				*LUXSimPhysicsListDir;
@@ -200,6 +227,8 @@ class LUXSimMessenger : public G4UImessenger
 		G4UIcmdWithABool			*LUXSimOpticalDebugCommand;
         G4UIcmdWithADouble          *LUXSimS1GainCommand;
         G4UIcmdWithADouble          *LUXSimS2GainCommand;
+        G4UIcmdWithABool            *LUXSimParametrizedS2Command;
+        G4UIcmdWithADouble          *LUXSimParametrizedS2EfficiencyCommand;
 		G4UIcmdWithADoubleAndUnit	*LUXSimDriftingElectronAttenuationCommand;
 		
 		//	Materials commands
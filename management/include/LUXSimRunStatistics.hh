@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimRunStatistics.hh
+*
+* This is the header file for the run statistics. The manager owns one of these
+* and uses it to time the major phases of a run (geometry build, event list
+* generation, event loop and output writing) and every event. When step
+* statistics are turned on, it also counts the steps taken by each particle
+* type and in each detector component, along with the wall time spent between
+* successive steps. The size of the event list at its largest and the peak
+* resident memory of the process are reported as well.
+*
+* At the end of the run the counters are printed as a summary where every line
+* starts with "LUXSimStats", followed by the kind of counter, its name, and
+* key=value pairs, so that the summary can be pulled out of a log with grep.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Added the event list size and the peak memory (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LUXSimRunStatistics_HH
+#define LUXSimRunStatistics_HH 1
+
+//
+//	C/C++ includes
+//
+#include <vector>
+
+//
+//	GEANT4 includes
+//
+#include "globals.hh"
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+class LUXSimRunStatistics
+{
+	public:
+		LUXSimRunStatistics();
+		~LUXSimRunStatistics();
+
+		//	Wall-clock time in seconds, with microsecond resolution
+		static G4double GetWallTime();
+
+		void Reset();
+
+		void StartPhase( G4String name );
+		void StopPhase( G4String name );
+
+		void BeginEvent();
+		void EndEvent( G4int eventID );
+
+		void SetStepStatistics( G4bool val ) { stepStatistics = val; };
+		G4bool GetStepStatistics() { return stepStatistics; };
+		void AddStep( G4int particleNameID, G4int componentID );
+
+		//	Most events held in the event list at once, and the memory
+		//	that took (bytes)
+		void SetEventListPeak( G4int events, G4double memory )
+			{ eventListPeakEvents = events; eventListPeakMemory = memory; };
+
+		G4String GetSummary();
+
+	private:
+		struct phase {
+			G4String name;
+			G4double startTime;
+			G4double totalTime;
+			G4int calls;
+		};
+
+		struct eventTime {
+			G4int eventID;
+			G4double time;
+		};
+
+		struct stepCounter {
+			long long steps;
+			G4double time;
+		};
+
+		phase *FindPhase( G4String name );
+		void CountStep( std::vector<stepCounter> &counters, G4int index,
+				G4double time );
+
+	private:
+		G4bool stepStatistics;
+
+		std::vector<phase> phases;
+
+		G4int eventListPeakEvents;
+		G4double eventListPeakMemory;
+
+		//	Per-event wall times, and the slowest events of the run
+		G4double eventStartTime;
+		G4int numTimedEvents;
+		G4double totalEventTime;
+		G4double minEventTime;
+		G4double maxEventTime;
+		std::vector<eventTime> slowestEvents;
+
+		//	Steps by particle name ID (as in the manager's step name table)
+		//	and by detector component ID. Component ID 0 is used for steps
+		//	outside any detector component.
+		G4double lastStepTime;
+		std::vector<stepCounter> particleSteps;
+		std::vector<stepCounter> componentSteps;
+};
+
+#endif
@@ -0,0 +1,517 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimFieldMap.cc
+*
+* This is the code file for the XYZ-dependent field maps. See the header for a
+* description of the maps and their binary cache.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Added the R-z table layout, and the number of values per grid
+*				  point, the layout and the scale to the cache header. The
+*				  field is converted with volt/m rather than a bare 1e9. (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//
+//	LUXSim includes
+//
+#include "LUXSimFieldMap.hh"
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+//	Layout of the binary cache: this header, then numValues floats per grid
+//	point, then one status byte per grid point. The size and modification time
+//	of the text file are stored so that a stale cache is never used.
+struct fieldMapCacheHeader {
+	G4int magic;
+	G4int version;
+	G4int numPlanes[3];
+	G4int numValues;
+	G4int layout;
+	G4int padding;
+	G4double minLocation[3];
+	G4double stepSize[3];
+	G4double valueScale;
+	long long textSize;
+	long long textTime;
+};
+
+static const G4int kCacheMagic = 0x4C464D50;
+static const G4int kCacheVersion = 2;
+
+//	Grid point status bytes. The fiducial flag in the text file is 1 inside
+//	the fiducial region and 0 outside it; grid points missing from the file
+//	(or with any other flag) are kept apart because the electric field only
+//	rejects the explicit 0 flag.
+static const unsigned char kStatusOutside = 0;
+static const unsigned char kStatusInside = 1;
+static const unsigned char kStatusOther = 2;
+
+const G4double LUXSimFieldMap::kOutsideValue = -100000.;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LUXSimFieldMap()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimFieldMap::LUXSimFieldMap()
+{
+	layout = kCOMSOLLayout;
+	numValues = kNumValues;
+	valueScale = 1.;
+	for( G4int i=0; i<3; i++ ) {
+		numPlanes[i] = 0;
+		minLocation[i] = 0;
+		stepSize[i] = 1.;
+	}
+	numNodes = 0;
+
+	nodeValues = NULL;
+	nodeStatus = NULL;
+	mappedCache = NULL;
+	mappedSize = 0;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					~LUXSimFieldMap()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimFieldMap::~LUXSimFieldMap()
+{
+	Clear();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetGrid()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::SetGrid( G4int nx, G4int ny, G4int nz,
+		G4ThreeVector minLoc, G4ThreeVector step )
+{
+	SetPlanes( kCOMSOLLayout, kNumValues, nx, ny, nz, minLoc, step, 1. );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetRZGrid()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::SetRZGrid( G4int numR, G4int numZ, G4double minR,
+		G4double minZ, G4double step, G4double scale )
+{
+	SetPlanes( kRZTableLayout, 1, numR, 1, numZ,
+			G4ThreeVector(minR, 0, minZ), G4ThreeVector(step, 1., step),
+			scale );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetPlanes()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::SetPlanes( G4int newLayout, G4int values, G4int nx,
+		G4int ny, G4int nz, G4ThreeVector minLoc, G4ThreeVector step,
+		G4double scale )
+{
+	if( newLayout == layout && values == numValues && scale == valueScale &&
+			nx == numPlanes[0] && ny == numPlanes[1] && nz == numPlanes[2] &&
+			minLoc == G4ThreeVector(minLocation[0], minLocation[1],
+			minLocation[2]) &&
+			step == G4ThreeVector(stepSize[0], stepSize[1], stepSize[2]) )
+		return;
+
+	//	A new grid invalidates whatever was loaded on the old one
+	Clear();
+
+	layout = newLayout;
+	numValues = values;
+	valueScale = scale;
+	numPlanes[0] = nx;
+	numPlanes[1] = ny;
+	numPlanes[2] = nz;
+	for( G4int i=0; i<3; i++ ) {
+		minLocation[i] = minLoc[i];
+		stepSize[i] = step[i];
+	}
+	numNodes = nx*ny*nz;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Clear()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::Clear()
+{
+	if( mappedCache )
+		munmap( mappedCache, mappedSize );
+	mappedCache = NULL;
+	mappedSize = 0;
+
+	std::vector<float>().swap( valueStorage );
+	std::vector<unsigned char>().swap( statusStorage );
+
+	nodeValues = NULL;
+	nodeStatus = NULL;
+	loadedFile = "";
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Load()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::Load( G4String fileName, G4String cacheDir )
+{
+	//	The map is only read once per file, no matter how often this is called
+	if( IsLoaded() && fileName == loadedFile )
+		return;
+
+	Clear();
+
+	if( numNodes <= 0 ) {
+		G4cout << G4endl << G4endl << G4endl;
+		G4cout << "The field map grid has not been set!" << G4endl;
+		G4cout << G4endl << G4endl << G4endl;
+		exit(0);
+	}
+
+	//	The cache is named after the text file, without its directory
+	G4String cacheName = fileName;
+	size_t slash = cacheName.rfind( '/' );
+	if( slash != std::string::npos )
+		cacheName = cacheName.substr( slash+1 );
+	if( cacheDir.length() && cacheDir[cacheDir.length()-1] != '/' )
+		cacheDir += "/";
+	cacheName = cacheDir + cacheName + ".cache";
+
+	if( !ReadCache( cacheName, fileName ) ) {
+		if( layout == kRZTableLayout )
+			ReadRZTable( fileName );
+		else
+			ReadText( fileName );
+		WriteCache( cacheName, fileName );
+	}
+
+	loadedFile = fileName;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadCache()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimFieldMap::ReadCache( G4String cacheName, G4String textName )
+{
+	struct stat textStat, cacheStat;
+	G4bool haveText = ( stat( textName.c_str(), &textStat ) == 0 );
+
+	G4int fd = open( cacheName.c_str(), O_RDONLY );
+	if( fd < 0 )
+		return false;
+
+	size_t expectedSize = sizeof(fieldMapCacheHeader) +
+			(size_t)numNodes*numValues*sizeof(float) + (size_t)numNodes;
+	if( fstat( fd, &cacheStat ) != 0 ||
+			(size_t)cacheStat.st_size != expectedSize ) {
+		close( fd );
+		return false;
+	}
+
+	void *mapped = mmap( NULL, expectedSize, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( mapped == MAP_FAILED )
+		return false;
+
+	//	The cache has to be on the same grid, and if the text file is still
+	//	around, made from the current version of it
+	const fieldMapCacheHeader *header = (const fieldMapCacheHeader*)mapped;
+	G4bool valid = ( header->magic == kCacheMagic &&
+			header->version == kCacheVersion &&
+			header->layout == layout && header->numValues == numValues &&
+			header->valueScale == valueScale );
+	for( G4int i=0; i<3 && valid; i++ )
+		valid = ( header->numPlanes[i] == numPlanes[i] &&
+				header->minLocation[i] == minLocation[i] &&
+				header->stepSize[i] == stepSize[i] );
+	if( valid && haveText )
+		valid = ( header->textSize == (long long)textStat.st_size &&
+				header->textTime == (long long)textStat.st_mtime );
+
+	if( !valid ) {
+		munmap( mapped, expectedSize );
+		return false;
+	}
+
+	mappedCache = mapped;
+	mappedSize = expectedSize;
+	nodeValues = (const float*)((const char*)mapped +
+			sizeof(fieldMapCacheHeader));
+	nodeStatus = (const unsigned char*)(nodeValues + numNodes*numValues);
+
+	G4cout << "Mapped the field map cache " << cacheName << G4endl;
+
+	return true;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadText()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::ReadText( G4String textName )
+{
+	G4cout << G4endl << G4endl << G4endl;
+	G4cout << "Load Efieldfile!" << G4endl;
+	G4cout << G4endl << G4endl << G4endl;
+
+	std::ifstream gridFile;
+	gridFile.open( textName.c_str() );
+	if( !gridFile.is_open() ) {
+		G4cout << G4endl << G4endl << G4endl;
+		G4cout << "E-Field File Not Found!" << G4endl;
+		G4cout << G4endl << G4endl << G4endl;
+		exit(0);
+	}
+
+	//	Grid points missing from the file are flagged so that they are never
+	//	interpolated into the drift time or S2 position
+	valueStorage.assign( numNodes*kNumValues, (float)kOutsideValue );
+	statusStorage.assign( numNodes, kStatusOther );
+	for( G4int node=0; node<numNodes; node++ )
+		valueStorage[node*kNumValues+kEField] = -1.*kOutsideValue*volt/m;
+
+	//	The first line is a header
+	std::string sLine;
+	getline( gridFile, sLine );
+
+	//	Each line has eight values: x, y, z (cm), E (V/m), S2 x, S2 y (cm),
+	//	drift time (us) and the fiducial flag. A "nan" keeps the value from the
+	//	line before.
+	const G4int numVars = 8;
+	G4double tempArray[numVars] = { 0 };
+	std::string token;
+	while( !gridFile.eof() ) {
+		for( G4int i=0; i<numVars; i++ ) {
+			gridFile >> token;
+			if( token != "nan" )
+				tempArray[i] = atof( token.c_str() );
+		}
+
+		G4int index[3];
+		G4bool onGrid = true;
+		for( G4int i=0; i<3; i++ ) {
+			index[i] = (G4int)(round( (tempArray[i]*10. - minLocation[i]) /
+					stepSize[i] ));
+			if( index[i] < 0 || index[i] >= numPlanes[i] )
+				onGrid = false;
+		}
+		if( !onGrid )
+			continue;
+
+		G4int node = (index[0]*numPlanes[1] + index[1])*numPlanes[2] +
+				index[2];
+		float *values = &valueStorage[node*kNumValues];
+		//	The field is in V/m, which volt/m turns into Geant4 units (MV/mm,
+		//	so a factor of 1e-9). The sign is flipped to match the (negative)
+		//	fields the materials are given.
+		values[kEField] = -1.*tempArray[3]*volt/m;
+		values[kS2X] = tempArray[4]*10.;		//	cm to mm
+		values[kS2Y] = tempArray[5]*10.;
+		values[kDriftTime] = tempArray[6]*1000.;	//	us to ns
+
+		if( tempArray[7] == 1 )
+			statusStorage[node] = kStatusInside;
+		else if( tempArray[7] == 0 )
+			statusStorage[node] = kStatusOutside;
+		else
+			statusStorage[node] = kStatusOther;
+	}
+	gridFile.close();
+
+	nodeValues = &valueStorage[0];
+	nodeStatus = &statusStorage[0];
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadRZTable()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::ReadRZTable( G4String textName )
+{
+	std::ifstream gridFile;
+	gridFile.open( textName.c_str() );
+	if( !gridFile.is_open() ) {
+		G4cout << G4endl << G4endl << G4endl;
+		G4cout << "Field Map File " << textName << " Not Found!" << G4endl;
+		G4cout << G4endl << G4endl << G4endl;
+		exit(0);
+	}
+
+	//	The grid has a single plane in y, so grid point (iR, 0, iz) is
+	//	iR*numPlanes[2] + iz. Points the file is too short to reach are left
+	//	outside the fiducial region.
+	valueStorage.assign( numNodes, (float)kOutsideValue );
+	statusStorage.assign( numNodes, kStatusOutside );
+	G4int numRead = 0;
+	for( G4int iz=0; iz<numPlanes[2]; iz++ )
+		for( G4int iR=0; iR<numPlanes[0]; iR++ ) {
+			G4double value;
+			if( !(gridFile >> value) )
+				continue;
+			numRead++;
+			if( value < 0 )
+				continue;
+			G4int node = iR*numPlanes[2] + iz;
+			valueStorage[node] = value*valueScale;
+			statusStorage[node] = kStatusInside;
+		}
+	gridFile.close();
+
+	if( numRead < numNodes )
+		G4cout << "Warning: " << textName << " has " << numRead << " of the "
+			   << numNodes << " values of its grid" << G4endl;
+
+	nodeValues = &valueStorage[0];
+	nodeStatus = &statusStorage[0];
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					WriteCache()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimFieldMap::WriteCache( G4String cacheName, G4String textName )
+{
+	fieldMapCacheHeader header;
+	header.magic = kCacheMagic;
+	header.version = kCacheVersion;
+	header.numValues = numValues;
+	header.layout = layout;
+	header.padding = 0;
+	header.valueScale = valueScale;
+	for( G4int i=0; i<3; i++ ) {
+		header.numPlanes[i] = numPlanes[i];
+		header.minLocation[i] = minLocation[i];
+		header.stepSize[i] = stepSize[i];
+	}
+	header.textSize = 0;
+	header.textTime = 0;
+
+	struct stat textStat;
+	if( stat( textName.c_str(), &textStat ) == 0 ) {
+		header.textSize = (long long)textStat.st_size;
+		header.textTime = (long long)textStat.st_mtime;
+	}
+
+	//	Write to a temporary file and rename it, so that jobs starting at the
+	//	same time never map a half-written cache
+	char pidString[32];
+	sprintf( pidString, ".%d", (G4int)getpid() );
+	G4String tmpName = cacheName + pidString;
+
+	std::ofstream cacheFile( tmpName.c_str(), std::ios::binary|std::ios::out );
+	if( !cacheFile.is_open() ) {
+		G4cout << "WARNING: could not write the field map cache " << cacheName
+			   << ", so " << textName << " will be read again next time"
+			   << G4endl;
+		return;
+	}
+	cacheFile.write( (char*)(&header), sizeof(header) );
+	cacheFile.write( (char*)nodeValues, numNodes*numValues*sizeof(float) );
+	cacheFile.write( (char*)nodeStatus, numNodes );
+	cacheFile.close();
+
+	if( !cacheFile.good() || rename( tmpName.c_str(), cacheName.c_str() ) ) {
+		G4cout << "WARNING: could not write the field map cache " << cacheName
+			   << ", so " << textName << " will be read again next time"
+			   << G4endl;
+		remove( tmpName.c_str() );
+		return;
+	}
+
+	if( DEBUGGING )
+		G4cout << "Wrote the field map cache " << cacheName << G4endl;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Interpolate()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimFieldMap::Interpolate( const G4ThreeVector &x, G4double *values )
+{
+	for( G4int v=0; v<numValues; v++ )
+		values[v] = kOutsideValue;
+
+	if( !nodeValues )
+		return false;
+
+	//	An R-z table is looked up at the radius of the point
+	G4double position[3] = { x[0], x[1], x[2] };
+	if( layout == kRZTableLayout ) {
+		position[0] = sqrt( x[0]*x[0] + x[1]*x[1] );
+		position[1] = minLocation[1];
+	}
+
+	//	Find the cell containing the point and the fractional position in it.
+	//	Points off the grid (not in the liquid) get the outside value. An axis
+	//	with a single plane has no second corner along it.
+	G4int index[3], numCorners[3];
+	G4double frac[3];
+	for( G4int i=0; i<3; i++ ) {
+		if( numPlanes[i] == 1 ) {
+			index[i] = 0;
+			frac[i] = 0;
+			numCorners[i] = 1;
+			continue;
+		}
+		G4double u = (position[i] - minLocation[i])/stepSize[i];
+		index[i] = (G4int)u;
+		if( index[i] < 0 || index[i] > numPlanes[i]-2 )
+			return false;
+		frac[i] = u - index[i];
+		if( frac[i] < 0 )
+			frac[i] = 0;
+		numCorners[i] = 2;
+	}
+
+	G4int corner[8];
+	G4double weight[8];
+	G4int n = 0;
+	for( G4int i=0; i<numCorners[0]; i++ )
+		for( G4int j=0; j<numCorners[1]; j++ )
+			for( G4int k=0; k<numCorners[2]; k++ ) {
+				corner[n] = ((index[0]+i)*numPlanes[1] + (index[1]+j)) *
+						numPlanes[2] + (index[2]+k);
+				weight[n] = (i ? frac[0] : 1.-frac[0]) *
+						(j ? frac[1] : 1.-frac[1]) *
+						(k ? frac[2] : 1.-frac[2]);
+				n++;
+			}
+
+	//	The electric field (or the value of an R-z table) is only rejected
+	//	next to grid points explicitly outside the fiducial region; the drift
+	//	time and S2 position need all the corners inside it
+	G4bool fieldValid = true, driftValid = true;
+	for( G4int c=0; c<n; c++ ) {
+		if( nodeStatus[corner[c]] == kStatusOutside )
+			fieldValid = false;
+		if( nodeStatus[corner[c]] != kStatusInside )
+			driftValid = false;
+	}
+	if( !fieldValid )
+		return false;
+
+	//	The values sit next to each other for every grid point, so this is
+	//	one short multiply-add per corner
+	G4double sum[kNumValues] = { 0, 0, 0, 0 };
+	for( G4int c=0; c<n; c++ ) {
+		const float *nodeValue = nodeValues + corner[c]*numValues;
+		for( G4int v=0; v<numValues; v++ )
+			sum[v] += weight[c]*nodeValue[v];
+	}
+
+	values[kEField] = sum[kEField];
+	if( driftValid )
+		for( G4int v=1; v<numValues; v++ )
+			values[v] = sum[v];
+
+	return true;
+}
@@ -174,6 +174,57 @@
 *               (David W)
 *   28-Sep-15 - The manager now supports the code being in an SVN or Git repo
 *               (or no version control) (Kareem)
+*   17-Oct-26 - RecordValues tells LUXSimOutput when an event is complete so
+*               that buffered records can be written out in blocks (agent)
+*   17-Oct-26 - Added the per-run table of interned particle and process names
+*               used by the step records (agent)
+*   17-Oct-26 - Added FindComponent, which uses the component IDs assigned at
+*               BeamOn to resolve a volume to its detector component without
+*               scanning the component list. The record level, deposition and
+*               photon capture lookups all go through it. (agent)
+*   17-Oct-26 - BeamOn flags the liquid xenon target components of the selected
+*               detector, so the stepping action doesn't compare volume names
+*               (agent)
+*   17-Oct-26 - Added SeedEvent, which reseeds the engine from the run seed and
+*               the event number so that events are reproducible on their own
+*               (agent)
+*   17-Oct-26 - A job can be split into shards with /LUXSim/randomFirstEvent.
+*               The event seeds and recorded event numbers count from the
+*               first event, the event list is seeded from the run seed and
+*               built for the whole job, and the events before the first one
+*               are skipped (agent)
+*   17-Oct-26 - Components with a record level get their event record buffer
+*               pre-sized at BeamOn (agent)
+*   17-Oct-26 - The events file generator reads its deposits through
+*               LUXSimEventsFile, which indexes them by event and maps binary
+*               events files instead of parsing them (agent)
+*   17-Oct-26 - The event list no longer pre-builds a deep binary search tree.
+*               The record keeps the earliest numEvents decays as they are
+*               generated, so GenerateEventList doesn't trim it afterwards.
+*               (agent)
+*   17-Oct-26 - The XYZ-dependent electric field, drift time and S2 position
+*               now come from LUXSimFieldMap, which interpolates all of them in
+*               one call. The drift time and radial drift tables are
+*               LUXSimFieldMaps too, rather than fixed arrays interpolated here.
+*               (agent)
+*   17-Oct-26 - Added the run statistics. The geometry build, event list, event
+*               loop and output writing are timed, and the summary is printed
+*               at the end of every run. (agent)
+*   17-Oct-26 - Added the FastSim library and connections files, which the fast
+*               sims read on first use, and CompileFastSimLibrary (agent)
+*   17-Oct-26 - BeamOn builds the acceptance grid of every component that has
+*               a source, sized for its share of the run's events (agent)
+*   17-Oct-26 - Component volumes are calculated on one thread unless
+*               /LUXSim/detector/volumeThreads says otherwise (agent)
+*   17-Oct-26 - The volume cache is off by default (agent)
+*   17-Oct-26 - Added GetEventListCutoff, so that sources can stop generating
+*               events that could never make it into the event list (agent)
+*   17-Oct-26 - With streamEvents set, the sources other than decay chains
+*               become event streams, and their events are made one at a time
+*               in GenerateEvent instead of all before the run, dropping a
+*               stream once the record turns its event away (agent)
+*   17-Oct-26 - The event list is freed at the end of BeamOn, and its peak
+*               size goes in the run statistics (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -184,6 +235,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <vector>
+#include <algorithm>
 
 //
 //	CLHEP includes
@@ -199,6 +251,8 @@
 #include "G4UImanager.hh"
 #include "G4GeneralParticleSource.hh"
 #include "G4Event.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
 #include "globals.hh"
 
 //
@@ -217,10 +271,14 @@
 #include "LUXSimSourceCatalog.hh"
 #include "LUXSimSource.hh"
 #include "LUXSimBST.hh"
+#include "LUXSimFieldMap.hh"
+#include "LUXSimRunStatistics.hh"
+#include "LUXSimEventsFile.hh"
 #include "LUXSimMessenger.hh"
 #include "LUXSimStand.hh"
 #include "LUXSimLZFlex.hh"
 #include "G4S1Light.hh"
+#include "LUXSimFastSim.hh"
 
 using namespace std;
 using namespace CLHEP;
@@ -277,10 +335,20 @@ LUXSimManager::LUXSimManager()
 	
 	alwaysRecordPrimary = true;
     eventProgressFrequency = 100000;
+    outputBufferSize = 4194304;
+    outputFlushFrequency = 0;
+    outputFormat = 1;
+    perEventSeeds = false;
+    randomFirstEvent = 0;
+    runStatistics = new LUXSimRunStatistics();
+    recordRunStatistics = false;
+    runStatisticsSummary = "";
 
     hasLUXSimSources = false;
     isEventListBuilt = false;
     printEventList = false;
+    eventListEvents = 0;
+    streamEvents = false;
     hasDecayChainSources = false;
     windowEnd = 0.;
     
@@ -290,6 +358,8 @@ LUXSimManager::LUXSimManager()
 	//detectorSelection = "1_0Detector";
 	detectorSelection = "";
     checkVolumeOverlaps = false;
+    volumeCacheFile = "";
+    volumeThreads = 1;
 	muonVetoSelection = "off";
 	LZVetoSelection = "off";
 	cryoStandSelection = "off";
@@ -347,16 +417,40 @@ LUXSimManager::LUXSimManager()
     RadialDriftFromFile = false; // default to calculating e-field from voltages
     RadialDriftFile = "physicslist/src/RadialDriftFile.dat"; // default to calculating e-field from voltages
 
+    xyzDependentFieldMap = new LUXSimFieldMap();
+    xyzDependentFieldMap->SetGrid( NumPlanesX, NumPlanesY, NumPlanesZ,
+            G4ThreeVector(MinLocationX, MinLocationY, MinLocationZ),
+            G4ThreeVector(StepSizeX, StepSizeY, StepSizeZ) );
+    //  The drift time (us) and radial drift (cm) tables have 251 R by 598 z
+    //  grid points, 1 mm apart from R = z = 0
+    xyzDependentDriftTimeMap = new LUXSimFieldMap();
+    xyzDependentDriftTimeMap->SetRZGrid( 251, 598, 0, 0, 1.*mm, 1000. );
+    xyzDependentRadialDriftMap = new LUXSimFieldMap();
+    xyzDependentRadialDriftMap->SetRZGrid( 251, 598, 0, 0, 1.*mm, 10. );
+
     luxDoublePheRateFromFile = true;
 
     luxFastSimSkewGaussianS2 = false;
+    fastSimLibrary = "physicslist/src/fastSimLibrary_fromKr_V04.dat";
+    fastSimConnections = "physicslist/src/fastSimConnections_fromKr_V04.dat";
+    fastSimLibraryChanges = 0;
 
     s1gain = 1;
     s2gain = 1;
+    parametrizedS2 = false;
+    parametrizedS2Efficiency = 0.1;
 	
 	driftElecAttenuation = 1.*m;
 
      currentEvtN = -1;
+    eventsFileReader = new LUXSimEventsFile();
+    eventsFileFirstEvent = 0;
+    nextEventsFileEvent = 0;
+    currentDeposits = NULL;
+    currentNumDeposits = 0;
+    nextParticleIDDeposit = 0;
+    nextEnergyDepDeposit = 0;
+    nextPositionDeposit = 0;
 	
 	LUXSimDetector = NULL;
 }
@@ -368,6 +462,11 @@ LUXSimManager::~LUXSimManager()
 {
 	if ( LUXSimOut ) delete LUXSimOut;
 	if ( LUXSimSourceCat ) delete LUXSimSourceCat;
+	delete xyzDependentFieldMap;
+	delete xyzDependentDriftTimeMap;
+	delete xyzDependentRadialDriftMap;
+	delete runStatistics;
+	delete eventsFileReader;
 	
 	stringstream rmCommand;
 	rmCommand << "rm -rf " << historyFile;
@@ -467,9 +566,11 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
         PrintElectricFields();
     }
     
-	// Create new LUXSimOutput object
+	// Create new LUXSimOutput object. The step name table is reset first, so
+	// that the IDs recorded in this run's output start from scratch.
 	if (LUXSimOut)
 		delete LUXSimOut;
+	ResetStepNameTable();
 	new LUXSimOutput();
 
 	//	Print info to the screen, and assign volume IDs
@@ -477,6 +578,25 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
 		
 		luxSimComponents[i]->SetID( i+1 );
 		
+		//	Give the recording volumes a head start on their record buffers,
+		//	which then keep their capacity for the rest of the run
+		if( luxSimComponents[i]->GetRecordLevel() ||
+				luxSimComponents[i]->GetRecordLevelOptPhot() ||
+				luxSimComponents[i]->GetRecordLevelThermElec() )
+			luxSimComponents[i]->ReserveRecord( 1024 );
+		
+		//	Flag the volumes whose energy counts toward the upper energy cut
+		G4String volName = luxSimComponents[i]->GetName();
+		luxSimComponents[i]->SetLiquidXenonTarget(
+				( detectorSelection == "1_0Detector" &&
+				  volName == "LiquidXenon" ) ||
+				( detectorSelection == "LZDetector" &&
+				  ( volName == "LiquidXenonTarget" ||
+					volName == "InnerLiquidXenon" ) ) ||
+				( detectorSelection == "LZSimple" &&
+				  ( volName == "ActiveLiquidXenon" ||
+					volName == "LiquidGammaXXenon" ) ) );
+		
 		G4cout << "Volume \"" <<  luxSimComponents[i]->GetName() << "\" "
 			   << "assigned ID " << i+1
 			   << ", record level " << luxSimComponents[i]->GetRecordLevel()
@@ -515,6 +635,12 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
 		G4cout << "\tActivity ratio for "
 			   << sourceByVolume[i].component->GetName() << " = "
 			   << sourceByVolume[i].totalVolumeActivityRatio << G4endl;
+		
+		//	The event list window is about twice as long as the list needs,
+		//	so each source draws up to twice its share of the events
+		sourceByVolume[i].component->BuildAcceptanceGrid(
+				2.*GetNumEventListEvents() *
+				sourceByVolume[i].totalVolumeActivityRatio );
 	}
 	for( G4int i=1; i<(G4int)sourceByVolume.size(); i++ )
 		sourceByVolume[i].totalVolumeActivityRatio +=
@@ -596,9 +722,30 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
     // All sources are added to a binary search tree ordered by time before
     // Geant begins to "generate events"
     if( hasLUXSimSources ) {
+        runStatistics->StartPhase( "eventList" );
+        //  With per-event seeds, the event list depends only on the run seed,
+        //  and not on whatever the geometry and the volume calculations drew
+        if( perEventSeeds )
+            CLHEP::HepRandom::setTheSeed( randomSeed );
         BuildEventList();
-        GenerateEventList();
-        TrimEventList();
+        if( streamEvents ) {
+            //  Only the decay chains go in now; the rest of the events are
+            //  made as the run gets to them
+            for( G4int i=0; i<(G4int)sourceByVolume.size(); i++ )
+                if( sourceByVolume[i].component )
+                    sourceByVolume[i].component->StartEventStreams(i);
+            G4cout << "Event list started. " << eventStreams.size()
+                   << " event streams and "
+                   << recordTree->GetNumNonemptyNodes()
+                   << " decay chain events in the list."
+                   << "\n====================================================="
+                   << "================" << G4endl;
+        } else {
+            GenerateEventList();
+            TrimEventList();
+        }
+        SkipEarlierEvents();
+        runStatistics->StopPhase( "eventList" );
         if( printEventList ) PrintEventList();
     }
 
@@ -610,6 +757,14 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
 	command << "/run/beamOn " << numOfEvents;
 	UI->ApplyCommand( command.str() );
 
+	//	Give back the event list memory all at once rather than holding on to
+	//	it until the next BeamOn
+	if( recordTree ) {
+		delete recordTree;
+		recordTree = 0;
+	}
+	std::vector<eventStream>().swap( eventStreams );
+
 	//      Reset randomization seed for next beanOn
         CLHEP::HepRandom::setTheEngine( &randomizationEngine );
 
@@ -622,6 +777,23 @@ void LUXSimManager::BeamOn( G4int numOfEvents )
         CLHEP::HepRandom::setTheSeed( randomSeed );
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					EndOfRunStatistics()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::EndOfRunStatistics()
+{
+	//	The summary covers everything timed since the end of the previous run,
+	//	so a geometry built before BeamOn is charged to the run that uses it
+	if( recordTree )
+		runStatistics->SetEventListPeak( recordTree->GetPeakNumNodes(),
+				recordTree->GetPeakMemory() );
+	runStatisticsSummary = runStatistics->GetSummary();
+	runStatistics->Reset();
+
+	G4cout << G4endl << "Run statistics:" << G4endl << runStatisticsSummary
+		   << G4endl;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					SetRandomSeed()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -632,6 +804,23 @@ void LUXSimManager::SetRandomSeed( G4int seed )
 	CLHEP::HepRandom::setTheSeed( randomSeed );
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SeedEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::SeedEvent( G4int eventNum )
+{
+	//	The seed of each event depends only on the run seed and the event
+	//	number, counted from the start of the whole job (i.e., including
+	//	randomFirstEvent), and not on how many random numbers the earlier
+	//	events used. Any event can then be regenerated by itself. The seed list
+	//	is zero-terminated, hence the +1.
+	long seeds[3];
+	seeds[0] = eventNum + 1;
+	seeds[1] = randomSeed;
+	seeds[2] = 0;
+	CLHEP::HepRandom::setTheSeeds( seeds );
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					SetOutputDir()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -686,7 +875,9 @@ void LUXSimManager::UpdateGeometry()
 	//	Next, update the geometry, which wipes out all detector-component-
 	//	related info
 	luxSimComponents.clear();
+	runStatistics->StartPhase( "geometry" );
 	LUXSimDetector->UpdateGeometry();
+	runStatistics->StopPhase( "geometry" );
 	
 	// reset collimator geometry
 	if (LUXSimDetector->GetCryoStand())
@@ -824,9 +1015,8 @@ std::vector<G4int> LUXSimManager::GetRecordLevels( G4String volName )
 G4int LUXSimManager::GetComponentRecordLevel(
 		LUXSimDetectorComponent *component )
 {
-	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
-		if( luxSimComponents[i] == component )
-			return( component->GetRecordLevel() );
+	if( FindComponent( (G4VPhysicalVolume*)component ) )
+		return( component->GetRecordLevel() );
 	
 	G4cout << "Warning! Looking for a record level in the"
 		   << "\"" << ((LUXSimDetectorComponent*)component)->GetName() << "\" "
@@ -879,9 +1069,8 @@ std::vector<G4int> LUXSimManager::GetRecordLevelsOptPhot( G4String volName )
 G4int LUXSimManager::GetComponentRecordLevelOptPhot(
 		LUXSimDetectorComponent *component )
 {
-	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
-		if( luxSimComponents[i] == component )
-			return( component->GetRecordLevelOptPhot() );
+	if( FindComponent( (G4VPhysicalVolume*)component ) )
+		return( component->GetRecordLevelOptPhot() );
 	
 	G4cout << "Warning! Looking for an optical photon record level in the"
 		   << "\"" << ((LUXSimDetectorComponent*)component)->GetName() << "\" "
@@ -934,9 +1123,8 @@ std::vector<G4int> LUXSimManager::GetRecordLevelsThermElec( G4String volName )
 G4int LUXSimManager::GetComponentRecordLevelThermElec(
 		LUXSimDetectorComponent *component )
 {
-	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
-		if( luxSimComponents[i] == component )
-			return( component->GetRecordLevelThermElec() );
+	if( FindComponent( (G4VPhysicalVolume*)component ) )
+		return( component->GetRecordLevelThermElec() );
 	
 	G4cout << "Warning! Looking for a thermal electron record level in the"
 		   << "\"" << ((LUXSimDetectorComponent*)component)->GetName() << "\" "
@@ -946,6 +1134,35 @@ G4int LUXSimManager::GetComponentRecordLevelThermElec(
 	return 0;
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					FindComponent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimDetectorComponent *LUXSimManager::FindComponent(
+		G4VPhysicalVolume *physVol )
+{
+	//	Returns the registered detector component that corresponds to the
+	//	physical volume, or NULL if the volume isn't one. BeamOn gives every
+	//	component its position in luxSimComponents (plus one) as its ID, so a
+	//	single comparison against that slot confirms the registration. The
+	//	scan is only a fallback for IDs that have gone stale because a
+	//	component was deregistered since the last BeamOn.
+	LUXSimDetectorComponent *component =
+			dynamic_cast<LUXSimDetectorComponent*>( physVol );
+	if( !component )
+		return NULL;
+	
+	G4int index = component->GetID() - 1;
+	if( index >= 0 && index < (G4int)luxSimComponents.size() &&
+			luxSimComponents[index] == component )
+		return component;
+	
+	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component )
+			return component;
+	
+	return NULL;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					GetComponentByName()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2282,13 +2499,11 @@ void LUXSimManager::SetAlUnoxQuartzRefl( G4double r )
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::BuildEventList()
 {
-    // Builds a binary search tree ordered by time of the parent particle event
-    // time. Begins at 0*ns and runs to a time determined by the total activity
-    // and number of events requested. The purpose of the window width is to
-    // create empty nodes in the BST to avoid quasi-degeneracy, but we won't
-    // actually cut on the window end time when inserting events. Note that the 
-    // window end time has a 10% pad on it, just to add a bit of overhead space
-    G4int numEvts = GetNumEvents();
+    // Builds the time-ordered record of the parent particle events. The record
+    // only ever holds the earliest numEvents decays offered to it, so it needs
+    // no pre-built empty nodes. The window end time is a loose cut, set from
+    // the total activity, past which the sources stop generating candidates.
+    G4int numEvts = GetNumEventListEvents();
     G4double initialActivity = GetTotalSimulationActivity();
 
     //G4double windowStart, windowEnd; //units=seconds
@@ -2296,47 +2511,25 @@ void LUXSimManager::BuildEventList()
     windowEnd   = 1e10;
 
     G4int numVols = (G4int)sourceByVolume.size();
-    G4int recordTreeDepth = 20; 
-    // For numEvents >> 1e7 increase depth 
-    // and numVols > 1 increase depth and widen window
     if( numVols < 1 || initialActivity==0 ) {
         G4cout << "no activity registered"<<G4endl;
     }
     else {
-        if(numEvents > 100) windowEnd = 2.*numEvts/initialActivity ;
+        if(numEvts > 100) windowEnd = 2.*numEvts/initialActivity ;
         else                windowEnd = 4.*numEvts/initialActivity ;
-       // if(numEvents > 1000)    windowEnd = 1.1*numEvts*numVols/initialActivity;
-       // else if(numEvents > 50) windowEnd = 2.*numEvts*numVols/initialActivity ;
-       // else                    windowEnd = 4.*numEvts*numVols/initialActivity ;
     }
-    // The initialization levels(depth) created in the BST is defaulted to 20.
-    // These levels contain empty nodes to subdivide the space to reduce
-    // degeneracy of the BST. The number of nodes is 2^level-1 so be careful
-    // about using many levels (i.e., 10 level will create 1023 empty nodes).
-    // By experience 20 is reasonable for O(1e7) events. The number of events
-    // added to the BST is trickier when multiple sources in multiple volumes
-    // are requested. When using "PMT_Window" or similar each volume creates
-    // numEvent of entries. 
-
-    if( numEvts > 2.e6 ) {
-        G4int npower = 1;
-        while( numEvts/(2.e6*pow(2.,npower)) > 1. && recordTreeDepth < 25) { 
-            npower++;
-            recordTreeDepth++;
-        }
-    } 
-    if( hasDecayChainSources ) recordTreeDepth++ ;//10-14 more decays/activity
 
     G4cout << "\n============================================================="
            << "========" << G4endl;
-    G4cout << "Building binary search tree (BST) with depth " 
-           << recordTreeDepth << G4endl; 
-    G4cout << "  The BST time window runs from " << windowStart << " to " 
-           << windowEnd << " s" << G4endl;
+    G4cout << "Building event list of the earliest " << numEvts << " events"
+           << G4endl;
+    G4cout << "  The event list time window runs from " << windowStart
+           << " to " << windowEnd << " s" << G4endl;
 
     if( recordTree )
         delete recordTree;
-    recordTree = new LUXSimBST(recordTreeDepth, windowStart, windowEnd, numEvts);
+    recordTree = new LUXSimBST(numEvts, streamEvents);
+    eventStreams.clear();
 
 }
 
@@ -2350,10 +2543,6 @@ void LUXSimManager::GenerateEventList()
     for( G4int i=0; i<(G4int)sourceByVolume.size(); i++ ) 
         if( sourceByVolume[i].component ) 
             sourceByVolume[i].component->GenerateEventList(i);
-
-    // Do this every so often, because PMT_Window has between 122-142 volumes!
-    // Same as TrimEventList(); but with out terminating "======..."
-    while( recordTree->GetNumNonemptyNodes()>numEvents ) recordTree->PopLast();
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2361,32 +2550,35 @@ void LUXSimManager::GenerateEventList()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::LoadEventsFile(G4String eventsFile)
 {
-    std::ifstream file;
-    file.open(eventsFile);
-    if (!file.is_open()) {
-        G4cout<<G4endl<<G4endl<<G4endl;
-        G4cout<<"Events File Not Found!"<<G4endl;
-        G4cout<<G4endl<<G4endl<<G4endl;
-        exit(0);
-    }
-    G4int evtN;
-    G4int particleID;
-    G4double energyDep_keV;
-    G4double positionX_cm;
-    G4double positionY_cm;
-    G4double positionZ_cm;
-    while( 1 ) {
-        file >> evtN >> particleID >> energyDep_keV >> positionX_cm >> positionY_cm >> positionZ_cm;
-        if( file.fail() ) {
-             break;
-        }
-        qEvtN.push(evtN);
-        qParticleID.push(particleID);
-        qEnergyDep_keV.push(energyDep_keV*keV);
-        qPositionX_cm.push(positionX_cm*cm);
-        qPositionY_cm.push(positionY_cm*cm);
-        qPositionZ_cm.push(positionZ_cm*cm);
-    }
+    //  Text files are parsed once into an indexed table, and binary files
+    //  (from tools/LUXSimEventsFileConverter) are mapped straight in
+    eventsFileReader->Open(eventsFile);
+    nextEventsFileEvent = eventsFileFirstEvent;
+    currentNumDeposits = 0;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SetEventsFileFirstEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::SetEventsFileFirstEvent( G4int firstEvent )
+{
+    //  Events are counted from the start of the file, regardless of the event
+    //  numbers written in it, so that a job can be split into shards
+    eventsFileFirstEvent = firstEvent;
+    nextEventsFileEvent = firstEvent;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CompileFastSimLibrary()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::CompileFastSimLibrary( G4String imageFile )
+{
+    //  This loads its own copy of the library, so it doesn't matter whether
+    //  the fast sims have been used yet. Pointing /LUXSim/detector/
+    //  fastSimLibrary at the image afterwards skips the parsing and the
+    //  triangle search in every later job.
+    FastSim compiler( fastSimLibrary.c_str(), fastSimConnections.c_str() );
+    compiler.WriteImage( imageFile );
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2396,24 +2588,22 @@ void LUXSimManager::LoadEventsFile(G4String eventsFile)
 G4int LUXSimManager::NextEventToGenerate()
 {
 
-    currentEvtN = qEvtN.front();
-    while ( qEvtN.front() == currentEvtN && 
-          !qEvtN.empty() ) {
-        qEvtN.pop();
-        currentParticleID.push(qParticleID.front());
-        qParticleID.pop();
-        currentEnergyDep_keV.push(qEnergyDep_keV.front());
-        qEnergyDep_keV.pop();
-        currentX_cm.push(qPositionX_cm.front());
-        qPositionX_cm.pop();
-        currentY_cm.push(qPositionY_cm.front());
-        qPositionY_cm.pop();
-        currentZ_cm.push(qPositionZ_cm.front());
-        qPositionZ_cm.pop();
-        
-    }
+    currentDeposits = eventsFileReader->GetEvent(nextEventsFileEvent,
+            currentNumDeposits);
+    if( !currentDeposits ) {
+        G4cout << "WARNING: the events file has no event "
+               << nextEventsFileEvent << ". Nothing will be generated."
+               << G4endl;
+        currentNumDeposits = 0;
+    } else
+        currentEvtN = currentDeposits[0].eventNumber;
+    nextEventsFileEvent++;
+
+    nextParticleIDDeposit = 0;
+    nextEnergyDepDeposit = 0;
+    nextPositionDeposit = 0;
 
-    return currentParticleID.size();
+    return currentNumDeposits;
 
 }
 
@@ -2424,9 +2614,7 @@ G4int LUXSimManager::NextEventToGenerate()
 G4int LUXSimManager::NextParticleIDToGenerate()
 {
 
-    G4int partilceID = currentParticleID.front();
-    currentParticleID.pop();
-    return partilceID;
+    return currentDeposits[nextParticleIDDeposit++].particleID;
 
 }
 
@@ -2437,9 +2625,7 @@ G4int LUXSimManager::NextParticleIDToGenerate()
 G4double LUXSimManager::NextEnergyDepToGenerate()
 {
 
-    G4double energyDep = currentEnergyDep_keV.front();
-    currentEnergyDep_keV.pop();
-    return energyDep;
+    return currentDeposits[nextEnergyDepDeposit++].energy_keV*keV;
 
 }
 
@@ -2450,14 +2636,8 @@ G4double LUXSimManager::NextEnergyDepToGenerate()
 G4ThreeVector LUXSimManager::NextPositionToGenerate()
 {
 
-    G4ThreeVector pos;
-    pos[0] = currentX_cm.front();
-    currentX_cm.pop();
-    pos[1] = currentY_cm.front();
-    currentY_cm.pop();
-    pos[2] = currentZ_cm.front();
-    currentZ_cm.pop();
-    return pos;
+    const G4double *pos = currentDeposits[nextPositionDeposit++].position_cm;
+    return G4ThreeVector(pos[0]*cm, pos[1]*cm, pos[2]*cm);
 
 }
 
@@ -2466,16 +2646,58 @@ G4ThreeVector LUXSimManager::NextPositionToGenerate()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::TrimEventList()
 {
-    // At the end of this process there will be more events in the decay record
-    // than requested, so the excess can be reduced.
-    G4cout << "Reducing the number of events in the tree to " << numEvents
-           << "..." ;
-    while( recordTree->GetNumNonemptyNodes()>numEvents ) recordTree->PopLast();
-    G4cout << "Done. " << recordTree->GetNumNonemptyNodes() <<" events remain."
+    // The decay record never holds more than numEvents events, since later
+    // candidates are rejected as they are inserted. This is just a safeguard.
+    while( recordTree->GetNumNonemptyNodes()>GetNumEventListEvents() )
+        recordTree->PopLast();
+    G4cout << "Event list done. " << recordTree->GetNumNonemptyNodes()
+           << " events in the list."
            << "\n============================================================="
            << "========" << G4endl;
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetNumEventListEvents()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4int LUXSimManager::GetNumEventListEvents()
+{
+    // The list has to reach the last event of this process. The shards of a
+    // split job only make the same list if they are all given the size of the
+    // whole job with /LUXSim/source/eventListEvents, since how many events
+    // the list is built for changes the time window and the random numbers
+    // used for each event.
+    G4int numEvts = randomFirstEvent + numEvents;
+    if( eventListEvents > numEvts )
+        numEvts = eventListEvents;
+    return numEvts;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					SkipEarlierEvents()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::SkipEarlierEvents()
+{
+    // A process that starts at randomFirstEvent takes the events before it off
+    // the list the same way GenerateEvent would have, including the streamed
+    // events made along the way and the seeds they were made with
+    for( G4int i=0; i<randomFirstEvent; i++ ) {
+        if( perEventSeeds )
+            SeedEvent( i );
+        if( streamEvents )
+            AdvanceEventStreams();
+
+        decayNode *firstNode = recordTree->GetEarliest();
+        while( firstNode && !firstNode->Z ) {
+            recordTree->PopEarliest();
+            if( streamEvents ) AdvanceEventStreams();
+            firstNode = recordTree->GetEarliest();
+        }
+        if( !firstNode )
+            return;
+        recordTree->PopEarliest();
+    }
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					RecordTreeInsert()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2487,19 +2709,116 @@ void LUXSimManager::RecordTreeInsert(Isotope *iso, G4double t, G4ThreeVector p,
         recordTree->Insert(iso, t, p, sourceByVolumeID, sourcesID);
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetEventListCutoff()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4double LUXSimManager::GetEventListCutoff()
+{
+    // Time in ns at and after which RecordTreeInsert turns events away, either
+    // because they are past the time window, or because the list already
+    // holds numEvents earlier ones. It only ever moves earlier while the list
+    // is being built.
+    G4double cutoff = windowEnd*1.e9;
+    if( recordTree && recordTree->GetCutoffTime() < cutoff )
+        cutoff = recordTree->GetCutoffTime();
+    return cutoff;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					StreamLater()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimManager::StreamLater( const eventStream &a, const eventStream &b )
+{
+    //  Puts the stream with the earliest next event on top of the heap
+    return a.nextTime > b.nextTime;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					AddEventStream()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::AddEventStream( G4int sourceByVolumeID, G4int sourcesID,
+        G4double rate )
+{
+    // Rate in Bq. Only the time of the stream's first event is drawn here.
+    if( rate <= 0 )
+        return;
+
+    eventStream newStream;
+    newStream.sourceByVolumeID = sourceByVolumeID;
+    newStream.sourcesID = sourcesID;
+    newStream.rate = rate;
+    newStream.nextTime = CLHEP::RandExponential::shoot( 1./rate )*1.e9;
+    eventStreams.push_back( newStream );
+    std::push_heap( eventStreams.begin(), eventStreams.end(), StreamLater );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					AdvanceEventStreams()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::AdvanceEventStreams()
+{
+    // Makes the events of the streams, earliest first, until the earliest
+    // event in the record comes before every stream's next event. Streams
+    // that run past the window end are dropped, as are streams with no
+    // component and streams whose event the record turned away, since
+    // drawing more times for them would never add anything.
+    while( eventStreams.size() ) {
+        eventStream &next = eventStreams.front();
+        decayNode *earliest = recordTree->GetEarliest();
+        if( earliest && earliest->timeOfEvent <= next.nextTime )
+            return;
+
+        std::pop_heap( eventStreams.begin(), eventStreams.end(), StreamLater );
+        eventStream &stream = eventStreams.back();
+        if( stream.nextTime >= windowEnd*1.e9 ) {
+            eventStreams.pop_back();
+            continue;
+        }
+
+        LUXSimDetectorComponent *component =
+                sourceByVolume[stream.sourceByVolumeID].component;
+        if( !component ) {
+            eventStreams.pop_back();
+            continue;
+        }
+        G4int numNodes = recordTree->GetNumNonemptyNodes();
+        component->GenerateStreamEvent( stream.sourceByVolumeID,
+                stream.sourcesID, stream.nextTime*ns );
+        if( recordTree->GetNumNonemptyNodes() == numNodes ) {
+            eventStreams.pop_back();
+            continue;
+        }
+
+        stream.nextTime +=
+                CLHEP::RandExponential::shoot( 1./stream.rate )*1.e9;
+        std::push_heap( eventStreams.begin(), eventStreams.end(), StreamLater );
+    }
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					GenerateEvent()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::GenerateEvent( G4GeneralParticleSource *particleGun,
         G4Event *event )
 {
-    if( hasLUXSimSources && recordTree->GetNumNonemptyNodes()>0 ) {
+    if( hasLUXSimSources && recordTree && streamEvents )
+        AdvanceEventStreams();
+
+    if( hasLUXSimSources && recordTree &&
+            recordTree->GetNumNonemptyNodes()>0 ) {
         decayNode* firstNode;
         G4bool searchingNodes = true;
         while(searchingNodes){
             firstNode = recordTree->GetEarliest();
+            if( !firstNode ) {
+                G4cout << "No more events found" << G4endl;
+                return;
+            }
             if(firstNode->Z) searchingNodes = false;
-            else recordTree->PopEarliest();
+            else {
+                recordTree->PopEarliest();
+                if( streamEvents ) AdvanceEventStreams();
+            }
         }
 
         sourceByVolume[firstNode->sourceByVolumeID].component->
@@ -2517,15 +2836,83 @@ void LUXSimManager::GenerateEvent( G4GeneralParticleSource *particleGun,
 //					AddDeposition()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::AddDeposition( LUXSimDetectorComponent* component,
-				stepRecord aStep )
+				const stepRecord &aStep )
 {
-	//	Go through all the detector components, and if the volume being recorded
-	//	is a registered detector component, pass that info to the correct object
-	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
-		if( luxSimComponents[i] == component ) {
-			luxSimComponents[i]->AddDeposition( aStep );
-			i = (G4int)luxSimComponents.size();
-		}
+	//	If the volume being recorded is a registered detector component, pass
+	//	that info to the correct object
+	if( FindComponent( (G4VPhysicalVolume*)component ) )
+		component->AddDeposition( aStep );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ResetStepNameTable()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::ResetStepNameTable()
+{
+	stepNameTable.clear();
+	stepNameIDs.clear();
+	particleNameIDs.clear();
+	processNameIDs.clear();
+	
+	//	The names that LUXSimOutput checks on every step go in first so that
+	//	they always have the same IDs
+	GetStepNameID( "opticalphoton" );
+	GetStepNameID( "thermalelectron" );
+	GetStepNameID( "primary" );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetStepNameID()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4int LUXSimManager::GetStepNameID( const G4String &name )
+{
+	std::map<G4String,G4int>::iterator it = stepNameIDs.find( name );
+	if( it != stepNameIDs.end() )
+		return it->second;
+	
+	G4int id = (G4int)stepNameTable.size();
+	stepNameTable.push_back( name );
+	stepNameIDs[name] = id;
+	
+	return id;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetParticleNameID()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4int LUXSimManager::GetParticleNameID( const G4ParticleDefinition *particle )
+{
+	//	Particle definitions live for the whole job, so the pointer is enough
+	//	to find the ID without comparing any strings
+	std::map<const G4ParticleDefinition*,G4int>::iterator it =
+			particleNameIDs.find( particle );
+	if( it != particleNameIDs.end() )
+		return it->second;
+	
+	G4int id = GetStepNameID( particle->GetParticleName() );
+	particleNameIDs[particle] = id;
+	
+	return id;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetProcessNameID()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4int LUXSimManager::GetProcessNameID( const G4VProcess *process )
+{
+	//	A NULL process is what a primary track reports as its creator
+	if( !process )
+		return GetStepNameID( "primary" );
+	
+	std::map<const G4VProcess*,G4int>::iterator it =
+			processNameIDs.find( process );
+	if( it != processNameIDs.end() )
+		return it->second;
+	
+	G4int id = GetStepNameID( process->GetProcessName() );
+	processNameIDs[process] = id;
+	
+	return id;
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2544,19 +2931,13 @@ void LUXSimManager::SetPMTNumberingScheme( G4String sel )
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 G4bool LUXSimManager::CapturePhotons( LUXSimDetectorComponent* component )
 {
-	//	Go through all the detector components, and if the volume with the
-	//	optical photon is set to capture optical photons, return true so that
-	//	the optical photon track can be killed
-	G4bool response = false;
+	//	If the volume with the optical photon is a detector component set to
+	//	capture optical photons, return true so that the optical photon track
+	//	can be killed
+	if( FindComponent( (G4VPhysicalVolume*)component ) )
+		return component->GetCapturePhotons();
 	
-	for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
-		if( luxSimComponents[i] == component ) {
-			if( luxSimComponents[i]->GetCapturePhotons() )
-				response = true;
-			i = (G4int)luxSimComponents.size();
-		}
-	
-	return response;
+	return false;
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -2567,6 +2948,7 @@ void LUXSimManager::RecordValues( G4int eventNum )
 	//	Go through all the detector components, and if any have an record
 	//	level greater than one, send the vector of steps to LUXSimOutput for
 	//	recording.
+    runStatistics->StartPhase( "outputWrite" );
     if( use100keVHack == 0 ) {
         for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
             if( (luxSimComponents[i]->GetRecordLevel() ||
@@ -2574,6 +2956,7 @@ void LUXSimManager::RecordValues( G4int eventNum )
                     luxSimComponents[i]->GetRecordLevelThermElec() )
                     && luxSimComponents[i]->GetEventRecord().size() )
                 LUXSimOut->RecordEventByVolume( luxSimComponents[i], eventNum );
+        LUXSimOut->EndOfEvent();
     } else if( liquidXenonTotalEnergy > 0.1*keV &&
             liquidXenonTotalEnergy < use100keVHack ) {
         for( G4int i=0; i<(G4int)luxSimComponents.size(); i++ )
@@ -2582,7 +2965,9 @@ void LUXSimManager::RecordValues( G4int eventNum )
                     luxSimComponents[i]->GetRecordLevelThermElec() )
                     && luxSimComponents[i]->GetEventRecord().size() )
                 LUXSimOut->RecordEventByVolume( luxSimComponents[i], eventNum );
+        LUXSimOut->EndOfEvent();
     }
+    runStatistics->StopPhase( "outputWrite" );
     
     liquidXenonTotalEnergy = 0;
 }
@@ -2682,527 +3067,90 @@ G4double LUXSimManager::GetXYZDependentElectricField (G4ThreeVector x) {
       }
   }
 
-  E3 = -1.*E3/1e9; // converter V/m to... V/nm?
+  E3 = -1.*E3/1e9; // V/m to Geant4 units (MV/mm), i.e. E3*volt/m
 
   return E3;
 }
 
 */
-void LUXSimManager::LoadXYZDependentDriftTime (G4String driftTimeFile) {
-  std::ifstream gridFile;
 
-  gridFile.open(driftTimeFile);
-  if (!gridFile.is_open()) {
-      G4cout<<G4endl<<G4endl<<G4endl;
-      G4cout<<"Drift Time File Not Found!"<<G4endl;
-      G4cout<<G4endl<<G4endl<<G4endl;
-      exit(0);      
-  }
-  for (int j = 0; j < 598; j++) {
-    for (int i = 0; i < 251; i++) {
-      gridFile >> xyzDependentDriftTime[i][j];
-    }
-  }
-  gridFile.close();
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LoadXYZDependentDriftTime()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimManager::LoadXYZDependentDriftTime (G4String driftTimeFile) {
+	xyzDependentDriftTimeMap->Load( driftTimeFile, outputDir );
 }
-/*
-G4double LUXSimManager::GetXYZDependentDriftTime (G4ThreeVector x) {
-    G4double R = sqrt(x[0]*x[0] + x[1]*x[1]);
-    G4double Z = x[2];
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-    G4int R1 = floor(R);
-    G4int R2 = ceil(R);
-    G4int Z1 = floor(Z);
-    G4int Z2 = ceil(Z);
-
-    G4double dT3;
-
-    // ok, so now we have four points between which is interpolate
-    // (R1, Z1), (R1, Z2), (R2, Z1), and (R2, Z2)
-    // if the drift time from any of these points is -1 we assume
-    // the drift time is -1 at (R, Z) for simplicity
-
-    if (xyzDependentDriftTime[R1][Z1] < 0 ||
-        xyzDependentDriftTime[R1][Z2] < 0 ||
-        xyzDependentDriftTime[R2][Z1] < 0 ||
-        xyzDependentDriftTime[R2][Z2] < 0) {
-        return -1;
-    }
-    else {
-	// need to deal with cases were an RZ position is on one of the grid points
-        if (R1 == R2 && Z1 == Z2) {
-            dT3 = xyzDependentDriftTime[R1][Z1];
-        }
-	else {
-            if (R1 == R2) {
-                G4double dT1 = xyzDependentDriftTime[R1][Z1];
-                G4double dT2 = xyzDependentDriftTime[R1][Z2];
-                G4double M3 = (dT2 - dT1)/(Z2 - Z1);
-                G4double B3 = dT1 - M3*Z1;
-                dT3 = M3*Z + B3;
-            }
-            else if (Z1 == Z2) {
-                G4double dT1 = xyzDependentDriftTime[R1][Z1];
-                G4double dT2 = xyzDependentDriftTime[R2][Z1];
-                G4double M3 = (dT2 - dT1)/(R2 - R1);
-                G4double B3 = dT1 - M3*R1;
-                dT3 = M3*R + B3;
-            }
-            else {
-                // calculate slope from (R1, Z1) to (R2, Z1) and (R1, Z2) to (R2, Z2)
-                // so we will have two slopes: M1 and M2 and two offsets B1 and B2
-                G4double M1 = (xyzDependentDriftTime[R2][Z1] - xyzDependentDriftTime[R1][Z1])/(R2 - R1);
-                G4double M2 = (xyzDependentDriftTime[R2][Z2] - xyzDependentDriftTime[R1][Z2])/(R2 - R1);
 
-                G4double B1 = xyzDependentDriftTime[R1][Z1] - M1*R1;
-                G4double B2 = xyzDependentDriftTime[R2][Z2] - M2*R2;
-
-                G4double dT1 = M1*R + B1;
-                G4double dT2 = M2*R + B2;
-
-                // we now calculate the slope, M3, and intercept, B3, for these two points
-
-                G4double M3 = (dT2 - dT1)/(Z2 - Z1);
-                G4double B3 = dT1 - M3*Z1;
-
-                // we now can calculate the field at our point (R,Z)
-
-                dT3 = M3*Z + B3;
-            }
-	}
-    }
-    dT3 = dT3 * 1000.; // LUXSim wants drift time in units of ns, not us
-    return dT3;
-}
-*/
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LoadXYZDependentRadialDrift()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::LoadXYZDependentRadialDrift (G4String radialDriftFile) {
-  std::ifstream gridFile;
-  gridFile.open(radialDriftFile);
-  if (!gridFile.is_open()) {
-      G4cout<<G4endl<<G4endl<<G4endl;
-      G4cout<<"Radial Drift File Not Found!"<<G4endl;
-      G4cout<<G4endl<<G4endl<<G4endl;
-      exit(0);
-  }
-  for (int j = 0; j < 598; j++) {
-    for (int i = 0; i < 251; i++) {
-      gridFile >> xyzDependentRadialDrift[i][j];
-    }
-  }
-  gridFile.close();
+	xyzDependentRadialDriftMap->Load( radialDriftFile, outputDir );
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentRadialDrift()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 G4double LUXSimManager::GetXYZDependentRadialDrift (G4ThreeVector x1) {
-    G4double R = sqrt(x1[0]*x1[0] + x1[1]*x1[1]);
-    G4double Z = x1[2];
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-    G4int R1 = floor(R);
-    G4int R2 = ceil(R);
-    G4int Z1 = floor(Z);
-    G4int Z2 = ceil(Z);
-
-    G4double tR3;
-
-    // ok, so now we have four points between which is interpolate
-    // (R1, Z1), (R1, Z2), (R2, Z1), and (R2, Z2)
-    // if the drift time from any of these points is -1 we assume
-    // the drift time is -1 at (R, Z) for simplicity
-
-    if (xyzDependentRadialDrift[R1][Z1] < 0 ||
-        xyzDependentRadialDrift[R1][Z2] < 0 ||
-        xyzDependentRadialDrift[R2][Z1] < 0 ||
-        xyzDependentRadialDrift[R2][Z2] < 0) {
-        return -1;
-    }
-    else {
-	// need to deal with cases were an RZ position is on one of the grid points
-        if (R1 == R2 && Z1 == Z2) {
-            tR3 = xyzDependentRadialDrift[R1][Z1];
-        }
-	else {
-            if (R1 == R2) {
-                G4double tR1 = xyzDependentRadialDrift[R1][Z1];
-                G4double tR2 = xyzDependentRadialDrift[R1][Z2];
-                G4double M3 = (tR2 - tR1)/(Z2 - Z1);
-                G4double B3 = tR1 - M3*Z1;
-                tR3 = M3*Z + B3;
-            }
-            else if (Z1 == Z2) {
-                G4double tR1 = xyzDependentRadialDrift[R1][Z1];
-                G4double tR2 = xyzDependentRadialDrift[R2][Z1];
-                G4double M3 = (tR2 - tR1)/(R2 - R1);
-                G4double B3 = tR1 - M3*R1;
-                tR3 = M3*R + B3;
-            }
-            else {
-                // calculate slope from (R1, Z1) to (R2, Z1) and (R1, Z2) to (R2, Z2)
-                // so we will have two slopes: M1 and M2 and two offsets B1 and B2
-                G4double M1 = (xyzDependentRadialDrift[R2][Z1] - xyzDependentRadialDrift[R1][Z1])/(R2 - R1);
-                G4double M2 = (xyzDependentRadialDrift[R2][Z2] - xyzDependentRadialDrift[R1][Z2])/(R2 - R1);
-
-                G4double B1 = xyzDependentRadialDrift[R1][Z1] - M1*R1;
-                G4double B2 = xyzDependentRadialDrift[R2][Z2] - M2*R2;
-
-                G4double tR1 = M1*R + B1;
-                G4double tR2 = M2*R + B2;
-
-                // we now calculate the slope, M3, and intercept, B3, for these two points
-
-                G4double M3 = (tR2 - tR1)/(Z2 - Z1);
-                G4double B3 = tR1 - M3*Z1;
-
-                // we now can calculate the field at our point (R,Z)
-
-                tR3 = M3*Z + B3;
-            }
-	}
-    }
-    tR3 = tR3 * 10.; // convert cm to mm
-    return tR3;
+	//	-1 off the table, or next to a grid point outside the fiducial region
+	G4double radialDrift;
+	if( !xyzDependentRadialDriftMap->Interpolate( x1, &radialDrift ) )
+		return -1;
+	return radialDrift;
 }
 
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LoadXYZDependentEField()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 void LUXSimManager::LoadXYZDependentEField (G4String eFieldFile) {
-      G4cout<<G4endl<<G4endl<<G4endl;
-      G4cout<<"Load Efieldfile!"<<G4endl;
-      G4cout<<G4endl<<G4endl<<G4endl;
-
-  for (int aa=0; aa<NumPlanesX; aa++) {
-
-    for (int bb=0; bb<NumPlanesY; bb++) {
-
-      for (int cc=0; cc<NumPlanesZ; cc++) {
-
-  /*      xyzDependentEField[aa][bb][cc][0] = G4double(round(double(aa) -
-
-            double(MinLocationX)));
-
-        xyzDependentEField[aa][bb][cc][1] = G4double(round(double(bb) -
-
-            double(MinLocationY)));
-
-        xyzDependentEField[aa][bb][cc][2] = G4double(round(double(cc) -
-
-            double(MinLocationZ)));*/
-
-        for (int dd=3; dd<NumxyzDependentEFieldVars; dd++) {
-
-          xyzDependentEField[aa][bb][cc][dd] = -100000.0;  //know when outside or if somehow a point is missing from the field map
-
-        }
-
-      }
-
-    }
-
-  }
-
-
-
-  std::ifstream gridFile;
-
-  gridFile.open(eFieldFile);
-
-  if (!gridFile.is_open()) {
-
-      G4cout<<G4endl<<G4endl<<G4endl;
-      G4cout<<"E-Field File Not Found!"<<G4endl;
-      G4cout<<G4endl<<G4endl<<G4endl;
-
-      exit(0);
-
-  }
-	string sLine;
-
-	getline(gridFile, sLine);         
-//	G4cout << sLine.data() << G4endl;
-  char readchar[20];
-    
-  G4double tempArray[NumxyzDependentEFieldVars];
-
-  G4int tempX;
-
-  G4int tempY;
-
-  G4int tempZ;
-
-  while (!gridFile.eof()) {
-
-    for (int aa=0; aa<NumxyzDependentEFieldVars; aa++) {
-
-      //read from EFieldFile
-
-      //7 values: xi, yi, zi, E, x, y, drift_time
-	
-      gridFile >> readchar;
-	if (strcmp(readchar,"nan")!=0) {
-	tempArray[aa] = atof(readchar);
-	//G4cout<<tempArray[aa]<<G4endl<<G4endl;
-	}
-	
-   }
-
-    //find array location to save in which to save info
-
-    tempX = (int)(round(double((tempArray[0]*10. - MinLocationX)/StepSizeX)));
-
-    tempY = (int)(round(double((tempArray[1]*10.  - MinLocationY)/StepSizeY)));
-
-    tempZ = (int)(round(double((tempArray[2]*10.  - MinLocationZ)/StepSizeZ)));
-
-
-    for (int aa=0; aa<NumxyzDependentEFieldVars; aa++) {
-
-      //save the info
-	if(tempX>-1&&tempX<NumPlanesX&&tempY>-1&&tempY<NumPlanesY&&tempZ>-1&&tempZ<NumPlanesZ){
-	if(aa==0||aa==1||aa==4||aa==5)      xyzDependentEField[tempX][tempY][tempZ][aa] = tempArray[aa]*10.;//convert unit to mm
-	else if (aa==2)	xyzDependentEField[tempX][tempY][tempZ][aa] = tempArray[aa]*10.;//56 mm is height of cathode.
-	else if (aa==6) xyzDependentEField[tempX][tempY][tempZ][aa] = tempArray[aa]*1000.;//convert unit to ns.
-
-	else 	{xyzDependentEField[tempX][tempY][tempZ][aa] = tempArray[aa];       
+	//	The field map only reads the file (or its binary cache) the first time
+	//	it's asked for, so this is cheap to call from the physics processes.
+	//	The cache goes in the output directory, which the job writes to anyway.
+	xyzDependentFieldMap->Load( eFieldFile, outputDir );
 }
-	}
-
-    }
-
-  }
-
-  gridFile.close();
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentFieldValues()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimManager::GetXYZDependentFieldValues( const G4ThreeVector &x,
+		G4double *values )
+{
+	return xyzDependentFieldMap->Interpolate( x, values );
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentElectricField()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 G4double LUXSimManager::GetXYZDependentElectricField (G4ThreeVector x) {
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-
-	int value = 3; //EField is the [3]component of xyzDependentEField map.
-
-	int Z_index = (int) ((x[2]-MinLocationZ)/StepSizeZ); //56mm is height of cathode
-	int Y_index = (int) ((x[1]-MinLocationY)/StepSizeY);
-	int X_index = (int) ((x[0]-MinLocationX)/StepSizeX);
-	// Not in the liquid, ignore this event.
-	if (Z_index < 0 || Z_index >  (NumPlanesZ-2) ||
-		Y_index < 0 || Y_index > (NumPlanesY-2) ||
-		X_index < 0 || X_index > (NumPlanesX-2)){
-        return -100000.;
-	}
-	
-
-	//8 index that is closest to the points we gave.
-	int id[8];
-	id[0] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[1] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[2] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[3] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[4] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[5] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[6] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[7] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-
-	G4double E3 = -100000.;
-	
-
-	// Not in the fiducial region, ignore this event.
-	for(int k=0;k<8;k++){
-		if(*(&xyzDependentEField[0][0][0][0]+id[k]+7) ==0) {return -100000.;}
-
-	}
-	
-	// gradient of zyx direction
-	G4double z_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)-*(&xyzDependentEField[0][0][0][0]+id[3]+value)+*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeZ; 
-	G4double y_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)+*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)-*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeY; 
-	G4double x_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)+*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)-*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeX; 
-	//interpolation from the closest point.
-	//find the closest point of the 8 first.
-	int i=0;
-	for (int j=1;j<8;j++){
-
-		if((pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[j]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[j]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[j]+2),2))<(pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2),2))) i=j;
-	}
-
-	E3 = *(&xyzDependentEField[0][0][0][0]+id[i]+value)+x_gradient*(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0))+y_gradient*(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1))+z_gradient*(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2));
-	E3 = -1.*E3/1e9; // converter V/m to... V/nm?
-	//G4cout<<"E="<<E3<<G4endl<<G4endl;
-	return E3;
-
+	G4double values[LUXSimFieldMap::kNumValues];
+	xyzDependentFieldMap->Interpolate( x, values );
+	return values[LUXSimFieldMap::kEField];
 }
 
-
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentS2_X()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 G4double LUXSimManager::GetXYZDependentS2_X (G4ThreeVector x) {
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-
-	int value = 4; //s2x is the [4]component of xyzDependentEField map.
-
-	int Z_index = (int) ((x[2]-MinLocationZ)/StepSizeZ); 
-	int Y_index = (int) ((x[1]-MinLocationY)/StepSizeY);
-	int X_index = (int) ((x[0]-MinLocationX)/StepSizeX);
-	// Not in the liquid, ignore this event.
-	if (Z_index < 0 || Z_index >  (NumPlanesZ-2) ||
-		Y_index < 0 || Y_index > (NumPlanesY-2) ||
-		X_index < 0 || X_index > (NumPlanesX-2)){
-        return -100000.;
-	}
-	
-
-	//8 index that is closest to the points we gave.
-	int id[8];
-	id[0] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[1] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[2] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[3] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[4] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[5] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[6] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[7] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-
-	G4double E3 = -100000.;
-	
-
-	// Not in the fiducial region, ignore this event.
-	for(int k=0;k<8;k++){
-		if(*(&xyzDependentEField[0][0][0][0]+id[k]+7) !=1) {return -100000.;}
-	}
-	
-	// gradient of zyx direction
-	G4double z_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)-*(&xyzDependentEField[0][0][0][0]+id[3]+value)+*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeZ; 
-	G4double y_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)+*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)-*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeY; 
-	G4double x_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)+*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)-*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeX; 
-	//interpolation from the closest point.
-	//find the closest point of the 8 first.
-	int i=0;
-	for (int j=1;j<8;j++){
-
-		if((pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[j]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[j]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[j]+2),2))<(pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2),2))) i=j;
-	}
-
-	E3 = *(&xyzDependentEField[0][0][0][0]+id[i]+value)+x_gradient*(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0))+y_gradient*(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1))+z_gradient*(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2));
-	//G4cout<<"x="<<x[0]<<"y="<<x[1]<<"z="<<x[2]<<", s2x="<<E3<<G4endl<<G4endl;
-	return E3;
+	G4double values[LUXSimFieldMap::kNumValues];
+	xyzDependentFieldMap->Interpolate( x, values );
+	return values[LUXSimFieldMap::kS2X];
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentS2_Y()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 G4double LUXSimManager::GetXYZDependentS2_Y (G4ThreeVector x) {
-
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-
-	int value = 5; //s2y is the [4]component of xyzDependentEField map.
-	int Z_index = (int) ((x[2]-MinLocationZ)/StepSizeZ); 
-	int Y_index = (int) ((x[1]-MinLocationY)/StepSizeY);
-	int X_index = (int) ((x[0]-MinLocationX)/StepSizeX);
-	// Not in the liquid, ignore this event.
-	if (Z_index < 0 || Z_index >  (NumPlanesZ-2) ||
-		Y_index < 0 || Y_index > (NumPlanesY-2) ||
-		X_index < 0 || X_index > (NumPlanesX-2)){
-        return -100000.;
-	}
-	
-
-	//8 index that is closest to the points we gave.
-	int id[8];
-	id[0] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[1] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[2] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[3] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[4] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[5] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[6] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[7] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-
-	G4double E3 = -100000.;
-	
-
-	// Not in the fiducial region, ignore this event.
-	for(int k=0;k<8;k++){
-		if(*(&xyzDependentEField[0][0][0][0]+id[k]+7) != 1) {return -100000.;}
-	}
-	
-	// gradient of zyx direction
-	G4double z_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)-*(&xyzDependentEField[0][0][0][0]+id[3]+value)+*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeZ; 
-	G4double y_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)+*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)-*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeY; 
-	G4double x_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)+*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)-*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeX; 
-	//interpolation from the closest point.
-	//find the closest point of the 8 first.
-	int i=0;
-	for (int j=1;j<8;j++){
-
-		if((pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[j]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[j]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[j]+2),2))<(pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2),2))) i=j;
-	}
-
-	E3 = *(&xyzDependentEField[0][0][0][0]+id[i]+value)+x_gradient*(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0))+y_gradient*(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1))+z_gradient*(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2));
-	return E3;
+	G4double values[LUXSimFieldMap::kNumValues];
+	xyzDependentFieldMap->Interpolate( x, values );
+	return values[LUXSimFieldMap::kS2Y];
 }
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetXYZDependentDriftTime()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
 G4double LUXSimManager::GetXYZDependentDriftTime (G4ThreeVector x) {
-//      G4cout<<G4endl<<G4endl<<G4endl;
-//      G4cout<<"Get Drift time from file!"<<G4endl;
-//      G4cout<<G4endl<<G4endl<<G4endl;
-
-    // for now exploit the fact that we know the grid has 1 mm spacing
-    // i.e. if R is in mm then the index for R is between floor(R) and ceil(R)
-    // this needs to be made more flexible in the future
-
-	int value = 6; //DriftTime is the [6]component of xyzDependentEField map.
-
-	int Z_index = (int) ((x[2]-MinLocationZ)/StepSizeZ); 
-	int Y_index = (int) ((x[1]-MinLocationY)/StepSizeY);
-	int X_index = (int) ((x[0]-MinLocationX)/StepSizeX);
-	// Not in the liquid, ignore this event.
-	if (Z_index < 0 || Z_index >  (NumPlanesZ-2) ||
-		Y_index < 0 || Y_index > (NumPlanesY-2) ||
-		X_index < 0 || X_index > (NumPlanesX-2)){
-        return -100000.;
-	}
-	
-
-	//8 index that is closest to the points we gave.
-	int id[8];
-	id[0] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[1] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[2] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[3] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index)*NumxyzDependentEFieldVars;
-	id[4] = (((X_index)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[5] = (((X_index+1)*NumPlanesY + (Y_index)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[6] = (((X_index)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-	id[7] = (((X_index+1)*NumPlanesY + (Y_index+1)) * NumPlanesZ+ Z_index+1)*NumxyzDependentEFieldVars;
-
-	G4double E3 = -100000.;
-	
-
-	// Not in the fiducial region, ignore this event.
-	for(int k=0;k<8;k++){
-		if(*(&xyzDependentEField[0][0][0][0]+id[k]+7) != 1) {return -100000.;}
-	}
-	
-	// gradient of zyx direction
-	G4double z_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)-*(&xyzDependentEField[0][0][0][0]+id[3]+value)+*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeZ; 
-	G4double y_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)-*(&xyzDependentEField[0][0][0][0]+id[1]+value)+*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)-*(&xyzDependentEField[0][0][0][0]+id[5]+value)+*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeY; 
-	G4double x_gradient = (-*(&xyzDependentEField[0][0][0][0]+id[0]+value)+*(&xyzDependentEField[0][0][0][0]+id[1]+value)-*(&xyzDependentEField[0][0][0][0]+id[2]+value)+*(&xyzDependentEField[0][0][0][0]+id[3]+value)-*(&xyzDependentEField[0][0][0][0]+id[4]+value)+*(&xyzDependentEField[0][0][0][0]+id[5]+value)-*(&xyzDependentEField[0][0][0][0]+id[6]+value)+*(&xyzDependentEField[0][0][0][0]+id[7]+value))/4./StepSizeX; 
-	//interpolation from the closest point.
-	//find the closest point of the 8 first.
-	int i=0;
-	for (int j=1;j<8;j++){
-
-		if((pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[j]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[j]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[j]+2),2))<(pow(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0),2)+ pow(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1),2)+ pow(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2),2))) i=j;
-	}
-
-	E3 = *(&xyzDependentEField[0][0][0][0]+id[i]+value)+x_gradient*(x[0]-*(&xyzDependentEField[0][0][0][0]+id[i]+0))+y_gradient*(x[1]-*(&xyzDependentEField[0][0][0][0]+id[i]+1))+z_gradient*(x[2]-*(&xyzDependentEField[0][0][0][0]+id[i]+2));
-	return E3;
+	G4double values[LUXSimFieldMap::kNumValues];
+	xyzDependentFieldMap->Interpolate( x, values );
+	return values[LUXSimFieldMap::kDriftTime];
 }
-
-
-
-
-
@@ -96,6 +96,21 @@
 *   14-Oct-14 - Added component-wise SetMass and SetVolume commands (Kareem)
 *   02-Feb-15 - Added pencil beam command for the LUX DD generator (Kevin)
 *   15-Jul-15 - Added option to turn on/off the cavern rock geometry (David W)
+*   17-Oct-26 - Added commands to control the output buffer size and flush
+*               frequency (agent)
+*   17-Oct-26 - Added the output format command (agent)
+*   17-Oct-26 - Added the per-event seeds, random first event and event list
+*               size commands (agent)
+*   17-Oct-26 - Added the events file first event command (agent)
+*   17-Oct-26 - Added the step statistics and record run statistics commands
+*               (agent)
+*   17-Oct-26 - Added the FastSim library, connections and compile commands
+*               (agent)
+*   17-Oct-26 - Added the parametrized S2 commands (agent)
+*   17-Oct-26 - Added the volume cache file command (agent)
+*   17-Oct-26 - Added the volume threads command (agent)
+*   17-Oct-26 - The volume cache is off unless a file is given (agent)
+*   17-Oct-26 - Added the streamEvents command (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -118,6 +133,7 @@
 //
 #include "LUXSimMessenger.hh"
 #include "LUXSimManager.hh"
+#include "LUXSimRunStatistics.hh"
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimMessenger()
@@ -138,6 +154,26 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
 	LUXSimRandomSeedCommand->SetGuidance( "simulation. By default, the randomization seed is itself random, so this" );
 	LUXSimRandomSeedCommand->SetGuidance( "command is used for reproducing earlier data (e.g., for debugging)." );
 	LUXSimRandomSeedCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+	
+	LUXSimPerEventSeedsCommand = new G4UIcmdWithABool( "/LUXSim/perEventSeeds", this );
+	LUXSimPerEventSeedsCommand->SetGuidance( "Setting this command to true reseeds the randomization engine at the start of" );
+	LUXSimPerEventSeedsCommand->SetGuidance( "every event, using only the randomization seed and the event number. Each" );
+	LUXSimPerEventSeedsCommand->SetGuidance( "event is then reproducible on its own, regardless of the events before it." );
+	LUXSimPerEventSeedsCommand->SetGuidance( "The default value is false." );
+	LUXSimPerEventSeedsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+	
+	LUXSimRandomFirstEventCommand = new G4UIcmdWithAnInteger( "/LUXSim/randomFirstEvent", this );
+	LUXSimRandomFirstEventCommand->SetGuidance( "Use this command to run a shard of a job that has been split across" );
+	LUXSimRandomFirstEventCommand->SetGuidance( "several processes. The events of this process are numbered from this value" );
+	LUXSimRandomFirstEventCommand->SetGuidance( "in the output and in the per-event seeds, the output file name gets \"_\" and" );
+	LUXSimRandomFirstEventCommand->SetGuidance( "this value added after the seed, and the events before it are taken off the" );
+	LUXSimRandomFirstEventCommand->SetGuidance( "event list without being run. Give every shard the same randomization seed," );
+	LUXSimRandomFirstEventCommand->SetGuidance( "turn on /LUXSim/perEventSeeds, and if there are LUXSim sources, give every" );
+	LUXSimRandomFirstEventCommand->SetGuidance( "shard the size of the whole job with /LUXSim/source/eventListEvents." );
+	LUXSimRandomFirstEventCommand->SetGuidance( "The default value is 0." );
+	LUXSimRandomFirstEventCommand->SetParameterName( "firstEvent", false );
+	LUXSimRandomFirstEventCommand->SetRange( "firstEvent >= 0" );
+	LUXSimRandomFirstEventCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
 
 	//	Input/output commands
 	LUXSimFileDir = new G4UIdirectory( "/LUXSim/io/" );
@@ -161,6 +197,44 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
     LUXSimEventProgressCommand->SetGuidance( "includes the current event number and the total number of seconds that have" );
     LUXSimEventProgressCommand->SetGuidance( "elapsed since the begininning of Event 1." );
     
+    LUXSimOutputBufferSizeCommand = new G4UIcmdWithAnInteger( "/LUXSim/io/bufferSize", this );
+    LUXSimOutputBufferSizeCommand->SetGuidance( "Sets the size, in bytes, that the block of buffered event records has to reach" );
+    LUXSimOutputBufferSizeCommand->SetGuidance( "before it is written to disk. Set to 0 to disable the size check. The default" );
+    LUXSimOutputBufferSizeCommand->SetGuidance( "value is 4194304 (4 MB)." );
+    LUXSimOutputBufferSizeCommand->SetParameterName( "bytes", false );
+    LUXSimOutputBufferSizeCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+    
+    LUXSimOutputFlushFrequencyCommand = new G4UIcmdWithAnInteger( "/LUXSim/io/flushFrequency", this );
+    LUXSimOutputFlushFrequencyCommand->SetGuidance( "Writes the buffered event records to disk every N events, regardless of the" );
+    LUXSimOutputFlushFrequencyCommand->SetGuidance( "buffer size. Set to 1 to write every event as soon as it is recorded. The" );
+    LUXSimOutputFlushFrequencyCommand->SetGuidance( "default value is 0 (only the buffer size is used)." );
+    LUXSimOutputFlushFrequencyCommand->SetParameterName( "events", false );
+    LUXSimOutputFlushFrequencyCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+    
+    LUXSimOutputFormatCommand = new G4UIcmdWithAnInteger( "/LUXSim/io/outputFormat", this );
+    LUXSimOutputFormatCommand->SetGuidance( "Selects the version of the binary output format. Version 1 (the default) is" );
+    LUXSimOutputFormatCommand->SetGuidance( "the legacy format that writes the particle, creator process and step process" );
+    LUXSimOutputFormatCommand->SetGuidance( "names as strings on every step. Version 2 writes integer IDs instead, along" );
+    LUXSimOutputFormatCommand->SetGuidance( "with a single name table per file. Use tools/LUXSimFormatConverter to turn a" );
+    LUXSimOutputFormatCommand->SetGuidance( "version 2 file back into the legacy format." );
+    LUXSimOutputFormatCommand->SetParameterName( "version", false );
+    LUXSimOutputFormatCommand->SetRange( "version==1 || version==2" );
+    LUXSimOutputFormatCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+    
+    LUXSimStepStatisticsCommand = new G4UIcmdWithABool( "/LUXSim/io/stepStatistics", this );
+    LUXSimStepStatisticsCommand->SetGuidance( "Setting this command to true counts the steps taken by each particle type and" );
+    LUXSimStepStatisticsCommand->SetGuidance( "in each detector component, along with the wall time spent on them. The counts" );
+    LUXSimStepStatisticsCommand->SetGuidance( "are added to the run statistics printed at the end of the run. This adds a" );
+    LUXSimStepStatisticsCommand->SetGuidance( "clock read to every step. The default value is false." );
+    LUXSimStepStatisticsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+    
+    LUXSimRecordRunStatisticsCommand = new G4UIcmdWithABool( "/LUXSim/io/recordRunStatistics", this );
+    LUXSimRecordRunStatisticsCommand->SetGuidance( "Setting this command to true appends the run statistics to the output file as a" );
+    LUXSimRecordRunStatisticsCommand->SetGuidance( "length-prefixed string after the last record (after the name table in version 2" );
+    LUXSimRecordRunStatisticsCommand->SetGuidance( "files). Readers stop at the record count, so they are unaffected. The default" );
+    LUXSimRecordRunStatisticsCommand->SetGuidance( "value is false." );
+    LUXSimRecordRunStatisticsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+    
     LUXSim100keVHackCommand = new G4UIcmdWithADoubleAndUnit( "/LUXSim/io/upperEnergyHack", this );
     LUXSim100keVHackCommand->SetGuidance( "Sets the upper energy cut for the active liquid xenon. If the total energy" );
     LUXSim100keVHackCommand->SetGuidance( "deposition exceeds the given value, the entire event will not be recorded to" );
@@ -215,6 +289,25 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
 	LUXSimComponentSetVolumeCommand->SetGuidance( "Usage: /LUXSim/detector/setComponentVolume <component name> <volume> <units>" );
 	LUXSimComponentSetVolumeCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
 
+    LUXSimVolumeCacheFileCommand = new G4UIcmdWithAString( "/LUXSim/detector/volumeCacheFile", this );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "Sets the file that the calculated component volumes are cached in, so" );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "that later runs with the same geometry don't have to calculate them again." );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "The file is rewritten whole (through a temporary file) when a volume is" );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "added, so jobs sharing it never see a partial entry. Use \"none\" to turn" );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "the cache off." );
+	LUXSimVolumeCacheFileCommand->SetGuidance( "Default value = none" );
+	LUXSimVolumeCacheFileCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
+    LUXSimVolumeThreadsCommand = new G4UIcmdWithAnInteger( "/LUXSim/detector/volumeThreads", this );
+	LUXSimVolumeThreadsCommand->SetGuidance( "Sets the most threads a component volume is calculated on. Fewer are used" );
+	LUXSimVolumeThreadsCommand->SetGuidance( "if the process is allowed on fewer CPUs, and only one for solids that aren't" );
+	LUXSimVolumeThreadsCommand->SetGuidance( "safe to share between threads (e.g., the twisted solids). The volumes are" );
+	LUXSimVolumeThreadsCommand->SetGuidance( "the same however many threads are used." );
+	LUXSimVolumeThreadsCommand->SetGuidance( "Default value = 1" );
+	LUXSimVolumeThreadsCommand->SetParameterName( "threads", false );
+	LUXSimVolumeThreadsCommand->SetRange( "threads >= 1" );
+	LUXSimVolumeThreadsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
 	LUXSimMuonVetoCommand = new G4UIcmdWithAString( "/LUXSim/detector/muonVeto", this );
 	LUXSimMuonVetoCommand->SetGuidance( "Turns the muon veto system on or off. The default" );
 	LUXSimMuonVetoCommand->SetGuidance( "choice is \"off\"." );
@@ -426,6 +519,28 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
 	LUXFastSimSkewGaussianS2Command = new G4UIcmdWithABool( "/LUXSim/detector/LUXFastSimSkewGaussianS2", this );
 	LUXFastSimSkewGaussianS2Command->SetGuidance( "Sets whether or not to use a skew gaussian model for the single electrons size in fast sims." );
 	LUXFastSimSkewGaussianS2Command->AvailableForStates( G4State_PreInit, G4State_Idle );
+
+	LUXSimFastSimLibraryCommand = new G4UIcmdWithAString( "/LUXSim/detector/fastSimLibrary", this );
+	LUXSimFastSimLibraryCommand->SetGuidance( "Sets the light-map library used by the fast sims. This can be a text library, or" );
+	LUXSimFastSimLibraryCommand->SetGuidance( "an image written by /LUXSim/detector/compileFastSimLibrary, which is mapped" );
+	LUXSimFastSimLibraryCommand->SetGuidance( "instead of parsed. Either way, the library is only read when the fast sims are" );
+	LUXSimFastSimLibraryCommand->SetGuidance( "first used." );
+	LUXSimFastSimLibraryCommand->SetGuidance( "The default is physicslist/src/fastSimLibrary_fromKr_V04.dat" );
+	LUXSimFastSimLibraryCommand->SetParameterName( "library", false );
+	LUXSimFastSimLibraryCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
+	LUXSimFastSimConnectionsCommand = new G4UIcmdWithAString( "/LUXSim/detector/fastSimConnections", this );
+	LUXSimFastSimConnectionsCommand->SetGuidance( "Sets the file of connections between the positions of a text fast sim library." );
+	LUXSimFastSimConnectionsCommand->SetGuidance( "Library images already hold what the connections are used for." );
+	LUXSimFastSimConnectionsCommand->SetGuidance( "The default is physicslist/src/fastSimConnections_fromKr_V04.dat" );
+	LUXSimFastSimConnectionsCommand->SetParameterName( "connections", false );
+	LUXSimFastSimConnectionsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
+	LUXSimCompileFastSimLibraryCommand = new G4UIcmdWithAString( "/LUXSim/detector/compileFastSimLibrary", this );
+	LUXSimCompileFastSimLibraryCommand->SetGuidance( "Reads the fast sim library and connections files, works out the triangle" );
+	LUXSimCompileFastSimLibraryCommand->SetGuidance( "lookup table, and writes it all to the given file as a library image." );
+	LUXSimCompileFastSimLibraryCommand->SetParameterName( "image", false );
+	LUXSimCompileFastSimLibraryCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
 	
 	//	Source commands
 	LUXSimSourceDir = new G4UIdirectory( "/LUXSim/source/" );
@@ -449,11 +564,35 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
 	LUXSimSourcePrintCommand = new G4UIcmdWithABool( "/LUXSim/source/print", this );
     LUXSimSourcePrintCommand->SetGuidance("(Boolean) Prints Decay Chain Binary Tree to standard output; lines starts with NodeDecayChain");
     LUXSimSourcePrintCommand->AvailableForStates( G4State_PreInit, G4State_Idle);
+
+	LUXSimSourceEventListEventsCommand = new G4UIcmdWithAnInteger( "/LUXSim/source/eventListEvents", this );
+	LUXSimSourceEventListEventsCommand->SetGuidance( "Builds the event list for at least this many events, counted from the" );
+	LUXSimSourceEventListEventsCommand->SetGuidance( "start of the job. The shards of a split job only draw the same event list" );
+	LUXSimSourceEventListEventsCommand->SetGuidance( "if they are all given the total number of events in the job. The default" );
+	LUXSimSourceEventListEventsCommand->SetGuidance( "is 0, i.e., the list runs to the last event of this process." );
+	LUXSimSourceEventListEventsCommand->SetParameterName( "eventListEvents", false );
+	LUXSimSourceEventListEventsCommand->SetRange( "eventListEvents >= 0" );
+	LUXSimSourceEventListEventsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
+	LUXSimSourceStreamEventsCommand = new G4UIcmdWithABool( "/LUXSim/source/streamEvents", this );
+	LUXSimSourceStreamEventsCommand->SetGuidance( "(Boolean) Makes the events of each source as the run reaches them, rather than" );
+	LUXSimSourceStreamEventsCommand->SetGuidance( "building the whole event list before the run. Decay chains are still" );
+	LUXSimSourceStreamEventsCommand->SetGuidance( "generated up front. The default is false." );
+	LUXSimSourceStreamEventsCommand->SetParameterName( "streamEvents", false );
+	LUXSimSourceStreamEventsCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
     //reset
     LUXSimSourceResetCommand = new G4UIcmdWithoutParameter( "/LUXSim/source/reset", this );
 	LUXSimSourceResetCommand->SetGuidance( "Clears all previously set sources" );
 	LUXSimSourceResetCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
 
+	LUXSimEventsFileFirstEventCommand = new G4UIcmdWithAnInteger( "/LUXSim/source/eventsFileFirstEvent", this );
+	LUXSimEventsFileFirstEventCommand->SetGuidance( "Sets the event in the events file that the EventsFile generator starts from." );
+	LUXSimEventsFileFirstEventCommand->SetGuidance( "Events are counted from 0 at the start of the file, whatever their event numbers," );
+	LUXSimEventsFileFirstEventCommand->SetGuidance( "so a long events file can be split across several jobs. The default is 0." );
+	LUXSimEventsFileFirstEventCommand->SetParameterName( "firstEvent", false );
+	LUXSimEventsFileFirstEventCommand->SetRange( "firstEvent>=0" );
+	LUXSimEventsFileFirstEventCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+
 	//	Physics list commands
 	LUXSimPhysicsListDir = new G4UIdirectory( "/LUXSim/physicsList/" );
 	LUXSimPhysicsListDir->SetGuidance( "Commands to control the physics list" );
@@ -474,6 +613,17 @@ LUXSimMessenger::LUXSimMessenger( LUXSimManager *man )
  	LUXSimS2GainCommand->SetGuidance( "Sets the gain for S2 light generation" );
 	LUXSimS2GainCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
 	
+    LUXSimParametrizedS2Command = new G4UIcmdWithABool( "/LUXSim/physicsList/parametrizedS2", this );
+ 	LUXSimParametrizedS2Command->SetGuidance( "Generates S2 light analytically for each extracted electron and puts the" );
+ 	LUXSimParametrizedS2Command->SetGuidance( "photoelectrons straight onto the PMTs using the FastSim S2 light map," );
+ 	LUXSimParametrizedS2Command->SetGuidance( "instead of tracking the electron and its photons through the gas gap" );
+	LUXSimParametrizedS2Command->AvailableForStates( G4State_PreInit, G4State_Idle );
+	
+    LUXSimParametrizedS2EfficiencyCommand = new G4UIcmdWithADouble( "/LUXSim/physicsList/parametrizedS2Efficiency", this );
+ 	LUXSimParametrizedS2EfficiencyCommand->SetGuidance( "Sets the fraction of S2 photons that make a photoelectron in the" );
+ 	LUXSimParametrizedS2EfficiencyCommand->SetGuidance( "parametrized S2 mode (default 0.1)" );
+	LUXSimParametrizedS2EfficiencyCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
+	
     LUXSimDriftingElectronAttenuationCommand = new G4UIcmdWithADoubleAndUnit( "/LUXSim/physicsList/driftElecAttenuation", this );
  	LUXSimDriftingElectronAttenuationCommand->SetGuidance( "Sets the attenuation length for drifting electrons" );
 	LUXSimDriftingElectronAttenuationCommand->AvailableForStates( G4State_PreInit, G4State_Idle );
@@ -528,6 +678,8 @@ LUXSimMessenger::~LUXSimMessenger()
 	delete LUXSimDir;
 	delete LUXSimBeamOnCommand;
 	delete LUXSimRandomSeedCommand;
+	delete LUXSimPerEventSeedsCommand;
+	delete LUXSimRandomFirstEventCommand;
 
 	//	Input/output commands
 	delete LUXSimFileDir;
@@ -535,6 +687,11 @@ LUXSimMessenger::~LUXSimMessenger()
 	delete LUXSimOutputNameCommand;
 	delete LUXSimAlwaysRecordPrimaryCommand;
     delete LUXSimEventProgressCommand;
+    delete LUXSimOutputBufferSizeCommand;
+    delete LUXSimOutputFlushFrequencyCommand;
+    delete LUXSimOutputFormatCommand;
+    delete LUXSimStepStatisticsCommand;
+    delete LUXSimRecordRunStatisticsCommand;
     delete LUXSim100keVHackCommand;
 
 	// User defined variables commands.
@@ -552,6 +709,8 @@ LUXSimMessenger::~LUXSimMessenger()
 	delete LUXSimDetectorZCommand;
     delete LUXSimComponentSetMassCommand;
     delete LUXSimComponentSetVolumeCommand;
+    delete LUXSimVolumeCacheFileCommand;
+    delete LUXSimVolumeThreadsCommand;
 	delete LUXSimMuonVetoCommand;
 	delete LUXSimLZVetoCommand;
 	delete LUXSimCryoStandCommand;
@@ -602,12 +761,18 @@ LUXSimMessenger::~LUXSimMessenger()
     delete LUXSimLUXDoublePheRateFromFileCommand;
 
     delete LUXFastSimSkewGaussianS2Command;
+    delete LUXSimFastSimLibraryCommand;
+    delete LUXSimFastSimConnectionsCommand;
+    delete LUXSimCompileFastSimLibraryCommand;
 
 	//	Source commands
 	delete LUXSimSourceDir;
 	delete LUXSimSourceSetCommand;
 	delete LUXSimSourceResetCommand;
 	delete LUXSimSourcePrintCommand;
+	delete LUXSimSourceEventListEventsCommand;
+	delete LUXSimSourceStreamEventsCommand;
+	delete LUXSimEventsFileFirstEventCommand;
 
 	//	Physics list commands
 	delete LUXSimPhysicsListDir;
@@ -615,6 +780,8 @@ LUXSimMessenger::~LUXSimMessenger()
 	delete LUXSimOpticalDebugCommand;
     delete LUXSimS1GainCommand;
     delete LUXSimS2GainCommand;
+    delete LUXSimParametrizedS2Command;
+    delete LUXSimParametrizedS2EfficiencyCommand;
 	delete LUXSimDriftingElectronAttenuationCommand;
 	
 	//	Materials commands
@@ -641,6 +808,10 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
 		
 	else if( command == LUXSimRandomSeedCommand )
 		luxManager->SetRandomSeed( LUXSimRandomSeedCommand->GetNewIntValue(newValue) );
+	else if( command == LUXSimPerEventSeedsCommand )
+		luxManager->SetPerEventSeeds( LUXSimPerEventSeedsCommand->GetNewBoolValue(newValue) );
+	else if( command == LUXSimRandomFirstEventCommand )
+		luxManager->SetRandomFirstEvent( LUXSimRandomFirstEventCommand->GetNewIntValue(newValue) );
 		
 	//	Input/output commands
 	else if( command == LUXSimOutputDirCommand )
@@ -651,6 +822,16 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
 		luxManager->SetAlwaysRecordPrimary( LUXSimAlwaysRecordPrimaryCommand->GetNewBoolValue(newValue) );
 	else if( command == LUXSimEventProgressCommand )
 		luxManager->SetEventProgressFrequency( LUXSimEventProgressCommand->GetNewIntValue(newValue) );
+	else if( command == LUXSimOutputBufferSizeCommand )
+		luxManager->SetOutputBufferSize( LUXSimOutputBufferSizeCommand->GetNewIntValue(newValue) );
+	else if( command == LUXSimOutputFlushFrequencyCommand )
+		luxManager->SetOutputFlushFrequency( LUXSimOutputFlushFrequencyCommand->GetNewIntValue(newValue) );
+	else if( command == LUXSimOutputFormatCommand )
+		luxManager->SetOutputFormat( LUXSimOutputFormatCommand->GetNewIntValue(newValue) );
+	else if( command == LUXSimStepStatisticsCommand )
+		luxManager->GetRunStatistics()->SetStepStatistics( LUXSimStepStatisticsCommand->GetNewBoolValue(newValue) );
+	else if( command == LUXSimRecordRunStatisticsCommand )
+		luxManager->SetRecordRunStatistics( LUXSimRecordRunStatisticsCommand->GetNewBoolValue(newValue) );
 	else if( command == LUXSim100keVHackCommand )
 		luxManager->Set100keVHack( LUXSim100keVHackCommand->GetNewDoubleValue( newValue.data() ) );
 
@@ -685,6 +866,14 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
     else if( command == LUXSimComponentSetVolumeCommand )
         luxManager->SetComponentVolume( newValue );
 	
+    else if( command == LUXSimVolumeCacheFileCommand )
+        luxManager->SetVolumeCacheFile( newValue == "none" ? G4String("") :
+                newValue );
+	
+    else if( command == LUXSimVolumeThreadsCommand )
+        luxManager->SetVolumeThreads(
+                LUXSimVolumeThreadsCommand->GetNewIntValue(newValue) );
+	
 	else if( command == LUXSimMuonVetoCommand )
 		luxManager->SetMuonVetoSelection( newValue );
 
@@ -814,6 +1003,15 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
 	else if( command == LUXFastSimSkewGaussianS2Command )
 		luxManager->SetLUXFastSimSkewGaussianS2( LUXFastSimSkewGaussianS2Command->GetNewBoolValue(newValue) );
 
+	else if( command == LUXSimFastSimLibraryCommand )
+		luxManager->SetFastSimLibrary( newValue );
+
+	else if( command == LUXSimFastSimConnectionsCommand )
+		luxManager->SetFastSimConnections( newValue );
+
+	else if( command == LUXSimCompileFastSimLibraryCommand )
+		luxManager->CompileFastSimLibrary( newValue );
+
 	else if( command == LUXSimCavernRockCommand )
 	  luxManager->SetCavernRockSelection( newValue );
 
@@ -827,6 +1025,15 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
 	else if( command == LUXSimSourcePrintCommand )
 		luxManager->SetPrintEventList( newValue );
 
+	else if( command == LUXSimSourceEventListEventsCommand )
+		luxManager->SetEventListEvents( LUXSimSourceEventListEventsCommand->GetNewIntValue(newValue) );
+
+	else if( command == LUXSimSourceStreamEventsCommand )
+		luxManager->SetStreamEvents( LUXSimSourceStreamEventsCommand->GetNewBoolValue(newValue) );
+
+	else if( command == LUXSimEventsFileFirstEventCommand )
+		luxManager->SetEventsFileFirstEvent( LUXSimEventsFileFirstEventCommand->GetNewIntValue(newValue) );
+
 	//	Physics list commands
 	else if( command == LUXSimOpticalPhotonsCommand )
 		luxManager->SetUseOpticalProcesses( LUXSimOpticalPhotonsCommand->GetNewBoolValue(newValue) );
@@ -840,6 +1047,12 @@ void LUXSimMessenger::SetNewValue( G4UIcommand *command, G4String newValue )
     else if( command == LUXSimS2GainCommand )
         luxManager->SetS2Gain( G4UIcmdWithADouble::GetNewDoubleValue(newValue.data()) );
 	
+    else if( command == LUXSimParametrizedS2Command )
+        luxManager->SetParametrizedS2( LUXSimParametrizedS2Command->GetNewBoolValue(newValue) );
+	
+    else if( command == LUXSimParametrizedS2EfficiencyCommand )
+        luxManager->SetParametrizedS2Efficiency( G4UIcmdWithADouble::GetNewDoubleValue(newValue.data()) );
+	
 	else if( command == LUXSimDriftingElectronAttenuationCommand )
 		luxManager->SetDriftElecAttenuation( G4UIcmdWithADoubleAndUnit::GetNewDoubleValue( newValue.data() ) );
 	
@@ -0,0 +1,261 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimRunStatistics.cc
+*
+* This is the code file for the run statistics. See the header for what is
+* counted and for the format of the summary.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - The summary includes the event list size and the peak
+*				  memory (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <sstream>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+//
+//	LUXSim includes
+//
+#include "LUXSimRunStatistics.hh"
+#include "LUXSimManager.hh"
+#include "LUXSimDetectorComponent.hh"
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+//	How many of the slowest events are listed in the summary
+#define NUM_SLOWEST_EVENTS 10
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					LUXSimRunStatistics()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimRunStatistics::LUXSimRunStatistics()
+{
+	stepStatistics = false;
+	Reset();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					~LUXSimRunStatistics()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimRunStatistics::~LUXSimRunStatistics()
+{}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetWallTime()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4double LUXSimRunStatistics::GetWallTime()
+{
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return now.tv_sec + 1.e-6*now.tv_usec;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Reset()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::Reset()
+{
+	phases.clear();
+
+	eventListPeakEvents = 0;
+	eventListPeakMemory = 0;
+
+	eventStartTime = 0;
+	numTimedEvents = 0;
+	totalEventTime = 0;
+	minEventTime = 0;
+	maxEventTime = 0;
+	slowestEvents.clear();
+
+	lastStepTime = 0;
+	particleSteps.clear();
+	componentSteps.clear();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					FindPhase()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+LUXSimRunStatistics::phase *LUXSimRunStatistics::FindPhase( G4String name )
+{
+	//	There are only a handful of phases, and they are kept in the order
+	//	they were first started
+	for( G4int i=0; i<(G4int)phases.size(); i++ )
+		if( phases[i].name == name )
+			return &phases[i];
+
+	phase newPhase;
+	newPhase.name = name;
+	newPhase.startTime = 0;
+	newPhase.totalTime = 0;
+	newPhase.calls = 0;
+	phases.push_back( newPhase );
+
+	return &phases.back();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					StartPhase()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::StartPhase( G4String name )
+{
+	FindPhase( name )->startTime = GetWallTime();
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					StopPhase()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::StopPhase( G4String name )
+{
+	phase *thePhase = FindPhase( name );
+	if( !thePhase->startTime )
+		return;
+
+	thePhase->totalTime += GetWallTime() - thePhase->startTime;
+	thePhase->startTime = 0;
+	thePhase->calls++;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					BeginEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::BeginEvent()
+{
+	eventStartTime = GetWallTime();
+	lastStepTime = eventStartTime;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					EndEvent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::EndEvent( G4int eventID )
+{
+	if( !eventStartTime )
+		return;
+
+	G4double time = GetWallTime() - eventStartTime;
+	eventStartTime = 0;
+
+	if( !numTimedEvents || time < minEventTime )
+		minEventTime = time;
+	if( !numTimedEvents || time > maxEventTime )
+		maxEventTime = time;
+	totalEventTime += time;
+	numTimedEvents++;
+
+	//	Keep the slowest events sorted, slowest first
+	if( (G4int)slowestEvents.size() == NUM_SLOWEST_EVENTS &&
+			time <= slowestEvents.back().time )
+		return;
+
+	eventTime newEvent;
+	newEvent.eventID = eventID;
+	newEvent.time = time;
+	if( (G4int)slowestEvents.size() < NUM_SLOWEST_EVENTS )
+		slowestEvents.push_back( newEvent );
+	else
+		slowestEvents.back() = newEvent;
+	for( G4int i=slowestEvents.size()-1; i>0 &&
+			slowestEvents[i].time > slowestEvents[i-1].time; i-- ) {
+		eventTime tmp = slowestEvents[i];
+		slowestEvents[i] = slowestEvents[i-1];
+		slowestEvents[i-1] = tmp;
+	}
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CountStep()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::CountStep( std::vector<stepCounter> &counters,
+		G4int index, G4double time )
+{
+	if( index < 0 )
+		return;
+
+	if( index >= (G4int)counters.size() ) {
+		stepCounter empty;
+		empty.steps = 0;
+		empty.time = 0;
+		counters.resize( index+1, empty );
+	}
+
+	counters[index].steps++;
+	counters[index].time += time;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					AddStep()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void LUXSimRunStatistics::AddStep( G4int particleNameID, G4int componentID )
+{
+	//	The time charged to a step is the wall time since the previous step
+	//	(or since the start of the event), so it includes the tracking and
+	//	physics that produced this step as well as the user actions
+	G4double now = GetWallTime();
+	G4double time = lastStepTime ? now - lastStepTime : 0;
+	lastStepTime = now;
+
+	CountStep( particleSteps, particleNameID, time );
+	CountStep( componentSteps, componentID, time );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetSummary()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4String LUXSimRunStatistics::GetSummary()
+{
+	LUXSimManager *luxManager = LUXSimManager::GetManager();
+
+	std::stringstream summary;
+	summary.precision( 9 );
+
+	for( G4int i=0; i<(G4int)phases.size(); i++ )
+		summary << "LUXSimStats phase " << phases[i].name
+				<< " calls=" << phases[i].calls
+				<< " seconds=" << phases[i].totalTime << "\n";
+
+	summary << "LUXSimStats events all count=" << numTimedEvents
+			<< " seconds=" << totalEventTime
+			<< " mean=" << (numTimedEvents ? totalEventTime/numTimedEvents : 0)
+			<< " min=" << minEventTime
+			<< " max=" << maxEventTime << "\n";
+	summary << "LUXSimStats eventList peakEvents=" << eventListPeakEvents
+			<< " peakMB=" << eventListPeakMemory/(1024.*1024.) << "\n";
+
+	//	ru_maxrss is the peak resident set size of the process so far, in kB
+	struct rusage usage;
+	if( !getrusage( RUSAGE_SELF, &usage ) )
+		summary << "LUXSimStats memory peakResidentMB="
+				<< usage.ru_maxrss/1024. << "\n";
+
+	for( G4int i=0; i<(G4int)slowestEvents.size(); i++ )
+		summary << "LUXSimStats slowEvent " << slowestEvents[i].eventID
+				<< " seconds=" << slowestEvents[i].time << "\n";
+
+	for( G4int i=0; i<(G4int)particleSteps.size(); i++ )
+		if( particleSteps[i].steps )
+			summary << "LUXSimStats particle " << luxManager->GetStepName(i)
+					<< " steps=" << particleSteps[i].steps
+					<< " seconds=" << particleSteps[i].time << "\n";
+
+	for( G4int i=0; i<(G4int)componentSteps.size(); i++ ) {
+		if( !componentSteps[i].steps )
+			continue;
+		LUXSimDetectorComponent *component = luxManager->GetComponentByID(i);
+		summary << "LUXSimStats volume "
+				<< ( component ? component->GetName() : G4String("none") )
+				<< " id=" << i
+				<< " steps=" << componentSteps[i].steps
+				<< " seconds=" << componentSteps[i].time << "\n";
+	}
+
+	return summary.str();
+}
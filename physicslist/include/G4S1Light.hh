@@ -2,6 +2,8 @@
 #define G4S1Light_h 1
 
 #include <fstream>
+#include <vector>
+#include <map>
 #include "globals.hh"
 #include "templates.hh"
 #include "Randomize.hh"
@@ -16,6 +18,7 @@
 #include "G4MaterialPropertiesTable.hh"
 #include "G4PhysicsOrderedFreeVector.hh"
 #include "G4ThermalElectron.hh"
+#include "G4S1LightSites.hh"
 
 #include "LUXSimManager.hh"
 
@@ -86,12 +89,6 @@ public: // methods, with descriptions
         G4double GetScintillationExcitationRatio() const;
         // Returns the ratio of the number of excitons to ions. Read above.
 
-        // the next block of functions are for loading XYZ dependent drift times
-        // and radial drift from charging teflon from Scott's COMSOL simulations
-        void LoadXYZDependentDriftTime (G4String driftTimeFile);
-        double GetXYZDependentDriftTime (G4ThreeVector x1);
-        void LoadXYZDependentRadialDrift (G4String radialDriftFile);
-        double GetXYZDependentRadialDrift (G4ThreeVector x1);
         void LoadS1PulseShape(G4String fileName);
         G4double GetLiquidElectronDriftSpeed( G4double, G4double, G4bool, G4int,
                 G4bool, G4double, G4double);
@@ -103,6 +100,15 @@ public: // methods, with descriptions
         inline G4bool UsingLZ() { return usingLZ; };
 
         void LoadDoublePHEProb(G4String);
+        inline G4double GetDoublePHEProb(G4int pmt)
+        { return pmt < (G4int)doublePheProb.size() ? doublePheProb[pmt] : 0.2; }
+        // PMTs beyond those in the double phe file get the usual 20% rate
+
+        G4S1LightSites* GetSites(const G4Material* aMaterial);
+        // Returns the interaction sites of a noble element material, making
+        // them the first time the material is seen
+        void ResetSites(); // clears the sites of all materials (event start)
+        void ResetSitesIfNewEvent(); // ResetSites if this is a new event
 
 protected:
         G4bool fTrackSecondariesFirst; // see above
@@ -112,9 +118,8 @@ protected:
         G4double YieldFactor; // turns scint. on/off
         G4double ExcitationRatio; // N_ex/N_i, the dimensionless ratio of
         //initial excitons to ions
-        G4double xyzDependentDriftTime[251][598]; // grid for drift time
-        G4double xyzDependentRadialDrift[251][598]; // grid for final R position
         G4double s1PulseShape[201];
+        G4S1LightSiteStore interactionSites;
         
 
 private:
@@ -136,7 +141,7 @@ public:
         
         G4double E_RATE_HZ;
 
-        G4double doublePheProb[122];
+        std::vector<G4double> doublePheProb;
 
 private:
         G4bool usingLZ;
@@ -0,0 +1,90 @@
+#ifndef G4S1LightSites_h
+#define G4S1LightSites_h 1
+
+// The interaction sites of G4S1Light, kept apart from the process so that
+// they can be built and checked without the rest of Geant4 (see
+// tools/G4S1LightSitesTest.cc)
+
+#include <vector>
+#include <map>
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+class G4Material;
+
+// Interaction sites that S1 and ionization quanta are being accumulated in,
+// for one noble element material. The site properties are kept in parallel
+// arrays (one entry per site) rather than as numbered material properties, so
+// that a site lookup doesn't need a string key. Slots keep their values until
+// they are reset, exactly as the material properties used to.
+class G4S1LightSites
+{
+public:
+        G4S1LightSites() { gridDelta = cellSize = 0.; numInGrid = 0;
+                           Reset(); }
+
+        void Reset(); // back to no sites, and every slot to its initial state
+        void ResetSite(G4int i); // position, track length, energy and times
+        void EnsureSite(G4int i); // makes slot i exist, with initial values
+        G4int AddSite(const G4ThreeVector& x, G4int n);
+        // Puts a new site at x in slot n, so that there are n+1 sites, and
+        // returns its index
+        G4int FindSite(const G4ThreeVector& x, G4double delta, G4int n);
+        // Returns the first of sites 0 to n-1 closer than delta to x, or -1
+        // if there is none. Past a few sites the search goes through a hash
+        // of cubic cells of side delta, so it only looks at the sites in the
+        // 27 cells around x rather than at all of them
+
+        // the two searches FindSite chooses between, which have to give the
+        // same site. tools/G4S1LightSitesTest checks that they do
+        G4int GridFindSite(const G4ThreeVector& x, G4double delta, G4int n);
+        G4int LinearFindSite(const G4ThreeVector& x, G4double delta, G4int n);
+
+        G4int numSites; // was TOTALNUM_INT_SITES
+        G4double energyDepositTot; // was ENERGY_DEPOSIT_TOT
+        G4double energyDepositGoal; // was ENERGY_DEPOSIT_GOL
+
+        std::vector<G4double> posX, posY, posZ; // POS_X_i, POS_Y_i, POS_Z_i
+        std::vector<G4int> numExc, numIon, numPho, numEle; // N_EXC_i, ...
+        std::vector<G4double> trackLength, energy; // TRACK_i, ENRGY_i
+        std::vector<G4double> time0, time1; // TIME0_i, TIME1_i
+
+private:
+        long long CellIndex(G4double x);
+        G4int CellBucket(long long ix, long long iy, long long iz);
+        void GridInsert(G4int i);
+        void GridRemove(G4int i);
+        void GridRebuild(G4double delta, G4int numBuckets);
+
+        // spatial hash of the sites put down by AddSite and not reset since:
+        // each bucket heads a chain of site indices linked through nextSite
+        G4double gridDelta, cellSize;
+        std::vector<G4int> bucketHead, nextSite;
+        std::vector<char> inGrid;
+        G4int numInGrid;
+};
+
+// The sites of every noble element material the process has seen. An event
+// can have several primaries (events files, AmBe, Kr83m, decay chains...),
+// and the sites of the earlier ones have to stay until they are dumped, so
+// the sites are only cleared by the first primary of each event
+class G4S1LightSiteStore
+{
+public:
+        G4S1LightSiteStore() { runID = eventID = -1; }
+
+        G4S1LightSites* Get(const G4Material* aMaterial)
+        { return &sites[aMaterial]; }
+        // Returns the sites of a material, making them the first time the
+        // material is seen, in their initial state
+        void Reset(); // clears the sites of all materials
+        G4bool StartPrimary(G4int aRunID, G4int anEventID);
+        // Called as each primary starts. Clears the sites if this is the
+        // first primary of an event, and returns whether it did
+
+private:
+        std::map<const G4Material*,G4S1LightSites> sites;
+        G4int runID, eventID; // event the sites were last cleared in
+};
+
+#endif /* G4S1LightSites_h */
@@ -78,6 +78,18 @@ protected:
         G4double ExcitationRatio; // N_ex/N_i
 
 private:
+        G4double PhotonMeanFreePath(G4double ElectricField, G4double nDensity,
+                                    G4int z1);
+        // mean free path for making 1 photon in a gas with the given field
+        // (V/cm) and number density (cm^-3)
+
+        void GenerateParametrizedS2(const G4Track& aTrack, const G4Step& aStep,
+                                    G4int z1, G4double nDensity,
+                                    G4double eDrift, G4double z_start,
+                                    G4double z_anode);
+        // Puts the photoelectrons from the whole S2 of an extracted electron
+        // straight onto the PMTs, instead of making one photon per step
+
 		LUXSimManager *luxManager;
         G4S1Light *theScintProcess;
 
@@ -1,3 +1,6 @@
+#ifndef LUXSimFastSim_HH
+#define LUXSimFastSim_HH 1
+
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
@@ -5,12 +8,12 @@
 #include <fstream>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include "globals.hh"
 #include "G4Poisson.hh"
 #include "Randomize.hh"
 #include "LUXSimManager.hh"
 
-const int numIDs = 2341;
 const int numSGPoints = 1000;
 
 //Used to store plane coefficients in fastSim for quick access, and so
@@ -18,46 +21,129 @@ const int numSGPoints = 1000;
 // electronsToPHE is called.
 
 //20140916 289 replaced by the variable numIDs CFPS
+//20261017 The PMT, position ID and z-level counts are read from the library
+// header rather than fixed at 122, 2341 and 25, and the tables are contiguous
+// float blocks. The detector radii come from the library header, or from the
+// sample positions, rather than always being the LUX ones. (agent)
+//20261017 The library is loaded the first time it is needed, and can be a
+// compiled image (see WriteImage) that is memory-mapped instead of parsed. A
+// library image that can't be used is unmapped again, and the text library is
+// read in its place. (agent)
+//20261017 Added s2PhotonsToPHE for the parametrized S2 in G4S2Light. (agent)
+
+//A compiled library image holds everything the text library and connections
+// file are turned into at load time, including the triangle lookup grid and
+// the plane coefficients. It is the header below, then each section at the
+// offset the header gives, aligned to a cache line. Images are only meant to
+// be read on the kind of machine that wrote them.
+#define FASTSIM_IMAGE_TAG 0x4D53464C
+#define FASTSIM_IMAGE_VERSION 1
+
+struct fastSimImageHeader{
+    int formatTag;
+    int version;
+    int numPMTs;
+    int numIDs;
+    int numZLevels;
+    int pmtStride;
+    long long numTriangles;
+    double inscribedR;
+    double outerR;
+    //Section offsets from the start of the file, in bytes
+    long long zLevelsOffset; //double[numZLevels]
+    long long xByIDOffset; //double[numIDs]
+    long long yByIDOffset; //double[numIDs]
+    long long probabilityOffset; //float[numZLevels][numIDs][pmtStride]
+    long long s2ProbabilityOffset; //float[numIDs][pmtStride]
+    long long triLookupOffset; //int[1000*1000]
+    long long trianglesOffset; //fastSimImageTriangle[numTriangles]
+    long long coeffsOffset; //float[numTriangles][numZLevels+1][3][pmtStride]
+    long long fileSize;
+};
+
+struct fastSimImageTriangle{
+    long long coeffOffset;
+    int cornerID[3];
+    int properlyInitialized;
+};
 
 struct FSimTriangle{
 public:
     FSimTriangle();
-    //[z-level][PMT#][coefficient]
-    double pCoeffs[25][122][3];
-    double tCoeffs[25][122][3];
-    //[PMT#][coefficient]
-    double s2pCoeffs[122][3];
-    double s2tCoeffs[122][3];
+    //Offset of this triangle's plane coefficients in FastSim::coeffs, which
+    // holds [z-level (then S2)][coefficient][PMT#] for every triangle
+    size_t coeffOffset;
     //Sorted least to greatest, < numIDs
     int cornerID[3];
-    
+
     //Debug
     bool properlyInitialized;
 };
 
 class FastSim{
 public:
+    //Uses the library and connections files set in the manager
+    FastSim();
+    //Uses these files whatever the manager says
     FastSim(const char* libraryFilename, const char* connectFileName);
     ~FastSim();
-    void photonsToPHE(int numPhots, double pos[3], double hits[122]);
-    void electronsToPHE(int numElectrons, double pos[3], double hits[122]);
+    //hits is resized to the number of PMTs in the library
+    void photonsToPHE(int numPhots, double pos[3], std::vector<double>& hits);
+    void electronsToPHE(int numElectrons, double pos[3],
+            std::vector<double>& hits);
+    //For S2 light made at pos in the gas gap, rather than for electrons
+    // still in the liquid
+    void s2PhotonsToPHE(int numPhots, double efficiency, double pos[3],
+            std::vector<double>& hits);
+    int GetNumPMTs() { ensureLoaded(); return numPMTs; };
+    //Writes the loaded library out as an image that can be used in place of
+    // the text library and connections file
+    void WriteImage(G4String fileName);
     void print();
 
-private: 
+private:
+    //Where the library comes from, and whether it has been read yet
+    bool followManager;
+    int managerLibraryChanges;
+    G4String libraryName;
+    G4String connectName;
+    bool loaded;
+    //The whole image file, when the library is a mapped image
+    void* mappedImage;
+    size_t mappedSize;
+
+    void ensureLoaded();
+    void load();
+    void loadText(G4String libraryFile);
+    bool loadImage();
+    void unload();
+
+    //Library sizes. A library file that starts with a header line
+    //  FastSimLibrary <numPMTs> <numIDs> <numZLevels> <z level 0> ...
+    //      [<inscribedR> <outerR>] (mm)
+    // sets them; otherwise they are the LUX ones (122 PMTs, 2341 positions
+    // and 25 z-levels, and the LUX radii).
+    int numPMTs;
+    int numIDs;
+    int numZLevels;
+    //Floats between the starts of consecutive PMT rows in the tables, so that
+    // every row starts on a cache line
+    int pmtStride;
+
     //Library Variables
-    std::vector<int> connections[numIDs];
+    std::vector< std::vector<int> > connections;
 
-  
 
-    double xByID[numIDs]; //[position ID] mm
-    double yByID[numIDs]; //[position ID] mm
-    double zLevels[25];
-    double*** probability; //[zLevel][position ID][pmt]
-    double*** meanTime; //[zLevel][position ID][pmt]
-    double** s2Probability; //[position ID][pmt]
-    double** s2meanTime; //[position ID][pmt]
 
-    G4double doublePheProb[122];
+    std::vector<double> xByID; //[position ID] mm
+    std::vector<double> yByID; //[position ID] mm
+    std::vector<double> zLevels;
+    float* probability; //[zLevel][position ID][pmt]
+    float* meanTime; //[zLevel][position ID][pmt]
+    float* s2Probability; //[position ID][pmt]
+    float* s2meanTime; //[position ID][pmt]
+
+    std::vector<G4double> doublePheProb;
 
     int skewCDF_X[numSGPoints];
     double skewCDF_Y[numSGPoints];
@@ -65,27 +151,43 @@ private:
     //Fast lookup variables
     double inscribedR; //mm - needs to be exact
     double outerR; //mm - can be larger than reality
+    //Set when the library header doesn't give the radii
+    bool radiiFromPositions;
     //For triLookup, see the fastSim note for computing indicies.
-    FSimTriangle*** triLookup; //[xIndex][yIndex] (1000x1000)
-    std::map<int,FSimTriangle> triangles;
+    int* triLookup; //[xIndex*1000 + yIndex] index into triangles (1000x1000)
+    std::vector<FSimTriangle> triangles;
+    float* coeffs; //plane coefficients of all the triangles
 
     // Scratch variables are preallocated memory for speed-critical functions.
-    double scratch[2][122];
+    std::vector<double> scratch[2];
+    std::vector<double> scratchProb;
+    std::vector<double> scratchRest;
     double scratchWeights[2];
     int scratchZPositions[2];
 
     //Helper Functions
-    void getProbability(double prob[122], FSimTriangle* source, double pos[3]);
-    void getS2Probability(double prob[122],FSimTriangle* source,double pos[3],LUXSimManager *luxManager);
-
+    float* allocTable(size_t numRows);
+    float* probRow(int zLevel, int id)
+        { return probability + ((size_t)zLevel*numIDs + id)*pmtStride; };
+    float* s2ProbRow(int id)
+        { return s2Probability + (size_t)id*pmtStride; };
+    float* triCoeffs(FSimTriangle* tri, int level)
+        { return coeffs + tri->coeffOffset + (size_t)level*3*pmtStride; };
+
+    void getProbability(double* prob, FSimTriangle* source, double pos[3]);
+    void getS2Probability(double* prob,FSimTriangle* source,double pos[3],LUXSimManager *luxManager);
+
+    bool readLibraryHeader(std::ifstream& libFile);
+    void findRadii();
     bool loadConnections(const char* name);
     void initLookupTable();
     int zToIndex(double inputZ);
     void zIndicies(int* a, int* b, double inputZ);
-    void getInterpolatingPlane(double output[122][3], double** p,
-            int posID[3]);
-    void planeInterpolate(double prob[122], double params[122][3], double x1,
+    void getInterpolatingPlane(float* output, float* p, int posID[3]);
+    void planeInterpolate(double* prob, const float* params, double x1,
             double y1);
+    void distributeToPMTs(int numQuanta, double* prob,
+            std::vector<double>& hits);
     bool isInside(double x1, double y1, int id0, int id1, int id2);
     bool findTriangle(int* indicies, double x, double y);
     bool confine(double* x1, double* y1, double reduce = 1);
@@ -100,3 +202,4 @@ private:
     void initSkewGaussianCDF(double mean, double sigma, double skew);
 };
 
+#endif
@@ -51,10 +51,15 @@
 #include "G4ParticleTypes.hh" //lets you refer to G4OpticalPhoton, etc.
 #include "G4EmProcessSubType.hh" //lets you call this process Scintillation
 #include "G4Version.hh" //tells you what Geant4 version you are running
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4S1Light.hh"
 
 #include "LUXSimDetectorComponent.hh"
 #include "LUXSimFastSim.hh"
+#include "LUXSimFieldMap.hh"
 
 #define MIN_ENE -1*eV //lets you turn NEST off BELOW a certain energy
 #define MAX_ENE 1.*TeV //lets you turn NEST off ABOVE a certain energy
@@ -63,8 +68,7 @@
 #define R_TOL 0.2*mm //tolerance (for edge events)
 G4bool diffusion = true; G4bool FastSimBool = false;
 
-FastSim fastSim("physicslist/src/fastSimLibrary_fromKr_V04.dat",
-        "physicslist/src/fastSimConnections_fromKr_V04.dat");
+FastSim fastSim; //reads the library set in the manager on first use
 G4String ConvertNumberToString ( G4int pmtCall );
 
 G4bool SinglePhase=false, ThomasImelTail=true, OutElectrons=true;
@@ -76,7 +80,6 @@ G4double UnivScreenFunc ( G4double E, G4double Z, G4double A );
 
 G4int BinomFluct(G4int N0, G4double prob); //function for doing fluctuations
 int modPoisRnd ( double poisMean, double preFactor );
-void InitMatPropValues ( G4MaterialPropertiesTable* nobleElementMat );
 
 #define Density_LXe 2.888 //reference density for density-dep. effects
 #define Density_LAr 1.393
@@ -129,6 +132,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  fVeryHighEnergy = false; //initializes or (later) resets this
 	  fAlpha = false; //ditto
 	  fMultipleScattering = false;
+	  ResetSitesIfNewEvent(); //sites of earlier primaries of this event stay
 	}
 
         const G4DynamicParticle* aParticle = aTrack.GetDynamicParticle();
@@ -165,21 +169,11 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	if (ElementB) z2 = (G4int)(ElementB->GetZ()); else z2 = -1;
 	if ( z1==2 || z1==10 || z1==18 || z1==36 || z1==54 ) {
 	  NobleNow = true;
-	  j = (G4int)aMaterial->GetMaterialPropertiesTable()->
-	    GetConstProperty("TOTALNUM_INT_SITES"); //get current number
-	  if ( j < 0 ) {
-	    InitMatPropValues(aMaterial->GetMaterialPropertiesTable());
-	    j = 0; //no sites yet
-	  } //material properties initialized
+	  j = GetSites(aMaterial)->numSites; //get current number
 	} //end of atomic number check
 	if ( z2==2 || z2==10 || z2==18 || z2==36 || z2==54 ) {
 	  NobleLater = true;
-	  j = (G4int)bMaterial->GetMaterialPropertiesTable()->
-	    GetConstProperty("TOTALNUM_INT_SITES");
-	  if ( j < 0 ) {
-	    InitMatPropValues(bMaterial->GetMaterialPropertiesTable());
-	    j = 0; //no sites yet
-	  } //material properties initialized
+	  j = GetSites(bMaterial)->numSites;
 	} //end of atomic number check
 	
 	if ( !NobleNow && !NobleLater )
@@ -208,6 +202,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  aMaterial = bMaterial; inside = true; z1 = z2;
 	  aMaterialPropertiesTable = bMaterial->GetMaterialPropertiesTable();
 	}
+	G4S1LightSites* sites = GetSites(aMaterial); //sites of this material
 	if ( NobleNow && NobleLater && 
 	     aMaterial->GetDensity() != bMaterial->GetDensity() )
 	  InsAndOuts = true;
@@ -237,6 +232,11 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
           G4String radialDriftFile  = luxManager->GetRadialDriftFile();
           luxManager->LoadXYZDependentRadialDrift(radialDriftFile);
         }
+        // the field, drift time and S2 position at this point all come out of
+        // one interpolation of the field map
+        G4double fieldValues[LUXSimFieldMap::kNumValues];
+        if (EFieldFromFile || DriftTimeFromFile)
+          luxManager->GetXYZDependentFieldValues(x1, fieldValues);
 	if ( WIN>0 && TOP>0 && ANE>0 && SRF>0 && GAT>0 && CTH>0 && BOT>0 && PMT>0 ) {
           ElectricField = aMaterialPropertiesTable->GetConstProperty("ELECTRICFIELD");
         }
@@ -253,7 +253,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  else if ( Phase == kStateLiquid ) {
             if (EFieldFromFile) {
   	      if ( x1[2] < TOP && x1[2] > PMT ) {
-                ElectricField = luxManager->GetXYZDependentElectricField (x1);
+                ElectricField = fieldValues[LUXSimFieldMap::kEField];
               }
               else {
                 ElectricField = 0;
@@ -289,8 +289,8 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
           }
 	}
         if ( ElectricField >= 0 ) FieldSign = 1; else FieldSign = -1;
-        if (luxManager->GetDriftTimeFromFile() &&
-            luxManager->GetXYZDependentDriftTime(x1) < 0) { // if drifttime is negative, produce no S2
+        if (DriftTimeFromFile &&
+            fieldValues[LUXSimFieldMap::kDriftTime] < 0) { // if drifttime is negative, produce no S2
             FieldSign = 1;
         }
 	ElectricField = fabs((1e3*ElectricField)/(kilovolt/cm));
@@ -413,7 +413,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	G4double anExcitationEnergy = ((const G4Ions*)(pDef))->
 	  GetExcitationEnergy(); //grab nuclear energy level
         G4double TotalEnergyDeposit = //total energy deposited so far
-          aMaterialPropertiesTable->GetConstProperty( "ENERGY_DEPOSIT_TOT" );
+          sites->energyDepositTot;
 	G4bool convert = false, annihil = false;
 	//set up special cases for pair production and positron annihilation
 	if(pPreStepPoint->GetKineticEnergy()>=(2*electron_mass_c2) && 
@@ -434,16 +434,14 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
           return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
 	//add current deposit to total energy budget
         if ( !annihil ) TotalEnergyDeposit += aStep.GetTotalEnergyDeposit();
-        if ( !convert ) aMaterialPropertiesTable->
-	  AddConstProperty( "ENERGY_DEPOSIT_TOT", TotalEnergyDeposit );
+        if ( !convert ) sites->energyDepositTot = TotalEnergyDeposit;
 	//save current deposit for determining number of quanta produced now
         TotalEnergyDeposit = aStep.GetTotalEnergyDeposit();
 	
 	// check what the current "goal" E is for dumping scintillation,
 	// often the initial kinetic energy of the parent particle, and deal
 	// with all other energy-related matters in this block of code
-	G4double InitialKinetEnergy = aMaterialPropertiesTable->
-	  GetConstProperty( "ENERGY_DEPOSIT_GOL" );
+	G4double InitialKinetEnergy = sites->energyDepositGoal;
 	//if zero, add up initial potential and kinetic energies now
         if ( InitialKinetEnergy == 0 ) {
 	  G4double tE = pPreStepPoint->GetKineticEnergy()+anExcitationEnergy;
@@ -453,8 +451,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  }
 	  if ( fKr83m && ElectricField != 0 && !luxManager->GetGasRun() )
 	    DokeBirks[2] = 0.20;
-          aMaterialPropertiesTable->
-	    AddConstProperty ( "ENERGY_DEPOSIT_GOL", tE );
+          sites->energyDepositGoal = tE;
 	  //excited nucleus is special case where accuracy reduced for total
           //energy deposition because of G4 inaccuracies and scintillation is
 	  //forced-dumped when that nucleus is fully de-excited
@@ -462,42 +459,33 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	}
 	//if a particle is leaving, remove its kinetic energy from the goal
 	//energy, as this will never get deposited (if depositable)
-	if(outside){ aMaterialPropertiesTable->
-	    AddConstProperty("ENERGY_DEPOSIT_GOL",
-	    InitialKinetEnergy-pPostStepPoint->GetKineticEnergy());
-	  if(aMaterialPropertiesTable->
-	     GetConstProperty("ENERGY_DEPOSIT_GOL")<0)
-            aMaterialPropertiesTable->AddConstProperty("ENERGY_DEPOSIT_GOL",0);
+	if(outside){ sites->energyDepositGoal =
+	    InitialKinetEnergy-pPostStepPoint->GetKineticEnergy();
+	  if(sites->energyDepositGoal<0)
+            sites->energyDepositGoal = 0;
 	}
 	//if a particle is coming back into your scintillator, then add its
 	//energy to the goal energy
-	if(inside) { aMaterialPropertiesTable->
-	    AddConstProperty("ENERGY_DEPOSIT_GOL",
-	    InitialKinetEnergy+pPreStepPoint->GetKineticEnergy());
+	if(inside) { sites->energyDepositGoal =
+	    InitialKinetEnergy+pPreStepPoint->GetKineticEnergy();
 	  if ( TotalEnergyDeposit > 0 && InitialKinetEnergy == 0 ) {
-            aMaterialPropertiesTable->AddConstProperty("ENERGY_DEPOSIT_GOL",0);
+            sites->energyDepositGoal = 0;
             TotalEnergyDeposit = .000000;
           }
         }
 	if ( InsAndOuts ) {
-	  aMaterialPropertiesTable->
-	    AddConstProperty("ENERGY_DEPOSIT_GOL",(-0.1*keV)+
-	    InitialKinetEnergy-pPostStepPoint->GetKineticEnergy());
-	  InitialKinetEnergy = bMaterial->GetMaterialPropertiesTable()->
-	    GetConstProperty("ENERGY_DEPOSIT_GOL");
-	  bMaterial->GetMaterialPropertiesTable()->
-	    AddConstProperty("ENERGY_DEPOSIT_GOL",(-0.1*keV)+
-	    InitialKinetEnergy+pPreStepPoint->GetKineticEnergy());
-	  if(aMaterialPropertiesTable->
-	     GetConstProperty("ENERGY_DEPOSIT_GOL")<0)
-	    aMaterialPropertiesTable->AddConstProperty("ENERGY_DEPOSIT_GOL",0);
-	  if ( bMaterial->GetMaterialPropertiesTable()->
-	     GetConstProperty("ENERGY_DEPOSIT_GOL") < 0 )
-	    bMaterial->GetMaterialPropertiesTable()->
-	     AddConstProperty ( "ENERGY_DEPOSIT_GOL", 0 );
+	  G4S1LightSites* bSites = GetSites(bMaterial);
+	  sites->energyDepositGoal = (-0.1*keV)+
+	    InitialKinetEnergy-pPostStepPoint->GetKineticEnergy();
+	  InitialKinetEnergy = bSites->energyDepositGoal;
+	  bSites->energyDepositGoal = (-0.1*keV)+
+	    InitialKinetEnergy+pPreStepPoint->GetKineticEnergy();
+	  if(sites->energyDepositGoal<0)
+	    sites->energyDepositGoal = 0;
+	  if ( bSites->energyDepositGoal < 0 )
+	    bSites->energyDepositGoal = 0;
         }
-	InitialKinetEnergy = aMaterialPropertiesTable->
-	  GetConstProperty("ENERGY_DEPOSIT_GOL"); //grab current goal E
+	InitialKinetEnergy = sites->energyDepositGoal; //grab current goal E
 	if ( annihil ) //if an annihilation occurred, add energy of two gammas
 	  InitialKinetEnergy += 2*electron_mass_c2;
 	//if pair production occurs, then subtract energy to cancel with the
@@ -505,11 +493,9 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	if ( convert )
 	  InitialKinetEnergy -= 2*electron_mass_c2;
 	//update the relevant material property (goal energy)
-	aMaterialPropertiesTable->
-	  AddConstProperty("ENERGY_DEPOSIT_GOL",InitialKinetEnergy);
+	sites->energyDepositGoal = InitialKinetEnergy;
 	if (anExcitationEnergy < 1e-100 && aStep.GetTotalEnergyDeposit()==0 &&
-	aMaterialPropertiesTable->GetConstProperty("ENERGY_DEPOSIT_GOL")==0 &&
-	aMaterialPropertiesTable->GetConstProperty("ENERGY_DEPOSIT_TOT")==0)
+	sites->energyDepositGoal==0 && sites->energyDepositTot==0)
 	  return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
 	
 	G4String procName;
@@ -522,39 +508,28 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	
 	// next 2 codeblocks deal with position-related things
 	if ( fAlpha || InitialKinetEnergy == 9.4*keV ) delta = 1000.*km;
-	G4int i, k, counter = 0; G4double pos[3];
+	G4int i, k, counter = 0;
 	if ( outside ) { //leaving
 	  if ( aParticle->GetPDGcode() == 11 && !OutElectrons )
 	    fMultipleScattering = true;
 	  x1 = x0; //prevents generation of quanta outside active volume
+	  if (EFieldFromFile || DriftTimeFromFile)
+	    luxManager->GetXYZDependentFieldValues(x1, fieldValues);
 	} //no scint. for e-'s that leave
 	
-	char xCoord[80]; char yCoord[80]; char zCoord[80];
-	G4bool exists = false; //for querying whether set-up of new site needed
-	for(i=0;i<j;i++) { //loop over all saved interaction sites
-	  counter = i; //save site# for later use in storing properties
-	  sprintf(xCoord,"POS_X_%d",i); sprintf(yCoord,"POS_Y_%d",i);
-	  sprintf(zCoord,"POS_Z_%d",i);
-	  pos[0] = aMaterialPropertiesTable->GetConstProperty(xCoord);
-	  pos[1] = aMaterialPropertiesTable->GetConstProperty(yCoord);
-	  pos[2] = aMaterialPropertiesTable->GetConstProperty(zCoord);
-	  if ( sqrt(pow(x1[0]-pos[0],2.)+pow(x1[1]-pos[1],2.)+
-		    pow(x1[2]-pos[2],2.)) < delta ) {
-	    exists = true; break; //we find interaction is close to an old one
-	  }
-	}
+	//look for a saved interaction site close to this one. If there is
+	//none, the quanta go to the last site looked at (counter), which is
+	//what the site-by-site search has always done
+	G4int nearSite = sites->FindSite(x1, delta, j);
+	G4bool exists = (nearSite >= 0); //is set-up of a new site needed?
+	if ( exists ) counter = nearSite;
+	else if ( j > 0 ) counter = j-1;
 	if(!exists && TotalEnergyDeposit) { //current interaction too far away
-	  counter = j;
-	  sprintf(xCoord,"POS_X_%i",j); sprintf(yCoord,"POS_Y_%i",j); 
-	  sprintf(zCoord,"POS_Z_%i",j);
 	  //save 3-space coordinates of the new interaction site
-	  aMaterialPropertiesTable->AddConstProperty( xCoord, x1[0] );
-	  aMaterialPropertiesTable->AddConstProperty( yCoord, x1[1] );
-	  aMaterialPropertiesTable->AddConstProperty( zCoord, x1[2] );
+	  counter = sites->AddSite(x1, j);
 	  j++; //increment number of sites
-          aMaterialPropertiesTable-> //save
-            AddConstProperty( "TOTALNUM_INT_SITES", j );
 	}
+	sites->EnsureSite(counter);
 	
 	// this is where nuclear recoil "L" factor is handled: total yield is
 	// reduced for nuclear recoil as per Lindhard theory
@@ -663,56 +638,43 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	// be redundant by saving seemingly no longer needed exciton and ion
 	// counts, these having been already used to calculate the number of ph
 	// and e- above, whereas it does need this later for Thomas-Imel model
-	char numExc[80]; char numIon[80]; char numPho[80]; char numEle[80];
-	sprintf(numExc,"N_EXC_%i",counter); sprintf(numIon,"N_ION_%i",counter);
-	NumExcitons += (G4int)aMaterialPropertiesTable->
-	  GetConstProperty( numExc );
-        NumIons     += (G4int)aMaterialPropertiesTable->
-	  GetConstProperty( numIon );
-        aMaterialPropertiesTable->AddConstProperty( numExc, NumExcitons );
-        aMaterialPropertiesTable->AddConstProperty( numIon, NumIons     );
-        sprintf(numPho,"N_PHO_%i",counter); sprintf(numEle,"N_ELE_%i",counter);
-	NumPhotons   +=(G4int)aMaterialPropertiesTable->
-	  GetConstProperty( numPho );
-	NumElectrons +=(G4int)aMaterialPropertiesTable->
-	  GetConstProperty( numEle );
-	aMaterialPropertiesTable->AddConstProperty( numPho, NumPhotons   );
-	aMaterialPropertiesTable->AddConstProperty( numEle, NumElectrons );
+	NumExcitons += sites->numExc[counter];
+        NumIons     += sites->numIon[counter];
+        sites->numExc[counter] = NumExcitons;
+        sites->numIon[counter] = NumIons;
+	NumPhotons   += sites->numPho[counter];
+	NumElectrons += sites->numEle[counter];
+	sites->numPho[counter] = NumPhotons;
+	sites->numEle[counter] = NumElectrons;
 	
 	// increment and save the total track length, and save interaction
 	// times for later, when generating the scintillation quanta
-	char trackL[80]; char time00[80]; char time01[80]; char energy[80];
-	sprintf(trackL,"TRACK_%i",counter); sprintf(energy,"ENRGY_%i",counter);
-	sprintf(time00,"TIME0_%i",counter); sprintf(time01,"TIME1_%i",counter);
-	delta = aMaterialPropertiesTable->GetConstProperty( trackL );
-	G4double energ = aMaterialPropertiesTable->GetConstProperty( energy );
+	delta = sites->trackLength[counter];
+	G4double energ = sites->energy[counter];
 	delta += dx*cm; energ += dE*MeV;
-	aMaterialPropertiesTable->AddConstProperty( trackL, delta );
-	aMaterialPropertiesTable->AddConstProperty( energy, energ );
+	sites->trackLength[counter] = delta;
+	sites->energy[counter] = energ;
 	if ( TotalEnergyDeposit > 0 ) {
-	  G4double deltaTime = aMaterialPropertiesTable->
-	    GetConstProperty( time00 );
+	  G4double deltaTime = sites->time0[counter];
 	  //for charged particles, which continuously lose energy, use initial
 	  //interaction time as the minimum time, otherwise use only the final
 	  if( aParticle->GetCharge() != 0 || InitialKinetEnergy == 9.4*keV ) {
 	    if (t0 < deltaTime)
-	      aMaterialPropertiesTable->AddConstProperty( time00, t0 );
+	      sites->time0[counter] = t0;
 	  }
 	  else {
 	    if (t1 < deltaTime)
-	      aMaterialPropertiesTable->AddConstProperty( time00, t1 );
+	      sites->time0[counter] = t1;
 	  }
-	  deltaTime = aMaterialPropertiesTable->GetConstProperty( time01 );
+	  deltaTime = sites->time1[counter];
 	  //find the maximum possible scintillation "birth" time
 	  if (t1 > deltaTime)
-	    aMaterialPropertiesTable->AddConstProperty( time01, t1 );
+	    sites->time1[counter] = t1;
 	}
 	
 	// begin the process of setting up creation of scint./ionization
-	TotalEnergyDeposit=aMaterialPropertiesTable->
-	  GetConstProperty("ENERGY_DEPOSIT_TOT"); //get the total E deposited
-	InitialKinetEnergy=aMaterialPropertiesTable->
-	  GetConstProperty("ENERGY_DEPOSIT_GOL"); //E that should have been
+	TotalEnergyDeposit=sites->energyDepositTot; //get the total E deposited
+	InitialKinetEnergy=sites->energyDepositGoal; //E that should have been
 	if(InitialKinetEnergy > HIENLIM && 
 	   abs(aParticle->GetPDGcode()) != 2112) fVeryHighEnergy=true;
 	G4double safety; //margin of error for TotalE.. - InitialKinetEnergy
@@ -736,16 +698,13 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  //calculate the total number of quanta from all sites and all
 	  //interactions so that the number of secondaries gets set correctly
 	  NumPhotons = 0; NumElectrons = 0;
+	  sites->EnsureSite(j-1);
 	  for(i=0;i<j;i++) {
-	    sprintf(numPho,"N_PHO_%d",i); sprintf(numEle,"N_ELE_%d",i);
-	    NumPhotons  +=(G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numPho );
-            NumElectrons+=(G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numEle );
-	    sprintf(trackL,"TRACK_%d",i); sprintf(energy,"ENRGY_%d",i);
+	    NumPhotons  += sites->numPho[i];
+            NumElectrons+= sites->numEle[i];
 	    //add up track lengths of all sites, for a total LET calc (later)
-            dx += aMaterialPropertiesTable->GetConstProperty(trackL);
-	    dE += aMaterialPropertiesTable->GetConstProperty(energy);
+            dx += sites->trackLength[i];
+	    dE += sites->energy[i];
 	  }
 	  if ( luxManager->GetS1Gain() < 1. && luxManager->GetS2Gain() < 1. )
 	    FastSimBool = true;
@@ -759,22 +718,14 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  
 	  // begin the loop over all sites which generates all the quanta
 	  for(i=0;i<j;i++) {
-	    // get the position X,Y,Z, exciton and ion numbers, total track 
-	    // length of the site, and interaction times
-	    sprintf(xCoord,"POS_X_%d",i); sprintf(yCoord,"POS_Y_%d",i);
-	    sprintf(zCoord,"POS_Z_%d",i);
-	    sprintf(numExc,"N_EXC_%d",i); sprintf(numIon,"N_ION_%d",i);
-	    sprintf(numPho,"N_PHO_%d",i); sprintf(numEle,"N_ELE_%d",i);
-	    NumExcitons = (G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numExc );
-	    NumIons     = (G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numIon );
-	    sprintf(trackL,"TRACK_%d",i); sprintf(energy,"ENRGY_%d",i);
-	    sprintf(time00,"TIME0_%d",i); sprintf(time01,"TIME1_%d",i);
-	    delta = aMaterialPropertiesTable->GetConstProperty( trackL );
-	    energ = aMaterialPropertiesTable->GetConstProperty( energy );
-	    t0 = aMaterialPropertiesTable->GetConstProperty( time00 );
-	    t1 = aMaterialPropertiesTable->GetConstProperty( time01 );
+	    // get the exciton and ion numbers, total track length of the
+	    // site, and interaction times
+	    NumExcitons = sites->numExc[i];
+	    NumIons     = sites->numIon[i];
+	    delta = sites->trackLength[i];
+	    energ = sites->energy[i];
+	    t0 = sites->time0[i];
+	    t1 = sites->time1[i];
 	    
 	    //if site is small enough, override the Doke/Birks' model with
 	    //Thomas-Imel, but not if we're dealing with super-high energy 
@@ -865,10 +816,8 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
                 NumPhotons = NumQuanta;
               }
 	      //override Doke NumPhotons and NumElectrons
-	      aMaterialPropertiesTable->
-		AddConstProperty( numPho, NumPhotons   );
-	      aMaterialPropertiesTable->
-		AddConstProperty( numEle, NumElectrons );
+	      sites->numPho[i] = NumPhotons;
+	      sites->numEle[i] = NumElectrons;
 	    }
             if(!recombProb ||
                InitialKinetEnergy/keV <= tibCurlZ) {
@@ -877,10 +826,8 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
             }
 	    // grab NumPhotons/NumElectrons, which come from Birks if
 	    // the Thomas-Imel block of code above was not executed
-            NumPhotons  = (G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numPho );
-            NumElectrons =(G4int)aMaterialPropertiesTable->
-	      GetConstProperty( numEle );
+            NumPhotons  = sites->numPho[i];
+            NumElectrons = sites->numEle[i];
 	    
             int NumQuenched;
 	    if ( 0 ) { ;}
@@ -895,8 +842,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	      if ( ! FastSimBool ) NumPhotons =
 		BinomFluct(NumPhotons,luxManager->GetS1Gain());
 	    } if (FastSimBool) NumElectrons = BinomFluct(NumElectrons,
-	      exp(-(BORDER-aMaterialPropertiesTable->GetConstProperty
-		    (zCoord))/luxManager->GetDriftElecAttenuation()));
+	      exp(-(BORDER-sites->posZ[i])/luxManager->GetDriftElecAttenuation()));
 	    if ( luxManager->GetS2Gain() < 1.0 ) NumElectrons =
 		BinomFluct(NumElectrons,luxManager->GetS2Gain());
 	    else NumElectrons = 
@@ -911,19 +857,20 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	    if ( SinglePhase ) //for a 1-phase det. don't propagate e-'s
 	      NumElectrons = 0; //saves simulation time
 	    
-	    // reset material properties numExc, numIon, numPho, numEle, as
-	    // their values have been used or stored elsewhere already
-	    aMaterialPropertiesTable->AddConstProperty( numExc, 0 );
-	    aMaterialPropertiesTable->AddConstProperty( numIon, 0 );
-	    aMaterialPropertiesTable->AddConstProperty( numPho, 0 );
-	    aMaterialPropertiesTable->AddConstProperty( numEle, 0 );
+	    // reset the site's numExc, numIon, numPho, numEle, as their
+	    // values have been used or stored elsewhere already
+	    sites->numExc[i] = 0;
+	    sites->numIon[i] = 0;
+	    sites->numPho[i] = 0;
+	    sites->numEle[i] = 0;
 	    
-	    double s1Hits[122], s2Hits[122], timing[100000], timeBase=-1.;
+	    std::vector<double> s1Hits, s2Hits; //one entry per FastSim PMT
+	    double timing[100000], timeBase=-1.;
 	    if ( FastSimBool ) {
 	      double origin[3]; timeBase = t0+G4UniformRand()*(t1-t0)+evtStrt;
-	      origin[0] = aMaterialPropertiesTable->GetConstProperty( xCoord );
-	      origin[1] = aMaterialPropertiesTable->GetConstProperty( yCoord );
-	      origin[2] = aMaterialPropertiesTable->GetConstProperty( zCoord );
+	      origin[0] = sites->posX[i];
+	      origin[1] = sites->posY[i];
+	      origin[2] = sites->posZ[i];
 //	      NumPhotons = floor(NumPhotons*luxManager->GetS1Gain()/0.14+0.5);
               // Fasts sims will take in number of quanta and deal with binomial fluctuations internally
 	      fastSim.photonsToPHE(NumPhotons,origin,s1Hits);
@@ -998,7 +945,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 		  }
 		  else {
                     if (luxManager->GetDriftTimeFromFile()) {
-                      G4double calculatedDriftTime = luxManager->GetXYZDependentDriftTime(x1);
+                      G4double calculatedDriftTime = fieldValues[LUXSimFieldMap::kDriftTime];
 		      sampledEnergy = GetLiquidElectronDriftSpeed(
 		      Temperature, ElectricField, MillerDriftSpeed, z1, luxManager->GetDriftTimeFromFile(), x1[2], calculatedDriftTime);
                     }
@@ -1112,9 +1059,9 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	      // being mistakenly generated outside of your active region by
 	      // Geant4, but real-life finite detector position resolution
 	      // wipes out any effects from here anyway...
-	      x0[0] = aMaterialPropertiesTable->GetConstProperty( xCoord );
-	      x0[1] = aMaterialPropertiesTable->GetConstProperty( yCoord );
-	      x0[2] = aMaterialPropertiesTable->GetConstProperty( zCoord );
+	      x0[0] = sites->posX[i];
+	      x0[1] = sites->posY[i];
+	      x0[2] = sites->posZ[i];
 	      G4double radius = sqrt(pow(x0[0],2.)+pow(x0[1],2.));
 	      //re-scale radius to ensure no generation of quanta outside
               //the active volume of your simulation due to Geant4 rounding
@@ -1144,7 +1091,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
                 G4double sigmaDT;
                 G4double sigmaDL;
                 if (luxManager->GetDriftTimeFromFile()) { // determine whether to use drift velocity of COMSOL sim
-                  driftTime = luxManager->GetXYZDependentDriftTime(x1);
+                  driftTime = fieldValues[LUXSimFieldMap::kDriftTime];
  		  sigmaDT = sqrt(2*D_T*driftTime);
 		  sigmaDL = sqrt(2*D_L*driftTime);
                 }
@@ -1208,7 +1155,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	      if ( aSecondaryTime < 0 ) aSecondaryTime = 0; //no neg. time
 	      if ( FastSimBool ) { G4String PMTvolName;
                 LoadS1PulseShape("physicslist/src/S1PulseShape.dat");
-		for(G4int q1 = 0; q1 < 122; q1++) {
+		for(G4int q1 = 0; q1 < fastSim.GetNumPMTs(); q1++) {
 		  for(unsigned int q2 = 0; q2 < s1Hits[q1]; q2++) {
 		    double UniRand=G4UniformRand();
                     aSecondaryTime=timeBase;
@@ -1236,7 +1183,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
                     //For each photon there is a 20% chance that two phe are produced... at least this is what we're told
                     randDphe = G4UniformRand();
                     if (luxManager->GetLUXDoublePheRateFromFile()) {
-	              if (randDphe < doublePheProb[q1]) {
+	              if (randDphe < GetDoublePHEProb(q1)) {
 		        G4DynamicParticle * aPhe = new G4DynamicParticle(
   		        G4ThermalElectron::ThermalElectron(),
 		        G4ParticleMomentum(0,0,0));
@@ -1276,7 +1223,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
                       //For each photon there is a 20% chance that two phe are produced... at least this is what we're told
                       randDphe = G4UniformRand();
                       if (luxManager->GetLUXDoublePheRateFromFile()) {
-  	                if (randDphe < doublePheProb[q1]) {
+  	                if (randDphe < GetDoublePHEProb(q1)) {
 		          G4DynamicParticle * aPhe = new G4DynamicParticle(
   		          G4ThermalElectron::ThermalElectron(),
 		          G4ParticleMomentum(0,0,0));
@@ -1299,7 +1246,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
                       }
                     }
                   } //end placement of S2 phe
-		} //end loop over all 122 PMTs
+		} //end loop over all the PMTs
 	      } //end fast simulation method which teleports final phe
 	      else { G4Track * aSecondaryTrack = 
 		  new G4Track(aQuantum,aSecondaryTime,aSecondaryPosition);
@@ -1309,13 +1256,7 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	    }
 
 	    //reset bunch of things when done with an interaction site
-	    aMaterialPropertiesTable->AddConstProperty( xCoord, 999*km );
-	    aMaterialPropertiesTable->AddConstProperty( yCoord, 999*km );
-	    aMaterialPropertiesTable->AddConstProperty( zCoord, 999*km );
-	    aMaterialPropertiesTable->AddConstProperty( trackL, 0*um );
-	    aMaterialPropertiesTable->AddConstProperty( energy, 0*eV );
-	    aMaterialPropertiesTable->AddConstProperty( time00, DBL_MAX );
-	    aMaterialPropertiesTable->AddConstProperty( time01, -1*ns );
+	    sites->ResetSite(i);
 	    
 	    if (verboseLevel>0) { //more verbose stuff
 	      G4cout << "\n Exiting from G4S1Light::DoIt -- "
@@ -1325,12 +1266,9 @@ G4S1Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	  } //end of interaction site loop
 
 	  //more things to reset...
-	  aMaterialPropertiesTable->
-	    AddConstProperty( "TOTALNUM_INT_SITES", 0 );
-	  aMaterialPropertiesTable->
-	    AddConstProperty( "ENERGY_DEPOSIT_TOT", 0*keV );
-	  aMaterialPropertiesTable->
-	    AddConstProperty( "ENERGY_DEPOSIT_GOL", 0*MeV );
+	  sites->numSites = 0;
+	  sites->energyDepositTot = 0*keV;
+	  sites->energyDepositGoal = 0*MeV;
 	  fExcitedNucleus = false;
 	  fAlpha = false;
 	  
@@ -1575,39 +1513,22 @@ G4int BinomFluct ( G4int N0, G4double prob ) {
   return N1;
 }
 
-void InitMatPropValues ( G4MaterialPropertiesTable *nobleElementMat ) {
-  char xCoord[80]; char yCoord[80]; char zCoord[80];
-  char numExc[80]; char numIon[80]; char numPho[80]; char numEle[80];
-  char trackL[80]; char time00[80]; char time01[80]; char energy[80];
-  
-  // for loop to initialize the interaction site mat'l properties
-  for( G4int i=0; i<10000; i++ ) {
-    sprintf(xCoord,"POS_X_%d",i); sprintf(yCoord,"POS_Y_%d",i);
-    sprintf(zCoord,"POS_Z_%d",i);
-    nobleElementMat->AddConstProperty( xCoord, 999*km );
-    nobleElementMat->AddConstProperty( yCoord, 999*km );
-    nobleElementMat->AddConstProperty( zCoord, 999*km );
-    sprintf(numExc,"N_EXC_%d",i); sprintf(numIon,"N_ION_%d",i);
-    sprintf(numPho,"N_PHO_%d",i); sprintf(numEle,"N_ELE_%d",i);
-    nobleElementMat->AddConstProperty( numExc, 0 );
-    nobleElementMat->AddConstProperty( numIon, 0 );
-    nobleElementMat->AddConstProperty( numPho, 0 );
-    nobleElementMat->AddConstProperty( numEle, 0 );
-    sprintf(trackL,"TRACK_%d",i); sprintf(energy,"ENRGY_%d",i);
-    sprintf(time00,"TIME0_%d",i); sprintf(time01,"TIME1_%d",i);
-    nobleElementMat->AddConstProperty( trackL, 0*um );
-    nobleElementMat->AddConstProperty( energy, 0*eV );
-    nobleElementMat->AddConstProperty( time00, DBL_MAX );
-    nobleElementMat->AddConstProperty( time01,-1*ns );
-  }
-  
-  // we initialize the total number of interaction sites, a variable for
-  // updating the amount of energy deposited thus far in the medium, and a
-  // variable for storing the amount of energy expected to be deposited
-  nobleElementMat->AddConstProperty( "TOTALNUM_INT_SITES", 0 );
-  nobleElementMat->AddConstProperty( "ENERGY_DEPOSIT_TOT", 0*keV );
-  nobleElementMat->AddConstProperty( "ENERGY_DEPOSIT_GOL", 0*MeV );
-  return;
+G4S1LightSites* G4S1Light::GetSites ( const G4Material* aMaterial ) {
+  // the sites are made the first time a noble element material is seen,
+  // in their initial state, like the material properties used to be
+  return interactionSites.Get(aMaterial);
+}
+
+void G4S1Light::ResetSites ( ) {
+  interactionSites.Reset();
+}
+
+void G4S1Light::ResetSitesIfNewEvent ( ) {
+  const G4Event* anEvent =
+    G4EventManager::GetEventManager()->GetConstCurrentEvent();
+  const G4Run* aRun = G4RunManager::GetRunManager()->GetCurrentRun();
+  if ( !anEvent || !aRun ) return;
+  interactionSites.StartPrimary(aRun->GetRunID(),anEvent->GetEventID());
 }
 
 G4double UnivScreenFunc ( G4double E, G4double Z, G4double A ) {
@@ -1737,8 +1658,9 @@ void G4S1Light::LoadDoublePHEProb(G4String fileName) {
     G4cout<<G4endl<<G4endl<<G4endl;
     exit(0);
   }
-  for (int i = 0; i < 122; i++) {
-    file >> doublePheProb[i];
-  }
+  //one probability per PMT, for as many PMTs as the file lists
+  doublePheProb.clear();
+  G4double prob;
+  while ( file >> prob ) doublePheProb.push_back(prob);
   file.close();
 }
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////
+// Interaction sites of the G4S1Light process
+////////////////////////////////////////////////////////////////////////
+//
+// File:        G4S1LightSites.cc (lives in physicslist/src)
+// Description: Sites the S1 and ionization quanta of an event are
+//              accumulated in, and the search for the one near a step,
+//              split out of G4S1Light.cc
+//
+////////////////////////////////////////////////////////////////////////
+
+#include <cfloat>
+#include <cmath>
+
+#include "G4S1LightSites.hh"
+
+void G4S1LightSites::Reset ( ) {
+  // we initialize the total number of interaction sites, a variable for
+  // updating the amount of energy deposited thus far in the medium, and a
+  // variable for storing the amount of energy expected to be deposited.
+  // Emptying the arrays puts every slot back in its initial state, since
+  // slots are re-made with their initial values when needed
+  numSites = 0;
+  energyDepositTot = 0*keV;
+  energyDepositGoal = 0*MeV;
+  posX.clear(); posY.clear(); posZ.clear();
+  numExc.clear(); numIon.clear(); numPho.clear(); numEle.clear();
+  trackLength.clear(); energy.clear(); time0.clear(); time1.clear();
+  nextSite.clear(); inGrid.clear(); numInGrid = 0;
+  bucketHead.assign(bucketHead.size(),-1); //keeps the hash size and delta
+  return;
+}
+
+void G4S1LightSites::EnsureSite ( G4int i ) {
+  if ( i < (G4int)posX.size() ) return;
+  G4int n = i+1;
+  posX.resize(n,999*km); posY.resize(n,999*km); posZ.resize(n,999*km);
+  numExc.resize(n,0); numIon.resize(n,0); numPho.resize(n,0);
+  numEle.resize(n,0);
+  trackLength.resize(n,0*um); energy.resize(n,0*eV);
+  time0.resize(n,DBL_MAX); time1.resize(n,-1*ns);
+  nextSite.resize(n,-1); inGrid.resize(n,0);
+  return;
+}
+
+void G4S1LightSites::ResetSite ( G4int i ) {
+  GridRemove(i); //has to come off the hash before its position changes
+  posX[i] = 999*km; posY[i] = 999*km; posZ[i] = 999*km;
+  trackLength[i] = 0*um; energy[i] = 0*eV;
+  time0[i] = DBL_MAX; time1[i] = -1*ns;
+  return;
+}
+
+G4int G4S1LightSites::AddSite ( const G4ThreeVector& x, G4int n ) {
+  // the new site goes in slot n, and there are n+1 sites from then on
+  EnsureSite(n);
+  GridRemove(n);
+  posX[n] = x.x(); posY[n] = x.y(); posZ[n] = x.z();
+  GridInsert(n);
+  numSites = n+1;
+  return n;
+}
+
+G4int G4S1LightSites::FindSite ( const G4ThreeVector& x, G4double delta,
+				 G4int n ) {
+  // a handful of sites are quicker to scan than to hash. So is an alpha's
+  // delta of 1000 km, where every real site is inside the same cell
+  if ( n <= 0 ) return -1;
+  EnsureSite(n-1);
+  if ( n < 16 || !(delta > 0.) || delta > 1.*km )
+    return LinearFindSite(x,delta,n);
+  return GridFindSite(x,delta,n);
+}
+
+G4int G4S1LightSites::LinearFindSite ( const G4ThreeVector& x,
+				       G4double delta, G4int n ) {
+  // distances to the first n sites are worked out a block at a time with no
+  // branches, so that the compiler can vectorize them, and the block is
+  // then scanned for the first site (lowest index) closer than delta
+  const G4double x0 = x.x(), x1 = x.y(), x2 = x.z();
+  const G4double *px = &posX[0], *py = &posY[0], *pz = &posZ[0];
+  G4double dist[8];
+  for ( G4int first = 0; first < n; first += 8 ) {
+    G4int num = n - first; if ( num > 8 ) num = 8;
+    for ( G4int i = 0; i < num; i++ ) {
+      G4double dx = x0-px[first+i], dy = x1-py[first+i], dz = x2-pz[first+i];
+      dist[i] = sqrt(dx*dx+dy*dy+dz*dz);
+    }
+    for ( G4int i = 0; i < num; i++ )
+      if ( dist[i] < delta ) return first+i;
+  }
+  return -1;
+}
+
+G4int G4S1LightSites::GridFindSite ( const G4ThreeVector& x, G4double delta,
+				     G4int n ) {
+  // a site closer than delta is at most one cell away along each axis, so
+  // the 27 cells around x hold every candidate. Of those closer than delta,
+  // the lowest index is the one the linear scan would have stopped at. The
+  // distance is worked out exactly as in the scan, so that sites right on
+  // the delta boundary go the same way
+  if ( delta != gridDelta || bucketHead.empty() ) {
+    G4int numBuckets = 1024;
+    while ( numBuckets < numInGrid ) numBuckets *= 2;
+    GridRebuild(delta,numBuckets);
+  }
+  const G4double x0 = x.x(), x1 = x.y(), x2 = x.z();
+  long long cx = CellIndex(x0), cy = CellIndex(x1), cz = CellIndex(x2);
+  G4int best = -1;
+  for ( G4int ix = -1; ix <= 1; ix++ ) {
+    for ( G4int iy = -1; iy <= 1; iy++ ) {
+      for ( G4int iz = -1; iz <= 1; iz++ ) {
+	G4int site = bucketHead[CellBucket(cx+ix,cy+iy,cz+iz)];
+	for ( ; site >= 0; site = nextSite[site] ) {
+	  if ( site >= n || ( best >= 0 && site >= best ) ) continue;
+	  G4double dx = x0-posX[site], dy = x1-posY[site], dz = x2-posZ[site];
+	  if ( sqrt(dx*dx+dy*dy+dz*dz) < delta ) best = site;
+	}
+      }
+    }
+  }
+  return best;
+}
+
+long long G4S1LightSites::CellIndex ( G4double x ) {
+  return (long long)floor(x/cellSize);
+}
+
+G4int G4S1LightSites::CellBucket ( long long ix, long long iy, long long iz ) {
+  unsigned long long hash = (unsigned long long)ix*73856093ULL ^
+    (unsigned long long)iy*19349663ULL ^ (unsigned long long)iz*83492791ULL;
+  return G4int(hash & (unsigned long long)(bucketHead.size()-1));
+}
+
+void G4S1LightSites::GridInsert ( G4int i ) {
+  inGrid[i] = 1; numInGrid++;
+  if ( bucketHead.empty() ) return; //no hash until the first search needs it
+  if ( numInGrid > 2*G4int(bucketHead.size()) ) { //keep the chains short
+    GridRebuild(gridDelta,2*G4int(bucketHead.size()));
+    return;
+  }
+  G4int bucket =
+    CellBucket(CellIndex(posX[i]),CellIndex(posY[i]),CellIndex(posZ[i]));
+  nextSite[i] = bucketHead[bucket];
+  bucketHead[bucket] = i;
+  return;
+}
+
+void G4S1LightSites::GridRemove ( G4int i ) {
+  if ( !inGrid[i] ) return;
+  inGrid[i] = 0; numInGrid--;
+  if ( bucketHead.empty() ) return;
+  G4int *link = &bucketHead[CellBucket(CellIndex(posX[i]),CellIndex(posY[i]),
+					   CellIndex(posZ[i]))];
+  while ( *link >= 0 && *link != i ) link = &nextSite[*link];
+  if ( *link == i ) *link = nextSite[i];
+  nextSite[i] = -1;
+  return;
+}
+
+void G4S1LightSites::GridRebuild ( G4double delta, G4int numBuckets ) {
+  // the cells are made a hair wider than delta, so that rounding in the
+  // division can never put two sites closer than delta two cells apart
+  gridDelta = delta;
+  cellSize = delta*(1.+1e-6);
+  bucketHead.assign(numBuckets,-1);
+  for ( G4int i = 0; i < (G4int)inGrid.size(); i++ ) {
+    nextSite[i] = -1;
+    if ( !inGrid[i] ) continue;
+    G4int bucket =
+    CellBucket(CellIndex(posX[i]),CellIndex(posY[i]),CellIndex(posZ[i]));
+    nextSite[i] = bucketHead[bucket];
+    bucketHead[bucket] = i;
+  }
+  return;
+}
+
+void G4S1LightSiteStore::Reset ( ) {
+  std::map<const G4Material*,G4S1LightSites>::iterator it;
+  for ( it = sites.begin(); it != sites.end(); ++it )
+    it->second.Reset();
+  return;
+}
+
+G4bool G4S1LightSiteStore::StartPrimary ( G4int aRunID, G4int anEventID ) {
+  if ( aRunID == runID && anEventID == eventID ) return false;
+  runID = aRunID;
+  eventID = anEventID;
+  Reset();
+  return true;
+}
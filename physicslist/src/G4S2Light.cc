@@ -49,6 +49,8 @@
 #include "G4EmProcessSubType.hh" //lets you call this process Scintillation
 #include "G4S2Light.hh"
 #include "G4S1Light.hh"
+#include "LUXSimFastSim.hh"
+#include "LUXSimDetectorComponent.hh"
 
 #define GRID_DENSITY 8.03*(g/cm3) //density of your grid material
 
@@ -56,6 +58,9 @@ G4double thr[100]; //offset in linear light yield formula for S2 ph/e-
 G4double E_eV[100]; //energy of single photon in gas, eV
 G4double tau1[100], tau3[100], ConvertEff[100];
 
+extern FastSim fastSim; //the S2 light map, shared with G4S1Light
+G4String ConvertNumberToString ( G4int pmtCall );
+
 G4S2Light::G4S2Light( G4String processName,
                      G4ProcessType type, G4S1Light *s1Light)
 : G4VRestDiscreteProcess(processName, type), theScintProcess(s1Light)
@@ -227,6 +232,19 @@ G4S2Light::PostStepDoIt(const G4Track& aTrack, const G4Step& aStep)
 	    else //super e-train
 	      aParticleChange.ProposeWeight(20.e6*ns*log(G4UniformRand()));
 	  } //delay "unextracted" electrons to make "e-trains"
+	  // with the parametrized S2, the electron's whole S2 is made here
+	  if ( luxManager->GetParametrizedS2() ) {
+	    G4double eDrift =
+	      theScintProcess->GetGasElectronDriftSpeed(1000.*ElectricField,
+							nDensity);
+	    GenerateParametrizedS2(aTrack,aStep,z1,nDensity,eDrift,
+				   z_start,z_anode);
+	    G4double KE = aParticle->GetKineticEnergy();
+	    aParticleChange.ProposeTrackStatus(fStopAndKill);
+	    aParticleChange.ProposeEnergy(0.);
+	    aParticleChange.ProposeLocalEnergyDeposit(KE);
+	    return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
+	  }
 	}
 	
 	if ( G4UniformRand () >= luxManager->GetS1Gain() )
@@ -346,8 +364,24 @@ G4double G4S2Light::GetMeanFreePath(const G4Track& aTrack,
    G4double ElectricField = fabs(aMaterialPropertiesTable->
 				  GetConstProperty("ELECTRICFIELDANODE"));
     ElectricField = ElectricField/(volt/cm);
-    G4double mfp, nDensity = 
-      aMaterial->GetElectronDensity()*cm3/G4double(z1);
+    G4double nDensity = aMaterial->GetElectronDensity()*cm3/G4double(z1);
+    return PhotonMeanFreePath(ElectricField,nDensity,z1);
+  }
+  else {
+    *condition = NotForced;
+    const G4Material* aMaterial = aTrack.GetMaterial();
+    if ( aMaterial->GetDensity() == GRID_DENSITY )
+      return DBL_MAX; //pass electrons through grid wires
+    return 0*nm; //kill elsewhere
+  }
+}
+
+// PhotonMeanFreePath
+// ------------------
+G4double G4S2Light::PhotonMeanFreePath(G4double ElectricField,
+                                       G4double nDensity, G4int z1)
+{
+    G4double mfp;
     if ( (1/E_eV[z1])*(ElectricField/nDensity)*1e17 == thr[z1] ) mfp = 0*cm;
     else //denominator of formula OK
       mfp = 1 / 
@@ -357,13 +391,83 @@ G4double G4S2Light::GetMeanFreePath(const G4Track& aTrack,
       if(mfp<0)mfp=0;
       if(mfp>theScintProcess->GASGAP/2.7)mfp=theScintProcess->GASGAP/exp(1);
     return mfp; //mean free path for 1 photon
-  }
-  else {
-    *condition = NotForced;
-    const G4Material* aMaterial = aTrack.GetMaterial();
-    if ( aMaterial->GetDensity() == GRID_DENSITY )
-      return DBL_MAX; //pass electrons through grid wires
-    return 0*nm; //kill elsewhere
+}
+
+// GenerateParametrizedS2
+// ----------------------
+void G4S2Light::GenerateParametrizedS2(const G4Track& aTrack,
+                                       const G4Step& aStep, G4int z1,
+                                       G4double nDensity, G4double eDrift,
+                                       G4double z_start, G4double z_anode)
+{
+  // The tracked S2 makes one photon per step of the electron, and the steps
+  // are exponential with the mean free path from GetMeanFreePath, so the
+  // number of photons over the rest of the gap is Poisson with mean
+  // (length left)/(mean free path). Those photons are never tracked: the
+  // detected ones are shared out among the PMTs with the FastSim S2 light map.
+  const G4Material* aMaterial = aTrack.GetMaterial();
+  G4MaterialPropertiesTable* aMaterialPropertiesTable =
+    aMaterial->GetMaterialPropertiesTable();
+  G4double mfp = PhotonMeanFreePath(fabs(aMaterialPropertiesTable->
+			GetConstProperty("ELECTRICFIELDANODE")/(volt/cm)),
+				    nDensity,z1);
+  G4ThreeVector x1 = aStep.GetPostStepPoint()->GetPosition();
+  G4double t1 = aStep.GetPostStepPoint()->GetGlobalTime();
+  G4double gapLeft = z_anode - (x1[2] > z_start ? x1[2] : z_start);
+  if ( mfp <= 0. || gapLeft <= 0. || eDrift <= 0. ) return;
+  G4int NumPhotons = G4int(G4Poisson(gapLeft/mfp));
+  
+  double pos[3]; std::vector<double> s2Hits;
+  pos[0] = x1[0]/mm; pos[1] = x1[1]/mm; pos[2] = x1[2]/mm;
+  fastSim.s2PhotonsToPHE(NumPhotons,luxManager->GetParametrizedS2Efficiency()*
+			 luxManager->GetS1Gain(),pos,s2Hits);
+  G4int NumPhe = 0;
+  for ( G4int q1 = 0; q1 < (G4int)s2Hits.size(); q1++ )
+    NumPhe += G4int(s2Hits[q1]);
+  if ( !NumPhe ) return;
+  aParticleChange.SetNumberOfSecondaries(2*NumPhe);
+  
+  // the same timing as the tracked photons get: uniform over the drift
+  // across the gap, singlet/triplet emission, the tail, and e-train delays
+  G4double transitTime = gapLeft/sqrt(2*eDrift/(EMASS));
+  const G4DynamicParticle* aParticle = aTrack.GetDynamicParticle();
+  G4double OriginalEnergy = aParticle->GetPolarization()[1];
+  G4double tail = 4e-4*OriginalEnergy*1e3;
+  G4double SingTripRatio = .1; //guess: revisit
+  G4double trainDelay = 0.;
+  if ( aParticleChange.GetWeight() < 0 &&
+       aParticle->GetPolarization()[2] != 1 )
+    trainDelay = -aParticleChange.GetWeight();
+  
+  for ( G4int q1 = 0; q1 < (G4int)s2Hits.size(); q1++ ) {
+    if ( !s2Hits[q1] ) continue;
+    LUXSimDetectorComponent *thePMT =
+      luxManager->GetComponentByName(ConvertNumberToString(q1));
+    if ( !thePMT ) continue;
+    G4ThreeVector aSecondaryPosition = thePMT->GetGlobalCenter();
+    G4double doublePheProb = 0.2;
+    if ( luxManager->GetLUXDoublePheRateFromFile() )
+      doublePheProb = theScintProcess->GetDoublePHEProb(q1);
+    for ( G4int q2 = 0; q2 < G4int(s2Hits[q1]); q2++ ) {
+      G4double aSecondaryTime = t1 + G4UniformRand()*transitTime;
+      if(G4UniformRand()<SingTripRatio/(1+SingTripRatio))
+	aSecondaryTime -= tau1[z1]*log(G4UniformRand());
+      else aSecondaryTime -= tau3[z1]*log(G4UniformRand());
+      if ( G4UniformRand() <0.1 && !luxManager->GetLUXSurfaceGeometry() &&
+	   aParticleChange.GetWeight() >= 0 &&
+	   theScintProcess->BORDER < 55*cm )
+	aSecondaryTime -= tail*ns*log(G4UniformRand());
+      aSecondaryTime += trainDelay;
+      G4int numPhe = 1;
+      if ( G4UniformRand() < doublePheProb ) numPhe = 2;
+      for ( G4int q3 = 0; q3 < numPhe; q3++ ) {
+	G4DynamicParticle * aPhe = new G4DynamicParticle(
+	  G4ThermalElectron::ThermalElectron(),G4ParticleMomentum(0,0,0));
+	aPhe->SetKineticEnergy(2*MeV);
+	aParticleChange.AddSecondary(new G4Track(aPhe,aSecondaryTime,
+						 aSecondaryPosition));
+      }
+    }
   }
 }
 
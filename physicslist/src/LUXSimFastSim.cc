@@ -1,86 +1,150 @@
 #include "LUXSimFastSim.hh"
 #include "LUXSimManager.hh"
+#include "LUXSimFieldMap.hh"
+
+#include <cstring>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 //20140916 289 replaced by the variable numIDs CFPS
 
 //Some basic constants
 
-const int numZLevels = 25;
-const int numPMTs = 122;
+//Cache line size, in bytes, that the tables are aligned to
+const int tableAlignment = 64;
+
+//The text library read instead of an image that can't be used
+const char* const fallbackTextLibrary =
+    "physicslist/src/fastSimLibrary_fromKr_V04.dat";
+
+FastSim::FastSim(){
+    followManager = true;
+    managerLibraryChanges = -1;
+    loaded = false;
+    mappedImage = 0;
+    mappedSize = 0;
+    probability = meanTime = s2Probability = s2meanTime = coeffs = 0;
+    triLookup = 0;
+}
 
 FastSim::FastSim(const char* libraryFilename, const char* connectFileName){
+    followManager = false;
+    managerLibraryChanges = -1;
+    libraryName = libraryFilename;
+    connectName = connectFileName;
+    loaded = false;
+    mappedImage = 0;
+    mappedSize = 0;
+    probability = meanTime = s2Probability = s2meanTime = coeffs = 0;
+    triLookup = 0;
+}
+
+//Loads the library if it hasn't been yet, or if the manager has been given a
+// different one since it was. Nothing is read until fast sim is first used,
+// so runs that never use it don't pay for it.
+void FastSim::ensureLoaded(){
+    if(followManager){
+        LUXSimManager *luxManager = LUXSimManager::GetManager();
+        if(luxManager->GetFastSimLibraryChanges() != managerLibraryChanges){
+            managerLibraryChanges = luxManager->GetFastSimLibraryChanges();
+            if(luxManager->GetFastSimLibrary() != libraryName or
+                    luxManager->GetFastSimConnections() != connectName){
+                unload();
+                libraryName = luxManager->GetFastSimLibrary();
+                connectName = luxManager->GetFastSimConnections();
+            }
+        }
+    }
+    if(!loaded) load();
+}
+
+void FastSim::load(){
     //The kludge mentioned here is marked with a TODO in electronsToPHE()
     std::cout << "Note: FastSim S2 is being corrected.  This is correct for\n"
         << " the library of md5sum 81c93911106288dff7807541ef809952.\n";
 
-    //Initialize basic constants
-    inscribedR = 234.85; //mm - needs to be exact
-    outerR = 250; //mm - can be larger than reality
-
-    //Initialize heap memory.
-    // This has to be done because this class is so large it would cause a
-    // stack overflow if we were not using heap memory instead.
-    probability = new double**[numZLevels];
-    meanTime = new double**[numZLevels];
-    s2Probability = new double*[numIDs];
-    s2meanTime = new double*[numIDs];
-    for(int zLevel = 0; zLevel < numZLevels; zLevel++){
-        probability[zLevel] = new double*[numIDs];
-        meanTime[zLevel] = new double*[numIDs];
-        for(int id = 0; id < numIDs; id++){
-            probability[zLevel][id] = new double[numPMTs];
-            meanTime[zLevel][id] = new double[numPMTs];
-        }
+    //Compiled images are recognized by their format tag, not their name
+    std::ifstream libFile(libraryName.c_str(), std::ios::binary);
+    if(!libFile.is_open()){
+        std::cerr << "Couldn't open library file " << libraryName << "."
+            << std::endl;
+        exit(1);
     }
-    for(int id = 0; id < numIDs; id++){
-        s2Probability[id] = new double[numPMTs];
-        s2meanTime[id] = new double[numPMTs];
+    int formatTag = 0;
+    libFile.read((char*)(&formatTag), sizeof(int));
+    libFile.close();
+
+    if(formatTag == FASTSIM_IMAGE_TAG){
+        if(!loadImage()){
+            std::cerr << "Warning in FastSim: couldn't use the library image "
+                << libraryName << ", so the text library "
+                << fallbackTextLibrary << " is read instead." << std::endl;
+            loadText(fallbackTextLibrary);
+        }
     }
-    triLookup = new FSimTriangle**[1000];
-    for(int i = 0; i < 1000; i++){
-        //We don't need to initialize the triangles themselves;
-        // these are stored in the map "triangles", which manages
-        // its own memory automatically.
-        triLookup[i] = new FSimTriangle*[1000];
+    else{
+        loadText(libraryName);
     }
 
-    //"initialized" tracks if there are missing samples in the library
-    bool initialized[25][numIDs];
-    for(int i = 0; i < numIDs; i++){
-        for(int j = 0; j < 25; j++){
-            initialized[j][i] = false;
-        }
+    scratch[0].resize(numPMTs);
+    scratch[1].resize(numPMTs);
+    scratchProb.resize(numPMTs);
+    scratchRest.resize(numPMTs+1);
+
+    // Load table of double phe probabilities in case the user wants them.
+    LoadDoublePHEProb("physicslist/src/DoublePHEperDPH.txt");
+
+    // Initiliaze the skew gaussian
+    initSkewGaussianCDF(25.86, 5.56, 0.29);
+
+    //Finally done.
+    loaded = true;
+    std::cout << "Done loading fastSim from " << libraryName << ".\n";
+    return;
+}
+
+//Reads a text library and the connections file, and works out the triangle
+// lookup table from them
+void FastSim::loadText(G4String libraryFile){
+    const char* libraryFilename = libraryFile.c_str();
+    const char* connectFileName = connectName.c_str();
+
+    //Open the library file, and find out how big it is from its header
+    std::ifstream libFile(libraryFilename);
+    if(!libFile.is_open()){
+        std::cerr << "Couldn't open library file." << std::endl;
+        exit(1);
+    }
+    if(!readLibraryHeader(libFile)){
+        std::cerr << "Error in FastSim: bad library header." << std::endl;
+        exit(1);
     }
+    pmtStride = numPMTs + (tableAlignment/sizeof(float) -
+            numPMTs % (tableAlignment/sizeof(float))) %
+        (tableAlignment/sizeof(float));
 
-    //Initialize zLevels (manually)
-    zLevels[0] = 1;
-    zLevels[1] = 10;
-    zLevels[2] = 20;
-    zLevels[3] = 30;
-    zLevels[4] = 40;
-    zLevels[5] = 50;
-    zLevels[6] = 60;
-    zLevels[7] = 70;
-    zLevels[8] = 80;
-    zLevels[9] = 90;
-    zLevels[10] = 100;
-    zLevels[11] = 150;
-    zLevels[12] = 200;
-    zLevels[13] = 250;
-    zLevels[14] = 300;
-    zLevels[15] = 350;
-    zLevels[16] = 400;
-    zLevels[17] = 450;
-    zLevels[18] = 490;
-    zLevels[19] = 500;
-    zLevels[20] = 510;
-    zLevels[21] = 520;
-    zLevels[22] = 530;
-    zLevels[23] = 540;
-    zLevels[24] = 546.4;
+    //Initialize heap memory.
+    // This has to be done because this class is so large it would cause a
+    // stack overflow if we were not using heap memory instead. Each table is
+    // a single block, so the PMT loops run over contiguous memory.
+    probability = allocTable((size_t)numZLevels*numIDs);
+    meanTime = allocTable((size_t)numZLevels*numIDs);
+    s2Probability = allocTable(numIDs);
+    s2meanTime = allocTable(numIDs);
+    coeffs = 0;
+    triLookup = new int[1000*1000];
+    connections.resize(numIDs);
+    xByID.assign(numIDs, 0);
+    yByID.assign(numIDs, 0);
+
+    //"initialized" tracks if there are missing samples in the library
+    std::vector<char> initialized((size_t)numZLevels*numIDs, false);
 
     //Load the library file
-    std::ifstream libFile(libraryFilename);
     bool tempIsS1;
     bool overWriteError = false;
     double tempx;
@@ -88,63 +152,61 @@ FastSim::FastSim(const char* libraryFilename, const char* connectFileName){
     double tempz;
     int tempZIndex;
     int tempID;
-    double tempProb[122];
-    if(libFile.is_open()){
-        while(true){
-            //Read positinos, indicies, and probabilities from the library file
-            libFile >> tempx;
-            libFile >> tempy;
-            libFile >> tempz;
-            tempZIndex = zToIndex(tempz);
-            libFile >> tempIsS1;
-            libFile >> tempID;
-            tempID -= 1;
-            for(int i = 0; i < 122; i++){
-                libFile >> tempProb[i];
-            }
-            if(libFile.fail()) break;
-
-            //Only considering S2 for positions, because these are always in the
-            // right place; sometimes S1 samples are moved a bit out of position
-            // because an inconvenient piece of metal was in the way.
-            if(!tempIsS1){
-                xByID[tempID] = tempx;
-                yByID[tempID] = tempy;
-            }
-            if(initialized[tempZIndex][tempID] == true and tempIsS1
-                    and !overWriteError){
-                std::cerr << "Error in FastSim: Overwriting library"
-                    << " sample." << std::endl;
-                overWriteError = true;
-            }
+    std::vector<double> tempProb(numPMTs);
+    while(true){
+        //Read positinos, indicies, and probabilities from the library file
+        libFile >> tempx;
+        libFile >> tempy;
+        libFile >> tempz;
+        tempZIndex = zToIndex(tempz);
+        libFile >> tempIsS1;
+        libFile >> tempID;
+        tempID -= 1;
+        for(int i = 0; i < numPMTs; i++){
+            libFile >> tempProb[i];
+        }
+        if(libFile.fail()) break;
+        if(tempID < 0 or tempID > numIDs-1){
+            std::cerr << "Error in FastSim: library sample with position ID "
+                << tempID+1 << ", but the library has " << numIDs
+                << " positions." << std::endl;
+            exit(1);
+        }
 
-            //Now load the probabilities into their appropriate arrays
-            for(int i = 0; i < 122; i++){
-                if(tempIsS1){
-                    probability[tempZIndex][tempID][i] = tempProb[i];
-                }
-                else{
-                    s2Probability[tempID][i] = tempProb[i];
-                }
-            }
-            initialized[tempZIndex][tempID] = true;
+        //Only considering S2 for positions, because these are always in the
+        // right place; sometimes S1 samples are moved a bit out of position
+        // because an inconvenient piece of metal was in the way.
+        if(!tempIsS1){
+            xByID[tempID] = tempx;
+            yByID[tempID] = tempy;
         }
+        if(initialized[(size_t)tempZIndex*numIDs + tempID] == true and
+                tempIsS1 and !overWriteError){
+            std::cerr << "Error in FastSim: Overwriting library"
+                << " sample." << std::endl;
+            overWriteError = true;
+        }
+
+        //Now load the probabilities into their appropriate arrays
+        float* row = tempIsS1 ? probRow(tempZIndex,tempID) : s2ProbRow(tempID);
+        for(int i = 0; i < numPMTs; i++){
+            row[i] = tempProb[i];
+        }
+        initialized[(size_t)tempZIndex*numIDs + tempID] = true;
     }
-    else{
-        std::cerr << "Couldn't open library file." << std::endl;
-        exit(1);
-    }
+    if(radiiFromPositions) findRadii();
 
     //Search for uninitialized samples
     int numUninitialized = 0;
-    for(int i = 0; i < 25; i++){
+    for(int i = 0; i < numZLevels; i++){
         for(int j = 0; j < numIDs; j++){
-            if(!initialized[i][j]){
+            if(!initialized[(size_t)i*numIDs + j]){
                 numUninitialized += 1;
-                for(int pmt = 0; pmt < 122; pmt++){
+                float* row = probRow(i,j);
+                for(int pmt = 0; pmt < numPMTs; pmt++){
                     //Very Rough approximation - the price of not 
                     // having a sample initialized, hence the warning.
-                    probability[i][j][pmt] = .16/122.0;
+                    row[pmt] = .16/numPMTs;
                 }
             }
         }
@@ -164,21 +226,331 @@ FastSim::FastSim(const char* libraryFilename, const char* connectFileName){
     // seconds to do, but speeds up computation dramatically, and only needs to
     // be done once.  See fastSim note for the explanation of how it works
     initLookupTable();
+    return;
+}
 
-    // Load table of double phe probabilities in case the user wants them.
-    LoadDoublePHEProb("physicslist/src/DoublePHEperDPH.txt");
+//Checks that the header of a library image describes a library, that every
+// section it gives fits in the file, and that the triangle lookup grid and the
+// triangles only point inside their tables, so that a truncated, stale or
+// edited image can't send a lookup past the end of the mapping. This reads the
+// lookup grid once, which is still far less than working it out.
+static bool imageIsValid(const fastSimImageHeader& header, const char* image,
+        long long fileSize){
+    if(header.fileSize != fileSize or header.numPMTs < 1 or
+            header.numIDs < 3 or header.numZLevels < 1 or
+            header.pmtStride < header.numPMTs or header.numTriangles < 1)
+        return false;
 
-    // Initiliaze the skew gaussian
-    initSkewGaussianCDF(25.86, 5.56, 0.29);
+    long long floatsPerRow = header.pmtStride;
+    long long floatsPerTriangle = (header.numZLevels+1)*3*floatsPerRow;
+    long long offset[8] = { header.zLevelsOffset, header.xByIDOffset,
+        header.yByIDOffset, header.probabilityOffset,
+        header.s2ProbabilityOffset, header.triLookupOffset,
+        header.trianglesOffset, header.coeffsOffset };
+    long long size[8] = {
+        header.numZLevels*(long long)sizeof(double),
+        header.numIDs*(long long)sizeof(double),
+        header.numIDs*(long long)sizeof(double),
+        (long long)header.numZLevels*header.numIDs*floatsPerRow*
+            (long long)sizeof(float),
+        header.numIDs*floatsPerRow*(long long)sizeof(float),
+        1000*1000*(long long)sizeof(int),
+        header.numTriangles*(long long)sizeof(fastSimImageTriangle),
+        header.numTriangles*floatsPerTriangle*(long long)sizeof(float) };
+    for(int i = 0; i < 8; i++){
+        if(offset[i] < (long long)sizeof(fastSimImageHeader) or
+                offset[i] % tableAlignment != 0 or
+                size[i] > fileSize - offset[i])
+            return false;
+    }
 
-    //Finally done.
-    std::cout << "Done loading fastSim.\n";
+    //Every grid point is in a triangle, as initLookupTable confines points
+    // outside the dodecagon to it and the lookups don't check for -1
+    const int* triLookup = (const int*)(image + header.triLookupOffset);
+    for(int i = 0; i < 1000*1000; i++){
+        if(triLookup[i] < 0 or triLookup[i] >= header.numTriangles)
+            return false;
+    }
+
+    //Every triangle's rows of coefficients, and its corners, are in range
+    const fastSimImageTriangle* tri =
+        (const fastSimImageTriangle*)(image + header.trianglesOffset);
+    long long numCoeffs = header.numTriangles*floatsPerTriangle;
+    for(long long t = 0; t < header.numTriangles; t++){
+        if(tri[t].coeffOffset < 0 or
+                tri[t].coeffOffset > numCoeffs - floatsPerTriangle)
+            return false;
+        for(int k = 0; k < 3; k++){
+            if(tri[t].cornerID[k] < 0 or tri[t].cornerID[k] >= header.numIDs)
+                return false;
+        }
+    }
+    return true;
+}
+
+//Maps a library image written by WriteImage. The tables are used where they
+// sit in the mapped file, so only the pages that are actually looked at are
+// ever read from disk.
+bool FastSim::loadImage(){
+    int fd = open(libraryName.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0 or
+            (size_t)fileStat.st_size < sizeof(fastSimImageHeader)){
+        close(fd);
+        return false;
+    }
+    size_t imageSize = fileStat.st_size;
+    void* mapped = mmap(0, imageSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) return false;
+
+    char* image = (char*)mapped;
+    fastSimImageHeader header;
+    memcpy(&header, image, sizeof(header));
+    if(header.formatTag != FASTSIM_IMAGE_TAG or
+            header.version != FASTSIM_IMAGE_VERSION){
+        std::cerr << "Error in FastSim: " << libraryName << " is version "
+            << header.version << " of the image format, but this is version "
+            << FASTSIM_IMAGE_VERSION << "." << std::endl;
+        munmap(mapped, imageSize);
+        return false;
+    }
+    if(!imageIsValid(header, image, (long long)imageSize)){
+        std::cerr << "Error in FastSim: " << libraryName
+            << " is truncated or corrupt." << std::endl;
+        munmap(mapped, imageSize);
+        return false;
+    }
+
+    //Only now does the image belong to this FastSim, for unload() to unmap
+    mappedImage = mapped;
+    mappedSize = imageSize;
+
+    numPMTs = header.numPMTs;
+    numIDs = header.numIDs;
+    numZLevels = header.numZLevels;
+    pmtStride = header.pmtStride;
+    inscribedR = header.inscribedR;
+    outerR = header.outerR;
+
+    double* z = (double*)(image + header.zLevelsOffset);
+    zLevels.assign(z, z + numZLevels);
+    double* x = (double*)(image + header.xByIDOffset);
+    xByID.assign(x, x + numIDs);
+    double* y = (double*)(image + header.yByIDOffset);
+    yByID.assign(y, y + numIDs);
+
+    probability = (float*)(image + header.probabilityOffset);
+    s2Probability = (float*)(image + header.s2ProbabilityOffset);
+    meanTime = s2meanTime = 0;
+    triLookup = (int*)(image + header.triLookupOffset);
+    coeffs = (float*)(image + header.coeffsOffset);
+
+    fastSimImageTriangle* tri =
+        (fastSimImageTriangle*)(image + header.trianglesOffset);
+    triangles.resize(header.numTriangles);
+    for(long long t = 0; t < header.numTriangles; t++){
+        triangles[t].coeffOffset = tri[t].coeffOffset;
+        for(int k = 0; k < 3; k++){
+            triangles[t].cornerID[k] = tri[t].cornerID[k];
+        }
+        triangles[t].properlyInitialized = tri[t].properlyInitialized;
+    }
+
+    std::cout << "FastSim library image has " << numPMTs << " PMTs, "
+        << numIDs << " positions, " << numZLevels << " z-levels and "
+        << header.numTriangles << " triangles.\n";
+    return true;
+}
+
+//Frees whichever library is loaded, so that another can be
+void FastSim::unload(){
+    if(mappedImage){
+        munmap(mappedImage, mappedSize);
+    }
+    else{
+        free(probability);
+        free(meanTime);
+        free(s2Probability);
+        free(s2meanTime);
+        free(coeffs);
+        delete[] triLookup;
+    }
+    mappedImage = 0;
+    mappedSize = 0;
+    probability = meanTime = s2Probability = s2meanTime = coeffs = 0;
+    triLookup = 0;
+    triangles.clear();
+    connections.clear();
+    loaded = false;
+    return;
+}
+
+//Writes out everything that loading the library works out, so that later
+// jobs can map it instead. The sections are written in the order of the
+// header, each starting on a cache line.
+void FastSim::WriteImage(G4String fileName){
+    ensureLoaded();
+
+    fastSimImageHeader header;
+    memset(&header, 0, sizeof(header));
+    header.formatTag = FASTSIM_IMAGE_TAG;
+    header.version = FASTSIM_IMAGE_VERSION;
+    header.numPMTs = numPMTs;
+    header.numIDs = numIDs;
+    header.numZLevels = numZLevels;
+    header.pmtStride = pmtStride;
+    header.numTriangles = triangles.size();
+    header.inscribedR = inscribedR;
+    header.outerR = outerR;
+
+    std::vector<fastSimImageTriangle> tri(triangles.size());
+    for(size_t t = 0; t < triangles.size(); t++){
+        memset(&tri[t], 0, sizeof(fastSimImageTriangle));
+        tri[t].coeffOffset = triangles[t].coeffOffset;
+        for(int k = 0; k < 3; k++){
+            tri[t].cornerID[k] = triangles[t].cornerID[k];
+        }
+        tri[t].properlyInitialized = triangles[t].properlyInitialized;
+    }
+
+    const void* data[8] = { &zLevels[0], &xByID[0], &yByID[0], probability,
+        s2Probability, triLookup, &tri[0], coeffs };
+    long long numCoeffRows = (long long)triangles.size()*(numZLevels+1)*3;
+    long long size[8] = { numZLevels*(long long)sizeof(double),
+        numIDs*(long long)sizeof(double), numIDs*(long long)sizeof(double),
+        (long long)numZLevels*numIDs*pmtStride*(long long)sizeof(float),
+        (long long)numIDs*pmtStride*(long long)sizeof(float),
+        1000*1000*(long long)sizeof(int),
+        (long long)tri.size()*(long long)sizeof(fastSimImageTriangle),
+        numCoeffRows*pmtStride*(long long)sizeof(float) };
+    long long* offset[8] = { &header.zLevelsOffset, &header.xByIDOffset,
+        &header.yByIDOffset, &header.probabilityOffset,
+        &header.s2ProbabilityOffset, &header.triLookupOffset,
+        &header.trianglesOffset, &header.coeffsOffset };
+
+    long long position = sizeof(header);
+    for(int i = 0; i < 8; i++){
+        position += (tableAlignment - position % tableAlignment) %
+            tableAlignment;
+        *offset[i] = position;
+        position += size[i];
+    }
+    header.fileSize = position;
+
+    std::ofstream imageFile(fileName.c_str(), std::ios::binary|std::ios::out);
+    if(!imageFile.is_open()){
+        std::cerr << "Error in FastSim: couldn't open " << fileName
+            << " for writing." << std::endl;
+        exit(1);
+    }
+    imageFile.write((char*)(&header), sizeof(header));
+    position = sizeof(header);
+    char padding[tableAlignment];
+    memset(padding, 0, tableAlignment);
+    for(int i = 0; i < 8; i++){
+        imageFile.write(padding, *offset[i] - position);
+        imageFile.write((const char*)data[i], size[i]);
+        position = *offset[i] + size[i];
+    }
+    imageFile.close();
+    if(!imageFile.good()){
+        std::cerr << "Error in FastSim: couldn't write " << fileName << "."
+            << std::endl;
+        exit(1);
+    }
+
+    std::cout << "Wrote the FastSim library image " << fileName << " ("
+        << header.fileSize << " bytes) from " << libraryName << ".\n";
     return;
 }
 
+//Reads the optional header line at the top of the library file,
+//  FastSimLibrary <numPMTs> <numIDs> <numZLevels> <z level 0> ...
+//      [<inscribedR> <outerR>] (mm)
+// with the z-levels in increasing order. Without one, the library is taken to
+// be the LUX one, and the file is left at the first sample. A header without
+// the radii has them worked out from the sample positions once those are read.
+bool FastSim::readLibraryHeader(std::ifstream& libFile){
+    std::streampos start = libFile.tellg();
+    std::string tag;
+    libFile >> tag;
+    radiiFromPositions = false;
+    if(tag != "FastSimLibrary"){
+        libFile.clear();
+        libFile.seekg(start);
+
+        inscribedR = 234.85; //mm - needs to be exact
+        outerR = 250; //mm - can be larger than reality
+        numPMTs = 122;
+        numIDs = 2341;
+        double luxZLevels[25] = { 1, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100,
+            150, 200, 250, 300, 350, 400, 450, 490, 500, 510, 520, 530, 540,
+            546.4 };
+        numZLevels = 25;
+        zLevels.assign(luxZLevels, luxZLevels + numZLevels);
+        return true;
+    }
+
+    libFile >> numPMTs >> numIDs >> numZLevels;
+    if(libFile.fail() or numPMTs < 1 or numIDs < 3 or numZLevels < 1)
+        return false;
+    zLevels.resize(numZLevels);
+    for(int i = 0; i < numZLevels; i++){
+        libFile >> zLevels[i];
+        if(i > 0 and zLevels[i] <= zLevels[i-1]) return false;
+    }
+    if(libFile.fail()) return false;
+
+    std::string rest;
+    getline(libFile, rest);
+    std::istringstream radii(rest);
+    if(radii >> inscribedR >> outerR){
+        if(inscribedR <= 0 or outerR < inscribedR) return false;
+    }
+    else radiiFromPositions = true;
+
+    std::cout << "FastSim library has " << numPMTs << " PMTs, " << numIDs
+        << " positions and " << numZLevels << " z-levels.\n";
+    return true;
+}
+
+//Works out the radii from the (S2) sample positions, for libraries whose
+// header doesn't give them. inscribedR is that of the smallest dodecagon, of
+// the orientation confine() uses, that holds every position, and outerR is
+// the radius of its corners, so the lookup grid covers all of it.
+void FastSim::findRadii(){
+    inscribedR = 0;
+    for(int i = 0; i < numIDs; i++){
+        double r = sqrt(pow(xByID[i],2) + pow(yByID[i],2));
+        double theta = atan2(yByID[i],xByID[i]) + M_PI;
+        theta -= (M_PI/6)*(int)(theta / (M_PI/6)) + M_PI/12;
+        if(r*cos(theta) > inscribedR) inscribedR = r*cos(theta);
+    }
+    outerR = inscribedR / cos(M_PI/12);
+    std::cout << "FastSim radii from the library positions: inscribed "
+        << inscribedR << " mm, outer " << outerR << " mm.\n";
+}
+
+//Allocates a table of numRows rows of pmtStride floats, zeroed and aligned to
+// a cache line
+float* FastSim::allocTable(size_t numRows){
+    void* table = 0;
+    size_t size = numRows*pmtStride*sizeof(float);
+    if(posix_memalign(&table, tableAlignment, size ? size : tableAlignment)){
+        std::cerr << "Error in FastSim: couldn't allocate " << size
+            << " bytes for the library." << std::endl;
+        exit(1);
+    }
+    memset(table, 0, size);
+    return (float*)table;
+}
+
 //Returns the probabilities of landing in each pmt via for a given point
 // Expects prob is already initialized.
-void FastSim::getProbability(double prob[122], FSimTriangle* source,
+void FastSim::getProbability(double* prob, FSimTriangle* source,
         double pos[3]){
     //Determine what z range we are operating in
     zIndicies(&scratchZPositions[0],&scratchZPositions[1],pos[2]);
@@ -186,15 +558,15 @@ void FastSim::getProbability(double prob[122], FSimTriangle* source,
     //Deal with cases where no z interpolation is required.
     if(scratchZPositions[0] == scratchZPositions[1]){//No z interpolation
         //Interpolate using the coefficients found in the source triangle.
-        planeInterpolate(prob,source->pCoeffs[scratchZPositions[0]],
+        planeInterpolate(prob,triCoeffs(source,scratchZPositions[0]),
                 pos[0],pos[1]);
     }
     else{ //Still need to interpolate on Z
         //Interpolate using the coefficients found in the source triangle.
-        planeInterpolate(scratch[0],source->pCoeffs[scratchZPositions[0]],
-                pos[0],pos[1]);
-        planeInterpolate(scratch[1],source->pCoeffs[scratchZPositions[1]],
-                pos[0],pos[1]);
+        planeInterpolate(&scratch[0][0],
+                triCoeffs(source,scratchZPositions[0]),pos[0],pos[1]);
+        planeInterpolate(&scratch[1][0],
+                triCoeffs(source,scratchZPositions[1]),pos[0],pos[1]);
 
         //Get the linear z-interpolation weights.
         scratchWeights[1] = (pos[2] - zLevels[scratchZPositions[0]]) /
@@ -202,7 +574,7 @@ void FastSim::getProbability(double prob[122], FSimTriangle* source,
         scratchWeights[0] = 1 - scratchWeights[1];
         
         //Apply the weights to z interpolate, and we're done
-        for(int i = 0; i < 122; i++){
+        for(int i = 0; i < numPMTs; i++){
             prob[i] = scratchWeights[0] * scratch[0][i] +
                 scratchWeights[1]*scratch[1][i];
         }
@@ -211,18 +583,20 @@ void FastSim::getProbability(double prob[122], FSimTriangle* source,
 
 //Returns the probabilities of landing in each pmt via for a given point
 // Expects prob is already initialized.
-void FastSim::getS2Probability(double prob[122], FSimTriangle* source,
+void FastSim::getS2Probability(double* prob, FSimTriangle* source,
         double pos[3],LUXSimManager *luxManager){
     //Interpolate using the coefficients found in the source triangle.
 	//LUXSimManager *luxManager = LUXSimManager::GetManager();
 	G4ThreeVector x;
 	x[0]=pos[0]; x[1]=pos[1]; x[2]=pos[2]; 
 if(luxManager->GetEFieldFromFile()){
-    planeInterpolate(prob, source->s2pCoeffs, luxManager->GetXYZDependentS2_X(x), luxManager->GetXYZDependentS2_Y(x));
+    G4double fieldValues[LUXSimFieldMap::kNumValues];
+    luxManager->GetXYZDependentFieldValues(x, fieldValues);
+    planeInterpolate(prob, triCoeffs(source,numZLevels), fieldValues[LUXSimFieldMap::kS2X], fieldValues[LUXSimFieldMap::kS2Y]);
 }
 else
 {
-planeInterpolate(prob, source->s2pCoeffs, pos[0], pos[1]);}
+planeInterpolate(prob, triCoeffs(source,numZLevels), pos[0], pos[1]);}
 }
 
 //Finds the two adjacent z levels which contain the desired point
@@ -261,8 +635,10 @@ void FastSim::zIndicies(int* a, int* b, double inputZ){
 void FastSim::initLookupTable(){
     double tempx;
     double tempy;
-    double tempID = 0;
+    int tempID = 0;
+    long long triangleKey;
     int triangleID[3];
+    std::map<long long,int> triangleIndex;
     for(int i = 0; i < 1000; i++){
         for(int j = 0; j < 1000; j++){
             //Samples the center of the box
@@ -279,10 +655,10 @@ void FastSim::initLookupTable(){
                 }
             }
 
-            //This is my conversion from three triangle IDs to an int that goes
-            // into a the "triangles" map: sort them least to greatest, then
-            // do id[0] + id[1]*300 + id[2]*300*300. Since ids are always less
-            // than numIDs, this always generates a unique id.
+            //This is my conversion from three triangle IDs to a number that
+            // goes into the "triangleIndex" map: sort them least to greatest,
+            // then do id[0] + id[1]*numIDs + id[2]*numIDs*numIDs. Since ids are
+            // always less than numIDs, this always generates a unique key.
             //Sort the triangleIDs
             if(triangleID[0] > triangleID[1]){
                 tempID = triangleID[0];
@@ -299,36 +675,54 @@ void FastSim::initLookupTable(){
                     triangleID[1] = tempID;
                 }
             }
-            tempID = triangleID[0] + triangleID[1]*300 + triangleID[2]*300*300;
+            triangleKey = triangleID[0] + (long long)numIDs*(triangleID[1] +
+                    (long long)numIDs*triangleID[2]);
 
             //Check if the triangle is already logged.
-            if(triangles.count(tempID) == 0){
+            std::map<long long,int>::iterator found =
+                triangleIndex.find(triangleKey);
+            if(found == triangleIndex.end()){
                 //The Triangle does not exists, so we must create a new one to
-                // reference it in the lookup table.
-                // Create a triangle for this set of IDs
-                FSimTriangle* tri = &triangles[tempID];
-
-                for(int zLevel = 0; zLevel < numZLevels; zLevel++){
-                    getInterpolatingPlane(tri->pCoeffs[zLevel],
-                            probability[zLevel], triangleID);
+                // reference it in the lookup table. Its coefficients are
+                // worked out below, once all the triangles are known.
+                FSimTriangle tri;
+                for(int k = 0; k < 3; k++){
+                    tri.cornerID[k] = triangleID[k];
                 }
-                getInterpolatingPlane(tri->s2pCoeffs,s2Probability,
-                        triangleID);
-                tri->properlyInitialized = true;
-                triLookup[i][j] = tri;
+                tri.coeffOffset = triangles.size()*(numZLevels+1)*3*
+                    (size_t)pmtStride;
+                triangleIndex[triangleKey] = triangles.size();
+                triLookup[i*1000+j] = triangles.size();
+                triangles.push_back(tri);
             }
             else{
                 //The triangle already exists, and the lookup can just refer to
                 // it rather than making a new one.
-                triLookup[i][j] = &(triangles[tempID]);
+                triLookup[i*1000+j] = found->second;
             }
         }
     }
 
+    //Work out the interpolating planes of every triangle, for each z-level
+    // and then for S2, into one block
+    coeffs = allocTable(triangles.size()*(numZLevels+1)*3);
+    for(size_t t = 0; t < triangles.size(); t++){
+        FSimTriangle* tri = &triangles[t];
+        for(int zLevel = 0; zLevel < numZLevels; zLevel++){
+            getInterpolatingPlane(triCoeffs(tri,zLevel), probRow(zLevel,0),
+                    tri->cornerID);
+        }
+        getInterpolatingPlane(triCoeffs(tri,numZLevels), s2ProbRow(0),
+                tri->cornerID);
+        tri->properlyInitialized = true;
+    }
     return;
 }
 
 FSimTriangle::FSimTriangle(){
+    coeffOffset = 0;
+    cornerID[0] = cornerID[1] = cornerID[2] = -1;
+    properlyInitialized = false;
 }
 
 //Ensures that a point lies within the dodecagon and return 1 if it already did
@@ -352,14 +746,54 @@ bool FastSim::confine(double* x, double* y, double reduce){
     return true;
 }
 
-//Takes an array of 122 planes (described by their x,y, and constant
+//Takes an array of numPMTs planes (described by their x,y, and constant
 // coefficients in params) and evaluates them at the position (x,y).
-// Expects params is size [122][3] and is the output of getInterpolatingPlane()
-// Expects prob is size [122] and is already allocated
-void FastSim::planeInterpolate(double prob[122], double params[122][3],
+// Expects params holds the x, y and constant coefficients as three rows of
+// pmtStride, as written by getInterpolatingPlane()
+// Expects prob is size [numPMTs] and is already allocated
+void FastSim::planeInterpolate(double* prob, const float* params,
         double x, double y){
-    for(int i = 0; i < 122; i++){
-        prob[i] = params[i][0]*x + params[i][1]*y + params[i][2];
+    const float* a = params;
+    const float* b = params + pmtStride;
+    const float* c = params + 2*pmtStride;
+    for(int i = 0; i < numPMTs; i++){
+        prob[i] = a[i]*x + b[i]*y + c[i];
+    }
+    return;
+}
+
+//Distributes numQuanta among the numPMTs PMTs, with PMT i getting each one with
+// probability prob[i]/sum(prob), and adds them to hits.  Rather than picking
+// a PMT for every quantum off a CDF, the counts are drawn as a multinomial,
+// one PMT after another: PMT i gets a binomial share of the quanta not yet
+// handed out, with the probability of PMT i among the PMTs left.  This gives
+// the same distribution of hits at a cost set by the number of PMTs, however
+// many quanta there are.
+// Negative probabilities (the plane interpolation can undershoot near zero)
+// are taken as zero.
+void FastSim::distributeToPMTs(int numQuanta, double* prob,
+        std::vector<double>& hits){
+    if(numQuanta <= 0) return;
+
+    //What is left of the probability beyond each PMT, summed from the back so
+    // that the last PMT with any probability takes all the remaining quanta
+    double* rest = &scratchRest[0];
+    rest[numPMTs] = 0;
+    for(int i = numPMTs-1; i >= 0; i--){
+        rest[i] = rest[i+1] + (prob[i] > 0 ? prob[i] : 0);
+    }
+    if(!(rest[0] > 0)) return;
+
+    int remaining = numQuanta;
+    for(int i = 0; i < numPMTs and remaining > 0; i++){
+        if(!(prob[i] > 0)) continue;
+        double p = prob[i] / rest[i];
+        int n = remaining;
+        if(p < 1){
+            n = int(CLHEP::RandBinomial::shoot(remaining, p));
+        }
+        hits[i] += n;
+        remaining -= n;
     }
     return;
 }
@@ -370,7 +804,7 @@ void FastSim::planeInterpolate(double prob[122], double params[122][3],
 int FastSim::zToIndex(double inputZ){
     double distance = 999;
     int id = -1;
-    for(int i = 0; i < 25; i++){
+    for(int i = 0; i < numZLevels; i++){
         if(distance > abs(inputZ - zLevels[i])){
             id = i;
             distance = inputZ - zLevels[i];
@@ -382,15 +816,14 @@ int FastSim::zToIndex(double inputZ){
 //Takes the array of samples "p" at a particular z-level and a position
 // "posID" and generates an interpolating plane (coefficients are written to
 // "output")on the triangle they refer to using linear algebra, for
-// each of the 122 planes required.  See the FastSim note for a more complete
+// each of the numPMTs planes required.  See the FastSim note for a more complete
 // description of the algebra and motivation.
 // This isn't especially optimized much because it is expected that this will
 // be // pre-computed, and therefore not speed-critical, in the final version.
 // Expects that all inputs are allocated, and that all but output are
 // initialized.
-// p should be size [numIDs][122]
-void FastSim::getInterpolatingPlane(double output[122][3], double** p,
-        int posID[3]){
+// p should be size [numIDs][pmtStride], and output [3][pmtStride]
+void FastSim::getInterpolatingPlane(float* output, float* p, int posID[3]){
 
     double x[3] = {xByID[posID[0]], xByID[posID[1]], xByID[posID[2]]};
     double y[3] = {yByID[posID[0]], yByID[posID[1]], yByID[posID[2]]};
@@ -407,11 +840,12 @@ void FastSim::getInterpolatingPlane(double output[122][3], double** p,
     m[2][2] = x[0]*y[1] - x[1]*y[0];
 
     for(int k = 0; k < 3; k++){// which coefficient a,b,c in a*x + b*y + c
-        for(int pmt = 0; pmt < 122; pmt++){
-            output[pmt][k] = 0;
+        for(int pmt = 0; pmt < numPMTs; pmt++){
+            double sum = 0;
             for(int i = 0; i < 3; i++){ //3x3 matrix multiplication sum
-                output[pmt][k] += p[posID[i]][pmt] * m[k][i] / det;
+                sum += p[(size_t)posID[i]*pmtStride + pmt] * m[k][i] / det;
             }
+            output[k*pmtStride + pmt] = sum;
         }
     }
 
@@ -561,11 +995,13 @@ bool FastSim::loadConnections(const char* name){
 //Takes in a number of photons and the position they were generated, and
 // returns a list of hits in each PMT, distributed in a reasonable way.  This
 // is the function to be called from G4S1Light.cc
-void FastSim::photonsToPHE(int numPhots, double pos[3], double hits[122]){
-    double s1Prob[122];
-    for(int i = 0; i < 122; i++){
+void FastSim::photonsToPHE(int numPhots, double pos[3],
+        std::vector<double>& hits){
+    ensureLoaded();
+    double* s1Prob = &scratchProb[0];
+    hits.assign(numPMTs, 0);
+    for(int i = 0; i < numPMTs; i++){
         s1Prob[i] = 0;
-        hits[i]=0;
     }
     if(numPhots == 0) return;
 
@@ -581,21 +1017,14 @@ void FastSim::photonsToPHE(int numPhots, double pos[3], double hits[122]){
     }
     
     //Get the s1 probabilities
-    getProbability(s1Prob,triLookup[xi][yi],pos);
+    getProbability(s1Prob,&triangles[triLookup[xi*1000+yi]],pos);
     
     //Now, deposit the photons
     //We start by summing the S1 probabilities so they can be normalized 
     G4double survival = 0.; G4int survivors = 0;
-    for(int i = 0; i < 122; i++) {
+    for(int i = 0; i < numPMTs; i++) {
       survival = survival +  s1Prob[i];
     }
-    //Now we calculate a cumulative distribution function
-    //This will be used to determine to which PMT each photon goes
-    double s1CDF[122];
-    s1CDF[0] = s1Prob[0] / survival;
-    for(int i = 1; i < 122; i++) {
-      s1CDF[i] = s1CDF[i-1] + s1Prob[i] / survival;
-    }
     //Determine total number of survivors
 //    survivors = G4int(floor(G4RandGauss::shoot(survival*double(numPhots),0.9*sqrt(survival*(double)numPhots))+0.5));
      //Above line is a kludge to broaden S1 response, here we assume pure binomial flucctuation
@@ -603,35 +1032,9 @@ void FastSim::photonsToPHE(int numPhots, double pos[3], double hits[122]){
     LUXSimManager *luxManager = LUXSimManager::GetManager();
     survivors = BinomFluct(numPhots, luxManager->GetS1Gain() * survival);
 
-    //Loop over phtons and for each one, generate a random number between 0 and 1 and use the CDF to pick a PMT
-    double temp;
-    for(int i = 0; i < survivors; i++) {
-      temp = G4UniformRand();
-      int j = floor(temp*121.) + 1;
-      bool found = false;
-      int maxPMT = 122;
-      int minPMT = 0;
-      //Find the PMT corresponding to that random number
-      while(!found) {
-        if(j == 0 &&
-           temp < s1CDF[j]) {
-          found = true;
-        }
-        else if(temp < s1CDF[j-1]){
-          maxPMT = j;
-          j = floor((minPMT + j) / 2.);
-        }
-        else if(temp > s1CDF[j]){
-          minPMT = j;
-          j = floor((maxPMT + j) / 2.);
-        }
-        else {
-          found = true;
-        }
-      }
-      //Add a hit to PMT j
-      hits[j]++;
-    }
+    //Share the survivors out among the PMTs, in proportion to the
+    // probabilities
+    distributeToPMTs(survivors, s1Prob, hits);
 
     //For each photon there is a 20% chance that two phe are produced... at least this is what we're told
 //    int numDoubles;
@@ -655,12 +1058,13 @@ void FastSim::photonsToPHE(int numPhots, double pos[3], double hits[122]){
 // electrons at a given position.  It also returns a list of hits, and is
 // to be called from G4S1Light.cc
 void FastSim::electronsToPHE(int numElectrons, double pos[3],
-        double hits[122]){
+        std::vector<double>& hits){
+    ensureLoaded();
  LUXSimManager *luxManager = LUXSimManager::GetManager();
-    double s2Prob[122];
-    for(int i = 0; i < 122; i++){
-        s2Probability[i] = 0;
-        hits[i] = 0;
+    double* s2Prob = &scratchProb[0];
+    hits.assign(numPMTs, 0);
+    for(int i = 0; i < numPMTs; i++){
+        s2Prob[i] = 0;
     }
 
     if(numElectrons == 0) return;
@@ -677,8 +1081,10 @@ int xi,yi;
     //Get the indicies for the lookup table for the event position
    if(luxManager->GetEFieldFromFile())
 {
-xi = int(999.999*(luxManager->GetXYZDependentS2_X(xx) + outerR)/(2* outerR));
-yi = int(999.999*(luxManager->GetXYZDependentS2_Y(xx) + outerR)/(2* outerR));
+G4double fieldValues[LUXSimFieldMap::kNumValues];
+luxManager->GetXYZDependentFieldValues(xx, fieldValues);
+xi = int(999.999*(fieldValues[LUXSimFieldMap::kS2X] + outerR)/(2* outerR));
+yi = int(999.999*(fieldValues[LUXSimFieldMap::kS2Y] + outerR)/(2* outerR));
 }
 else
 {
@@ -686,17 +1092,11 @@ xi = int(999.999*(pos[0] + outerR)/(2* outerR));
 yi = int(999.999*(pos[1] + outerR)/(2* outerR));
 }
 if(xi>=0 && xi<1000&&yi>=0 &&yi<1000){
-    getS2Probability(s2Prob,triLookup[xi][yi],pos,luxManager);}
+    getS2Probability(s2Prob,&triangles[triLookup[xi*1000+yi]],pos,luxManager);}
 
    
     //if(luxManager->GetLUXFastSimSkewGaussianS2()) {
       if(1){
- //Need to renormalize S2 probability
-        double sum = 0;
-        for(int i = 0; i < 122; i++) {
-            sum = sum + s2Prob[i];
-        }
-
         //Next, need to determine total number of phe
         int numPhot = 0;
         int electronSize;
@@ -704,48 +1104,15 @@ if(xi>=0 && xi<1000&&yi>=0 &&yi<1000){
             electronSize = inverseSkewGaussianCDF(G4UniformRand());
             numPhot = numPhot + electronSize;
         }
-        //Now we calculate a cumulative distribution function
-        //This will be used to determine to which PMT each photon goes
-        double s2CDF[122];
-        s2CDF[0] = s2Prob[0] / sum;
-        for(int i = 1; i < 122; i++) {
-          s2CDF[i] = s2CDF[i-1] + s2Prob[i] / sum;
-        }
-        //Loop over phtons and for each one, generate a random number between 0 and 1 and use the CDF to pick a PMT
-        double temp;
-        for(int i = 0; i < numPhot; i++) {
-          temp = G4UniformRand();
-          int j = floor(temp*121.)+1;
-          bool found = false;
-          int maxPMT = 122;
-          int minPMT = 0;
-          //Find the PMT corresponding to that random number
-          while(!found) {
-            if(j == 0 &&
-               temp < s2CDF[j]) {
-              found = true;
-            }
-            else if(temp < s2CDF[j-1]){
-              maxPMT = j;
-              j = floor((minPMT + j) / 2.);
-            }
-            else if(temp > s2CDF[j]){
-              minPMT = j;
-              j = floor((maxPMT + j) / 2.);
-            }
-            else {
-              found = true;
-            }
-          }
-          //Add a hit to PMT j
-          hits[j]++;
-        }
+        //Share the photons out among the PMTs, in proportion to the
+        // probabilities
+        distributeToPMTs(numPhot, s2Prob, hits);
       }
       else {
   	//Deposit the photons as PHE
         const double kludgeFactor = 1.32; //TODO: Ideally, this should be 1.0
         int numPhe = 0;
-        for(int i = 0; i < 122; i++){
+        for(int i = 0; i < numPMTs; i++){
           hits[i] = G4int(floor(G4RandGauss::shoot(s2Prob[i]*kludgeFactor*double(numElectrons),sqrt(s2Prob[i]*kludgeFactor*(double)numElectrons))+0.5));//G4Poisson(kludgeFactor * n$
           numPhe = numPhe + hits[i];
         }
@@ -767,27 +1134,38 @@ if(xi>=0 && xi<1000&&yi>=0 &&yi<1000){
 //    }
 }
 
-FastSim::~FastSim(){
-    //Delete all the heap memory.
-    for(int zLevel = 0; zLevel < 25; zLevel++){
-        for(int id = 0; id < numIDs; id++){
-            delete[] probability[zLevel][id];
-            delete[] meanTime[zLevel][id];
-        }
-        delete[] probability[zLevel];
-        delete[] meanTime[zLevel];
-        delete[] s2Probability[zLevel];
-        delete[] s2meanTime[zLevel];
-    }
-    delete[] probability;
-    delete[] meanTime;
-    delete[] s2Probability;
-    delete[] s2meanTime;
+//Shares the photoelectrons from numPhots S2 photons, each of which is detected
+// with probability efficiency, out among the PMTs using the S2 light map. pos
+// is where the light is made in the gas gap, so unlike electronsToPHE it is
+// not moved to its S2 position with the field map, and any z is accepted.
+void FastSim::s2PhotonsToPHE(int numPhots, double efficiency, double pos[3],
+        std::vector<double>& hits){
+    ensureLoaded();
+    double* s2Prob = &scratchProb[0];
+    hits.assign(numPMTs, 0);
+    if(numPhots <= 0 || efficiency <= 0) return;
 
-    for(int i = 0; i < 1000; i++){
-        delete[] triLookup[i];
+    //Light made outside the library's triangles is moved in to the edge
+    confine(&pos[0],&pos[1]);
+
+    int xi = int(999.999*(pos[0] + outerR)/(2* outerR));
+    int yi = int(999.999*(pos[1] + outerR)/(2* outerR));
+    if(xi > 999 or xi < 0 or yi > 999 or yi <0){
+        std::cerr << "Error: FastSim triangle lookup out of range."
+            << std::endl;
+        return;
     }
-    delete[] triLookup;
+    planeInterpolate(s2Prob, triCoeffs(&triangles[triLookup[xi*1000+yi]],
+                numZLevels), pos[0], pos[1]);
+
+    int survivors = numPhots;
+    if(efficiency < 1) survivors = BinomFluct(numPhots, efficiency);
+    distributeToPMTs(survivors, s2Prob, hits);
+}
+
+FastSim::~FastSim(){
+    //Delete all the heap memory.
+    unload();
     return;
 }
 
@@ -820,15 +1198,20 @@ void FastSim::initSkewGaussianCDF(double mean, double sigma, double skew) {
 }
 
 //For a given beta between 0 and 1 (inclusive) find the value of skewCDF_Y closest to alpha
-//and return the corresponding X value
+//and return the corresponding X value. skewCDF_Y is sorted, so a bisection
+//finds the first point at or above beta, and the closest value is either that
+//one or the one below it. Of equal values, the first one is returned.
 int FastSim::inverseSkewGaussianCDF(double beta) {
-    int indexMin = -1;
-    double min = 99999999.;
-    for(int i = 0; i < numSGPoints; i++) {
-        if (fabs(beta - skewCDF_Y[i]) < min) {
-            min = fabs(beta - skewCDF_Y[i]);
-            indexMin = i;
-        }
+    int indexMin = std::lower_bound(skewCDF_Y, skewCDF_Y + numSGPoints, beta)
+        - skewCDF_Y;
+    if(indexMin == numSGPoints ||
+            (indexMin > 0 &&
+             fabs(beta - skewCDF_Y[indexMin-1]) <=
+             fabs(beta - skewCDF_Y[indexMin]))) {
+        indexMin--;
+    }
+    while(indexMin > 0 && skewCDF_Y[indexMin-1] == skewCDF_Y[indexMin]) {
+        indexMin--;
     }
     return skewCDF_X[indexMin];
 }
@@ -862,7 +1245,8 @@ void FastSim::LoadDoublePHEProb(G4String fileName) {
     G4cout<<G4endl<<G4endl<<G4endl;
     exit(0);
   }
-  for (int i = 0; i < 122; i++) {
+  doublePheProb.assign(numPMTs, 0);
+  for (int i = 0; i < numPMTs; i++) {
     file >> doublePheProb[i];
   }
   file.close();
@@ -871,9 +1255,10 @@ void FastSim::LoadDoublePHEProb(G4String fileName) {
 //A debug function in case you want to see the values in FastSim's class
 // variables.
 void FastSim::print(){
-    for(size_t i = 0; i < 25; i++){
+    ensureLoaded();
+    for(int i = 0; i < numZLevels; i++){
         for(int k = 0; k < numIDs; k++){
-            std::cout << probability[i][k][20] << " ";
+            std::cout << probRow(i,k)[std::min(20,numPMTs-1)] << " ";
         }
         std::cout << std::endl;
     }
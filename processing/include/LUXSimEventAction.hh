@@ -8,6 +8,8 @@
 *	13-Mar-2009 - Initial submission (Kareem)
 *	23-Oct-2012 - Added a hook for recording the global time of the primary
 *				  particle (Kareem)
+*	17-Oct-2026 - The start and end times are now wall-clock times in seconds
+*				  with microsecond resolution (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,7 +42,7 @@ class LUXSimEventAction : public G4UserEventAction
 		void SetManager( LUXSimManager *man ) { luxManager = man; };
 		
 		inline G4double GetTimeSinceStart() { return simStartTime; };
-                inline void SetTimeSinceStart( G4double t ) { simStartTime = (time_t)(t); };
+                inline void SetTimeSinceStart( G4double t ) { simStartTime = t; };
 		
 		inline G4int GetEventNum() { return eventNum; };
 		
@@ -50,7 +52,7 @@ class LUXSimEventAction : public G4UserEventAction
 				{ return radioactivePrimaryTime; };
 			
 	private:
-		time_t simStartTime, simEndTime;
+		G4double simStartTime, simEndTime;
 		G4int eventNum;
 		G4double radioactivePrimaryTime;
 	
@@ -8,6 +8,10 @@
 *	13 March 2009 - Initial submission (Kareem)
 *	14-Sep-09 - Added support for recording optical photons (Kareem)
 *	31-Jan-11 - Added support for obtaining the record level in a step (Kareem)
+*	17-Oct-26 - Added the detector component of the current step (agent)
+*	17-Oct-26 - Added the cached particle definitions and ion classification
+*				(agent)
+*	17-Oct-26 - Added the run statistics pointer (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,9 +36,11 @@
 class G4UserEventAction;
 class G4Track;
 class G4Material;
+class G4ParticleDefinition;
 
 class LUXSimEventAction;
 class LUXSimDetectorComponent;
+class LUXSimRunStatistics;
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 class LUXSimSteppingAction : public G4UserSteppingAction
@@ -45,6 +51,9 @@ class LUXSimSteppingAction : public G4UserSteppingAction
 
 		void UserSteppingAction( const G4Step *theStep );
 
+	private:
+		G4bool IsIon( G4ParticleDefinition* );
+
                 //      Primary particle information
                 LUXSimManager::primaryParticleInfo primaryParticles;
 
@@ -53,6 +62,8 @@ class LUXSimSteppingAction : public G4UserSteppingAction
 		
 	private:
 		G4Track *theTrack;
+		LUXSimDetectorComponent *theComponent;
+		G4ParticleDefinition *particleDef;
 		G4ThreeVector trackPosition;
 		G4ThreeVector particleDirection;
 		
@@ -62,8 +73,13 @@ class LUXSimSteppingAction : public G4UserSteppingAction
 
 		LUXSimManager *luxManager;
 		LUXSimManager::stepRecord aStepRecord;
+		LUXSimRunStatistics *runStatistics;
 		
 		G4Material *blackiumMat;
+		
+		G4ParticleDefinition *opticalPhotonDef;
+		G4ParticleDefinition *thermalElectronDef;
+		std::map<G4ParticleDefinition*,G4bool> ionDefinitions;
   
                 std::map<G4int,bool> radIsoMap;
                 std::map<G4int,bool>::iterator itMap;
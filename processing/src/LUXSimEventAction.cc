@@ -11,15 +11,14 @@
 *   24-Mar-12 - Added support for the event progress report UI hooks (Mike)
 *	23-Oct-12 - Added initialization for the global time of the primary particle
 *				if it's a radioactive nucleus (Kareem)
+*	17-Oct-26 - Recorded event numbers count from randomFirstEvent, so the
+*				shards of a split job don't reuse them (agent)
+*	17-Oct-26 - The progress report uses the high-resolution wall clock, and
+*				every event is timed in the manager's run statistics (agent)
 *
 */
 /////////////////////////////////////////////////////////////////////////////////
 
-//
-//	C/C++ includes
-//
-#include <ctime>
-
 //
 //	GEANT4 includes
 //
@@ -33,6 +32,7 @@
 //
 #include "LUXSimEventAction.hh"
 #include "LUXSimManager.hh"
+#include "LUXSimRunStatistics.hh"
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimEventAction()
@@ -58,10 +58,12 @@ void LUXSimEventAction::BeginOfEventAction(const G4Event* evt )
 	eventNum = evt->GetEventID();
 	if( !eventNum ) {
 		luxManager->SetRunEndedCleanly( false );
-		time( &simStartTime );
+		simStartTime = LUXSimRunStatistics::GetWallTime();
 	}
 	
 	radioactivePrimaryTime = 0;
+	
+	luxManager->GetRunStatistics()->BeginEvent();
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -76,9 +78,9 @@ void LUXSimEventAction::EndOfEventAction( const G4Event* evt )
 
 	// Print out periodic progress reports
 	if( eventNum% (luxManager->GetEventProgressFreqnecy()) == 0 ) {
-		time( &simEndTime );
+		simEndTime = LUXSimRunStatistics::GetWallTime();
 		G4cout << "\n\tProcessing event " << eventNum << " at "
-			   << difftime( simEndTime, simStartTime ) << " seconds.";
+			   << simEndTime - simStartTime << " seconds.";
 		G4cout.flush();
 	} else if( luxManager->GetEventProgressFreqnecy() >= 10 &&
                 eventNum % (luxManager->GetEventProgressFreqnecy()/10) == 0 ) {
@@ -87,7 +89,7 @@ void LUXSimEventAction::EndOfEventAction( const G4Event* evt )
 	}
 	
 	if( !luxManager->GetG4DecayBool() ){
-	  luxManager->RecordValues( eventNum );
+	  luxManager->RecordValues( luxManager->GetRandomFirstEvent() + eventNum );
 	  luxManager->ClearRecords();
 	}
 
@@ -105,4 +107,6 @@ void LUXSimEventAction::EndOfEventAction( const G4Event* evt )
 			trj->DrawTrajectory( 0 );
 		}
 	}
+	
+	luxManager->GetRunStatistics()->EndEvent( eventNum );
 }
@@ -6,6 +6,8 @@
 ********************************************************************************
 * Change log
 *	13 March 2009 - Initial submission (Kareem)
+*	17-Oct-26 - The event loop is timed in the run statistics, which are
+*				summarized at the end of the run (agent)
 *
 */
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,6 +22,7 @@
 //
 #include "LUXSimRunAction.hh"
 #include "LUXSimManager.hh"
+#include "LUXSimRunStatistics.hh"
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //					LUXSimRunAction()
@@ -44,7 +47,7 @@ void LUXSimRunAction::BeginOfRunAction( const G4Run* aRun )
 	G4cout << "### Run " << aRun->GetRunID() << " start." << G4endl;
 	time( &startTime );
 	luxManager->InitialiseEventCount();
-	
+	luxManager->GetRunStatistics()->StartPhase( "eventLoop" );
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -59,4 +62,6 @@ void LUXSimRunAction::EndOfRunAction( const G4Run* aRun )
 	G4cout << G4endl << "Run " << aRun->GetRunID() << " time to completion: "
 		   << timeDifference << " seconds" << G4endl;
 
+	luxManager->GetRunStatistics()->StopPhase( "eventLoop" );
+	luxManager->EndOfRunStatistics();
 }
@@ -37,6 +37,18 @@
 *                 liquid xenon is greater than the upper limit set in the
 *                 /LUXSim/io/upperEnergyHack command (Kareem)
 *   06-Oct-2015 - Changes to accommodate the G4Decay generator (David W).
+*   17-Oct-2026 - The step record now holds interned IDs for the particle and
+*                 process names, so no strings are copied on every step (agent)
+*   17-Oct-2026 - The detector component for the current volume is looked up
+*                 once per step, and its record levels and deposition target
+*                 are read from it directly (agent)
+*   17-Oct-2026 - Replaced the per-step string comparisons with pointer
+*                 compares: the optical photon and thermal electron definitions
+*                 are cached, ions are classified once per particle
+*                 definition, and the liquid xenon target volumes are flagged
+*                 on the components at BeamOn (agent)
+*   17-Oct-2026 - Steps are counted by particle and detector component in the
+*                 run statistics when step statistics are turned on (agent)
 */
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -48,15 +60,18 @@
 #include "G4VProcess.hh"
 #include "G4EventManager.hh"
 #include "G4StackManager.hh"
+#include "G4OpticalPhoton.hh"
 
 //
 //	LUXSim includes
 //
 #include "LUXSimSteppingAction.hh"
 #include "LUXSimManager.hh"
+#include "LUXSimRunStatistics.hh"
 #include "LUXSimDetectorComponent.hh"
 #include "LUXSimMaterials.hh"
 #include "LUXSimEventAction.hh"
+#include "G4ThermalElectron.hh"
 
 //
 //	Definitions
@@ -70,12 +85,17 @@ LUXSimSteppingAction::LUXSimSteppingAction()
 {
 	luxManager = LUXSimManager::GetManager();
 	luxManager->Register( this );
+	runStatistics = luxManager->GetRunStatistics();
 	
 	LUXSimMaterials *luxMaterials = LUXSimMaterials::GetMaterials();
 	blackiumMat = luxMaterials->Blackium();
 
 	optPhotRecordLevel = 0;
 	thermElecRecordLevel = 0;
+	theComponent = NULL;
+	
+	opticalPhotonDef = G4OpticalPhoton::Definition();
+	thermalElectronDef = G4ThermalElectron::Definition();
 }
 
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -83,6 +103,26 @@ LUXSimSteppingAction::LUXSimSteppingAction()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 LUXSimSteppingAction::~LUXSimSteppingAction() {}
 
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//				IsIon()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4bool LUXSimSteppingAction::IsIon( G4ParticleDefinition *particleDef )
+{
+	//	Ions made by the ion table carry their excitation energy in brackets,
+	//	e.g., "Rn222[0.0]". The name is only checked the first time a
+	//	definition is seen.
+	std::map<G4ParticleDefinition*,G4bool>::iterator it =
+			ionDefinitions.find( particleDef );
+	if( it != ionDefinitions.end() )
+		return it->second;
+	
+	G4bool isIon =
+			( particleDef->GetParticleName().find("[") < G4String::npos );
+	ionDefinitions[particleDef] = isIon;
+	
+	return isIon;
+}
+
 //------++++++------++++++------++++++------++++++------++++++------++++++------
 //				UserSteppingAction()
 //------++++++------++++++------++++++------++++++------++++++------++++++------
@@ -97,24 +137,34 @@ void LUXSimSteppingAction::UserSteppingAction( const G4Step* theStep )
     else {
         trackPosition = theStep->GetPostStepPoint()->GetPosition();
         particleDirection = theStep->GetPreStepPoint()->GetMomentumDirection();
-        recordLevel = luxManager->GetComponentRecordLevel(
-                (LUXSimDetectorComponent*)theTrack->GetVolume() );
-        optPhotRecordLevel = luxManager->GetComponentRecordLevelOptPhot(
-                (LUXSimDetectorComponent*)theTrack->GetVolume() );
-        thermElecRecordLevel = luxManager->GetComponentRecordLevelThermElec(
-                            (LUXSimDetectorComponent*)theTrack->GetVolume() );
+        theComponent = luxManager->FindComponent( theTrack->GetVolume() );
+        if( theComponent ) {
+            recordLevel = theComponent->GetRecordLevel();
+            optPhotRecordLevel = theComponent->GetRecordLevelOptPhot();
+            thermElecRecordLevel = theComponent->GetRecordLevelThermElec();
+        } else {
+            //  Not a detector component, so these just print the warnings and
+            //  return 0
+            recordLevel = luxManager->GetComponentRecordLevel(
+                    (LUXSimDetectorComponent*)theTrack->GetVolume() );
+            optPhotRecordLevel = luxManager->GetComponentRecordLevelOptPhot(
+                    (LUXSimDetectorComponent*)theTrack->GetVolume() );
+            thermElecRecordLevel = luxManager->GetComponentRecordLevelThermElec(
+                    (LUXSimDetectorComponent*)theTrack->GetVolume() );
+        }
         
-        //	Record relevant parameters in the step record
+        //	Record relevant parameters in the step record. The names are
+        //	stored as IDs into the manager's name table; a NULL creator process
+        //	is recorded as "primary".
+        particleDef = theTrack->GetDefinition();
         aStepRecord.stepNumber = theTrack->GetCurrentStepNumber();
-        aStepRecord.particleID = theTrack->GetDefinition()->GetPDGEncoding();
-        aStepRecord.particleName = theTrack->GetDefinition()->GetParticleName();
-        if( theTrack->GetCreatorProcess() )
-            aStepRecord.creatorProcess =
-                    theTrack->GetCreatorProcess()->GetProcessName();
-        else 
-            aStepRecord.creatorProcess = "primary";
-        aStepRecord.stepProcess = theStep->GetPostStepPoint()->
-                GetProcessDefinedStep()->GetProcessName();
+        aStepRecord.particleID = particleDef->GetPDGEncoding();
+        aStepRecord.particleNameID =
+                luxManager->GetParticleNameID( particleDef );
+        aStepRecord.creatorProcessID =
+                luxManager->GetProcessNameID( theTrack->GetCreatorProcess() );
+        aStepRecord.stepProcessID = luxManager->GetProcessNameID(
+                theStep->GetPostStepPoint()->GetProcessDefinedStep() );
         aStepRecord.trackID = theTrack->GetTrackID();
         aStepRecord.parentID = theTrack->GetParentID();
         aStepRecord.particleEnergy =
@@ -127,10 +177,13 @@ void LUXSimSteppingAction::UserSteppingAction( const G4Step* theStep )
         aStepRecord.position[1] = trackPosition.y()/cm;
         aStepRecord.position[2] = trackPosition.z()/cm;
         
+        if( runStatistics->GetStepStatistics() )
+            runStatistics->AddStep( aStepRecord.particleNameID,
+                    theComponent ? theComponent->GetID() : 0 );
+        
         //	Record whether or not the primary particle is a radioactive ion
         if( (aStepRecord.parentID==0) && (aStepRecord.stepNumber==1) &&
-                !theTrack->GetDefinition()->GetPDGStable() &&
-                (aStepRecord.particleName.find("[") < G4String::npos) )
+                !particleDef->GetPDGStable() && IsIon( particleDef ) )
             luxManager->GetEvent()->SetRadioactivePrimaryTime(
                     luxManager->GetPrimaryParticles()[0].time );
         
@@ -160,7 +213,7 @@ void LUXSimSteppingAction::UserSteppingAction( const G4Step* theStep )
 	      itMap->second = false; 
 	  }
 
-	  if( (aStepRecord.particleName.find("[")) < G4String::npos ){	   
+	  if( IsIon( particleDef ) ){	   
 	    for(itMap=radIsoMap.begin(); itMap!=radIsoMap.end(); ++itMap){
 	      if((itMap->first==aStepRecord.particleID) && (itMap->second == false)){
 		
@@ -192,51 +245,33 @@ void LUXSimSteppingAction::UserSteppingAction( const G4Step* theStep )
 	  luxManager->UpdateRadioIsotopeMap(radIsoMap);
 	}
 
-        G4bool inTheLXenonTarget = false;
-        if( luxManager->GetDetectorSelection() == "1_0Detector" &&
-                theTrack->GetVolume()->GetName() == "LiquidXenon" )
-            inTheLXenonTarget = true;
-        else if( luxManager->GetDetectorSelection() == "LZDetector" &&
-                ( theTrack->GetVolume()->GetName() == "LiquidXenonTarget" ||
-                  theTrack->GetVolume()->GetName() == "InnerLiquidXenon") )
-            inTheLXenonTarget = true;
-        else if( luxManager->GetDetectorSelection() == "LZSimple" &&
-                ( theTrack->GetVolume()->GetName() == "ActiveLiquidXenon" ||
-                  theTrack->GetVolume()->GetName() == "LiquidGammaXXenon") )
-            inTheLXenonTarget = true;
-
-        if( inTheLXenonTarget )
+        //  The target volumes for the current detector are flagged at BeamOn
+        if( theComponent && theComponent->GetLiquidXenonTarget() )
             luxManager->AddLiquidXenonEnergy( theStep->GetTotalEnergyDeposit());
         
         //	Handle the case of optical photon record keeping
-        if( aStepRecord.particleName == "opticalphoton" ) {
+        if( particleDef == opticalPhotonDef ) {
         
             aStepRecord.energyDeposition = 0;
         
             if( optPhotRecordLevel )
-                luxManager->AddDeposition(
-                        (LUXSimDetectorComponent*)theTrack->GetVolume(),
-                        aStepRecord );
+                theComponent->AddDeposition( aStepRecord );
             
             if( optPhotRecordLevel == 1 || optPhotRecordLevel == 3 )
                 theTrack->SetTrackStatus( fStopAndKill );
 
-        } else if ( aStepRecord.particleName == "thermalelectron" ){
+        } else if ( particleDef == thermalElectronDef ){
 
             aStepRecord.energyDeposition = 0;
 
             if( thermElecRecordLevel )
-                luxManager->AddDeposition(
-                        (LUXSimDetectorComponent*)theTrack->GetVolume(),
-                        aStepRecord );
+                theComponent->AddDeposition( aStepRecord );
 
             if( thermElecRecordLevel == 1 || thermElecRecordLevel == 3 )
                 theTrack->SetTrackStatus( fStopAndKill );
 
-        } else
-            luxManager->AddDeposition(
-                    (LUXSimDetectorComponent*)theTrack->GetVolume(),
-                    aStepRecord );
+        } else if( theComponent )
+            theComponent->AddDeposition( aStepRecord );
         
         //	Kill the particle if the current volume is made of blackium, or if
         //	the record level is set to 4. The blackium support is kept for
@@ -249,14 +284,16 @@ void LUXSimSteppingAction::UserSteppingAction( const G4Step* theStep )
         //	Put debugging code here
         if( DEBUGGING ) {
             G4cout << "Tracking a " << aStepRecord.particleEnergy << "-keV "
-                   << aStepRecord.particleName << " in "
+                   << particleDef->GetParticleName() << " in "
                    << theTrack->GetVolume()->GetName() << " at ( "
                    << aStepRecord.position[0] << ", " << aStepRecord.position[1]
                    << ", " << aStepRecord.position[2] << " )" << G4endl;
             G4cout << "\tTrack " << aStepRecord.trackID << ", Step "
                    << aStepRecord.stepNumber << ", process: "
-                   << aStepRecord.stepProcess << ", created by "
-                   << aStepRecord.creatorProcess << G4endl;
+                   << luxManager->GetStepName( aStepRecord.stepProcessID )
+                   << ", created by "
+                   << luxManager->GetStepName( aStepRecord.creatorProcessID )
+                   << G4endl;
     //		if( aStepRecord.particleName == "gamma" ||
     //				aStepRecord.particleName == "alpha" ||
     //				aStepRecord.particleName == "e-" ||
@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	G4S1LightSitesTest.cc
+*
+* Checks the interaction sites that G4S1Light accumulates quanta in.
+*
+* First, that the sites of one primary are still there when the next primary of
+* the same event starts, and are cleared when the next event starts, as in
+* events with several primaries (events files, AmBe, Kr83m, decay chains).
+*
+* Then, that the hashed site search of G4S1LightSites (GridFindSite) finds the
+* same interaction site as the linear scan (LinearFindSite) it replaced. Random
+* energy deposits are put down event by event the way G4S1Light does it: each
+* one either joins the first site closer than delta, or starts a new site. The
+* deposits are random walks with steps of the order of delta, with some placed
+* exactly delta from an existing site, and some sites are reset along the way.
+* Every lookup is done both ways and the two site indices compared.
+*
+* It is built against the stand-in Geant4 headers in G4Stubs, so it doesn't need
+* Geant4, and "make check" in the tools directory builds and runs it.
+*
+* Usage: G4S1LightSitesTest [number of events] [random seed]
+*
+* The exit code is 0 if every check passed, and 1 otherwise.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+//
+//	LUXSim includes
+//
+#include "G4S1LightSites.hh"
+
+using namespace std;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					Uniform()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+double Uniform( double low, double high )
+{
+	return low + (high - low) * ( rand() / (RAND_MAX + 1.) );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					RandomDirection()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+G4ThreeVector RandomDirection()
+{
+	double cosTheta = Uniform( -1, 1 );
+	double sinTheta = sqrt( 1 - cosTheta*cosTheta );
+	double phi = Uniform( 0, 2*M_PI );
+
+	return G4ThreeVector( sinTheta*cos(phi), sinTheta*sin(phi), cosTheta );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CheckPrimaries()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//	Two primaries in one event, in two materials, then a second event and a
+//	second run. Returns the number of checks that failed.
+int CheckPrimaries()
+{
+	//	Only the addresses of the materials are used, as keys
+	char liquid, gas;
+	const G4Material *liquidXenon = (const G4Material*)&liquid;
+	const G4Material *gasXenon = (const G4Material*)&gas;
+	G4ThreeVector first( 10*mm, 20*mm, 30*mm ), second( -50*mm, 0, 100*mm );
+	G4double delta = 1*mm;
+
+	G4S1LightSiteStore store;
+	int numFailures = 0;
+
+	//	The first primary of event 0 of run 0 leaves a site in the liquid
+	if( !store.StartPrimary( 0, 0 ) ) {
+		cout << "The first primary of the first event didn't clear the sites"
+			 << endl;
+		numFailures++;
+	}
+	store.Get( liquidXenon )->AddSite( first, 0 );
+
+	//	The second primary of the same event has to find it, and leaves one
+	//	in the gas, which is first seen now
+	if( store.StartPrimary( 0, 0 ) ) {
+		cout << "The second primary of an event cleared the sites" << endl;
+		numFailures++;
+	}
+	G4S1LightSites *sites = store.Get( liquidXenon );
+	if( sites->numSites != 1 || sites->FindSite( first, delta, 1 ) != 0 ) {
+		cout << "The site of the first primary is gone when the second "
+			 << "primary starts" << endl;
+		numFailures++;
+	}
+	store.Get( gasXenon )->AddSite( second, 0 );
+
+	//	A third primary still has both
+	store.StartPrimary( 0, 0 );
+	if( store.Get( liquidXenon )->numSites != 1 ||
+			store.Get( gasXenon )->numSites != 1 ) {
+		cout << "The sites of the first two primaries are gone when the third "
+			 << "primary starts" << endl;
+		numFailures++;
+	}
+
+	//	The next event, and the same event number in the next run, start with
+	//	no sites
+	int runs[2] = { 0, 1 }, events[2] = { 1, 1 };
+	for( int i=0; i<2; i++ ) {
+		if( !store.StartPrimary( runs[i], events[i] ) ||
+				store.Get( liquidXenon )->numSites != 0 ||
+				store.Get( gasXenon )->numSites != 0 ||
+				store.Get( liquidXenon )->FindSite( first, delta, 1 ) >= 0 ) {
+			cout << "The sites weren't cleared for event " << events[i]
+				 << " of run " << runs[i] << endl;
+			numFailures++;
+		}
+		store.Get( liquidXenon )->AddSite( first, 0 );
+		store.Get( gasXenon )->AddSite( second, 0 );
+	}
+
+	cout << "Sites of earlier primaries in the same event: "
+		 << ( numFailures ? "failed" : "passed" ) << endl;
+	return numFailures;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CheckGridSearch()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//	Returns the number of lookups where the grid and linear searches disagreed
+long long CheckGridSearch( int numEvents )
+{
+	//	The deltas G4S1Light uses: 1 mm, 0.4 mm for low-energy x-rays, and
+	//	an odd-sized one so that the cells don't line up with the walk
+	double deltas[3] = { 1.*mm, 0.4*mm, 0.173*mm };
+
+	G4S1LightSites sites;
+	long long numLookups = 0, numMismatches = 0, numNewSites = 0;
+	for( int event=0; event<numEvents; event++ ) {
+		sites.Reset();
+		int numSites = 0;
+
+		//	One event in 20 is a big shower, with enough sites that the
+		//	hash has to grow
+		int numTracks = 1 + rand() % 20;
+		if( rand() % 20 == 0 )
+			numTracks *= 20;
+		for( int track=0; track<numTracks; track++ ) {
+			double delta = deltas[ rand() % 3 ];
+			G4ThreeVector position( Uniform(-250,250)*mm,
+					Uniform(-250,250)*mm, Uniform(0,550)*mm );
+			int numSteps = 1 + rand() % 200;
+			for( int step=0; step<numSteps; step++ ) {
+				//	Mostly short steps, now and then a long one, and now
+				//	and then one right on the delta boundary of a site. Sites
+				//	that have been reset are parked 999 km away, where no
+				//	step can be, so they aren't aimed at
+				int kind = rand() % 10, i = numSites ? rand() % numSites : 0;
+				if( kind == 0 && numSites > 0 && sites.posX[i] < 1*km )
+					position = G4ThreeVector( sites.posX[i], sites.posY[i],
+							sites.posZ[i] ) + delta * RandomDirection();
+				else if( kind == 1 )
+					position += Uniform( 0, 20*delta ) * RandomDirection();
+				else
+					position += Uniform( 0, 1.5*delta ) * RandomDirection();
+
+				int linearSite = -1, gridSite = -1;
+				if( numSites > 0 ) {
+					linearSite = sites.LinearFindSite( position, delta,
+							numSites );
+					gridSite = sites.GridFindSite( position, delta,
+							numSites );
+				}
+				numLookups++;
+				if( linearSite != gridSite ) {
+					numMismatches++;
+					if( numMismatches <= 10 )
+						cout << "Event " << event << ": at (" << position.x()
+							 << ", " << position.y() << ", " << position.z()
+							 << ") mm with delta " << delta << " mm and "
+							 << numSites << " sites, the linear search "
+							 << "found site " << linearSite << " and the "
+							 << "grid search found site " << gridSite << endl;
+				}
+
+				if( linearSite < 0 ) {
+					sites.AddSite( position, numSites );
+					numSites++;
+					numNewSites++;
+				}
+
+				//	A site is now and then reset, as G4S1Light does
+				//	once its quanta have been dumped
+				if( numSites > 0 && rand() % 500 == 0 )
+					sites.ResetSite( rand() % numSites );
+			}
+		}
+	}
+
+	cout << numLookups << " lookups in " << numEvents << " events ("
+		 << numNewSites << " sites made), " << numMismatches
+		 << " where the grid and linear searches disagreed" << endl;
+
+	return numMismatches;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					main()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int main( int argc, char **argv )
+{
+	int numEvents = 1000;
+	unsigned int seed = 1;
+	if( argc > 1 )
+		numEvents = atoi( argv[1] );
+	if( argc > 2 )
+		seed = atoi( argv[2] );
+	if( argc > 3 || numEvents < 1 ) {
+		cout << "Usage: " << argv[0] << " [number of events] [random seed]"
+			 << endl;
+		return 1;
+	}
+	srand( seed );
+
+	int numFailures = CheckPrimaries();
+	if( CheckGridSearch( numEvents ) )
+		numFailures++;
+
+	return numFailures ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	G4ThreeVector.hh
+*
+* Stand-in for the Geant4 G4ThreeVector (CLHEP's Hep3Vector), with just the
+* parts that the tools built from LUXSim sources need.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef G4ThreeVector_hh
+#define G4ThreeVector_hh 1
+
+class G4ThreeVector
+{
+	public:
+		G4ThreeVector( double x=0, double y=0, double z=0 )
+				{ dx = x; dy = y; dz = z; };
+
+		double x() const { return dx; };
+		double y() const { return dy; };
+		double z() const { return dz; };
+
+		G4ThreeVector &operator+=( const G4ThreeVector &v )
+				{ dx += v.dx; dy += v.dy; dz += v.dz; return *this; };
+		G4ThreeVector operator+( const G4ThreeVector &v ) const
+				{ return G4ThreeVector( dx+v.dx, dy+v.dy, dz+v.dz ); };
+
+	private:
+		double dx, dy, dz;
+};
+
+inline G4ThreeVector operator*( double a, const G4ThreeVector &v )
+{
+	return G4ThreeVector( a*v.x(), a*v.y(), a*v.z() );
+}
+
+#endif
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	globals.hh
+*
+* Stand-in for the Geant4 globals.hh, with just the types and units that the
+* tools built from LUXSim sources (G4S1LightSitesTest) need, so that they build
+* without Geant4. The units have the Geant4 values (mm, ns and MeV are 1).
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef globals_hh
+#define globals_hh 1
+
+typedef double G4double;
+typedef int G4int;
+typedef bool G4bool;
+
+static const G4double mm = 1.;
+static const G4double um = 1.e-3*mm;
+static const G4double km = 1.e6*mm;
+static const G4double ns = 1.;
+static const G4double MeV = 1.;
+static const G4double keV = 1.e-3*MeV;
+static const G4double eV = 1.e-6*MeV;
+
+#endif
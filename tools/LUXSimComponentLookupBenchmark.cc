@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimComponentLookupBenchmark.cc
+*
+* Times the per-step lookup of the detector component a track is in, as
+* LUXSimSteppingAction::UserSteppingAction does it. The old way made four scans
+* of the manager's component list per step (the three record levels and the
+* deposition), and the new way is LUXSimManager::FindComponent, which goes
+* straight to the component's slot by its ID, followed by reads of the
+* component itself.
+*
+* The physical volume and component classes here are stand-ins with the same
+* shape as G4VPhysicalVolume and LUXSimDetectorComponent (a polymorphic base,
+* a derived class with the ID and record levels, each one allocated on its
+* own), so that the lookup code below is the LUXSim code, but the benchmark
+* doesn't need Geant4. Every step is in a randomly chosen component. The
+* warnings for volumes that aren't components are left out, as they print.
+*
+* Usage: LUXSimComponentLookupBenchmark [number of components] [number of steps]
+*
+* The defaults are 140 components, about the number in the LUX detector, and
+* 10^7 steps.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <iostream>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+using namespace std;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//
+//	Stand-ins for G4VPhysicalVolume and LUXSimDetectorComponent
+//
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+class PhysicalVolume
+{
+	public:
+		virtual ~PhysicalVolume() {};
+		char geometry[200];
+};
+
+class DetectorComponent : public PhysicalVolume
+{
+	public:
+		DetectorComponent() { compID = 0; recordLevel = 1;
+				recordLevelOptPhot = 0; recordLevelThermElec = 0;
+				totalEnergy = 0; };
+		void SetID( int ID ) { compID = ID; };
+		int GetID() { return compID; };
+		int GetRecordLevel() { return recordLevel; };
+		int GetRecordLevelOptPhot() { return recordLevelOptPhot; };
+		int GetRecordLevelThermElec() { return recordLevelThermElec; };
+		void AddDeposition( double energy ) { totalEnergy += energy; };
+		double GetTotalEnergy() { return totalEnergy; };
+
+	private:
+		int compID;
+		int recordLevel, recordLevelOptPhot, recordLevelThermElec;
+		double totalEnergy;
+};
+
+vector<DetectorComponent*> luxSimComponents;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//
+//	The old lookups: GetComponentRecordLevel, GetComponentRecordLevelOptPhot,
+//	GetComponentRecordLevelThermElec and AddDeposition each scanned the list
+//
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int ScanRecordLevel( DetectorComponent *component )
+{
+	for( int i=0; i<(int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component )
+			return( component->GetRecordLevel() );
+	return 0;
+}
+
+int ScanRecordLevelOptPhot( DetectorComponent *component )
+{
+	for( int i=0; i<(int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component )
+			return( component->GetRecordLevelOptPhot() );
+	return 0;
+}
+
+int ScanRecordLevelThermElec( DetectorComponent *component )
+{
+	for( int i=0; i<(int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component )
+			return( component->GetRecordLevelThermElec() );
+	return 0;
+}
+
+void ScanAddDeposition( DetectorComponent *component, double energy )
+{
+	for( int i=0; i<(int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component ) {
+			luxSimComponents[i]->AddDeposition( energy );
+			i = (int)luxSimComponents.size();
+		}
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					FindComponent()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+DetectorComponent *FindComponent( PhysicalVolume *physVol )
+{
+	DetectorComponent *component = dynamic_cast<DetectorComponent*>( physVol );
+	if( !component )
+		return NULL;
+
+	int index = component->GetID() - 1;
+	if( index >= 0 && index < (int)luxSimComponents.size() &&
+			luxSimComponents[index] == component )
+		return component;
+
+	for( int i=0; i<(int)luxSimComponents.size(); i++ )
+		if( luxSimComponents[i] == component )
+			return component;
+
+	return NULL;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					main()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int main( int argc, char **argv )
+{
+	int numComponents = 140;
+	int numSteps = 10000000;
+	if( argc > 1 )
+		numComponents = atoi( argv[1] );
+	if( argc > 2 )
+		numSteps = atoi( argv[2] );
+	if( argc > 3 || numComponents < 1 || numSteps < 1 ) {
+		cout << "Usage: " << argv[0]
+			 << " [number of components] [number of steps]" << endl;
+		return 1;
+	}
+
+	//	Components are registered in the order they're made, and BeamOn
+	//	gives each its position in the list, plus one, as its ID
+	for( int i=0; i<numComponents; i++ ) {
+		luxSimComponents.push_back( new DetectorComponent() );
+		luxSimComponents[i]->SetID( i+1 );
+	}
+
+	//	The volumes the steps are in, picked before the timing starts
+	srand( 1 );
+	vector<PhysicalVolume*> stepVolumes( numSteps );
+	for( int i=0; i<numSteps; i++ )
+		stepVolumes[i] = luxSimComponents[ rand() % numComponents ];
+
+	clock_t start = clock();
+	int levels = 0;
+	for( int i=0; i<numSteps; i++ ) {
+		DetectorComponent *component = (DetectorComponent*)stepVolumes[i];
+		levels += ScanRecordLevel( component );
+		levels += ScanRecordLevelOptPhot( component );
+		levels += ScanRecordLevelThermElec( component );
+		ScanAddDeposition( component, 1. );
+	}
+	double scanTime = double( clock() - start ) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for( int i=0; i<numSteps; i++ ) {
+		DetectorComponent *component = FindComponent( stepVolumes[i] );
+		if( component ) {
+			levels += component->GetRecordLevel();
+			levels += component->GetRecordLevelOptPhot();
+			levels += component->GetRecordLevelThermElec();
+			component->AddDeposition( 1. );
+		}
+	}
+	double findTime = double( clock() - start ) / CLOCKS_PER_SEC;
+
+	//	Both loops add up the same things, so this checks that they found
+	//	the same components, and keeps the compiler from dropping the loops
+	double totalEnergy = 0;
+	for( int i=0; i<numComponents; i++ )
+		totalEnergy += luxSimComponents[i]->GetTotalEnergy();
+	if( levels != 2*numSteps || totalEnergy != 2.*numSteps ) {
+		cout << "The two lookups found different components" << endl;
+		return 1;
+	}
+
+	cout << numComponents << " components, " << numSteps << " steps" << endl;
+	cout << "Four scans of the component list: " << 1e9*scanTime/numSteps
+		 << " ns per step" << endl;
+	cout << "FindComponent:                    " << 1e9*findTime/numSteps
+		 << " ns per step" << endl;
+
+	for( int i=0; i<numComponents; i++ )
+		delete luxSimComponents[i];
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimEventsFileConverter.cc
+*
+* Converts a text events file for the EventsFile generator into the binary
+* format that LUXSimEventsFile memory-maps. The text file has one deposit per
+* line,
+*
+*	<event number> <particle ID> <energy (keV)> <x (cm)> <y (cm)> <z (cm)>
+*
+* with the deposits of each event on consecutive lines. The binary file is a
+* header (format tag, version, number of deposits, number of events), the
+* deposits, and an index holding the position of the first deposit of each
+* event plus one entry for the end. The layout has to match
+* generator/include/LUXSimEventsFile.hh.
+*
+* The text file is streamed, so files larger than memory can be converted.
+*
+* Usage: LUXSimEventsFileConverter <input.txt> [output.evb]
+*
+* The exit code is 0 if the whole text file was converted, and 1 otherwise. A
+* line that isn't a deposit stops the conversion; the deposits before it are
+* still written out, but the exit code is 1.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Errors exit with 1 rather than 0 (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+#define EVENTSFILE_TAG 0x4C584556
+#define EVENTSFILE_VERSION 1
+
+using namespace std;
+
+struct eventsFileDeposit {
+	int eventNumber;
+	int particleID;
+	double energy_keV;
+	double position_cm[3];
+};
+
+struct eventsFileHeader {
+	int formatTag;
+	int version;
+	long long numDeposits;
+	long long numEvents;
+};
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int main( int argc, char** argv )
+{
+	if( argc < 2 ) {
+		cout << "Usage: " << argv[0] << " <input.txt> [output.evb]" << endl;
+		exit( 1 );
+	}
+
+	string inputName = argv[1];
+	string outputName;
+	if( argc > 2 )
+		outputName = argv[2];
+	else {
+		size_t dot = inputName.rfind( '.' );
+		if( dot != string::npos && inputName.find( '/', dot ) == string::npos )
+			outputName = inputName.substr( 0, dot ) + ".evb";
+		else
+			outputName = inputName + ".evb";
+	}
+
+	ifstream inputFile( inputName.c_str() );
+	if( !inputFile.is_open() ) {
+		cout << "Couldn't find the file " << inputName << endl;
+		exit( 1 );
+	}
+
+	ofstream outputFile( outputName.c_str(), ios::binary|ios::out );
+	if( !outputFile.is_open() ) {
+		cout << "Couldn't open " << outputName << " for writing" << endl;
+		exit( 1 );
+	}
+
+	//	The header is written again at the end, once the counts are known
+	eventsFileHeader header;
+	header.formatTag = EVENTSFILE_TAG;
+	header.version = EVENTSFILE_VERSION;
+	header.numDeposits = 0;
+	header.numEvents = 0;
+	outputFile.write( (char *)(&header), sizeof(header) );
+
+	vector<long long> eventStart;
+	eventsFileDeposit deposit;
+	int lastEventNumber = 0;
+	while( 1 ) {
+		inputFile >> deposit.eventNumber >> deposit.particleID
+				  >> deposit.energy_keV >> deposit.position_cm[0]
+				  >> deposit.position_cm[1] >> deposit.position_cm[2];
+		if( inputFile.fail() )
+			break;
+
+		//	A new event starts wherever the event number changes
+		if( header.numDeposits == 0 || deposit.eventNumber != lastEventNumber )
+			eventStart.push_back( header.numDeposits );
+		lastEventNumber = deposit.eventNumber;
+
+		outputFile.write( (char *)(&deposit), sizeof(deposit) );
+		header.numDeposits++;
+	}
+	bool readAll = inputFile.eof();
+	if( !readAll )
+		cout << "Stopped reading " << inputName << " at a line that isn't a "
+			 << "deposit, after " << header.numDeposits << " deposits" << endl;
+	inputFile.close();
+
+	header.numEvents = eventStart.size();
+	eventStart.push_back( header.numDeposits );
+	outputFile.write( (char *)(&eventStart[0]),
+			eventStart.size()*sizeof(long long) );
+
+	outputFile.seekp( 0, ios::beg );
+	outputFile.write( (char *)(&header), sizeof(header) );
+	outputFile.close();
+
+	if( !outputFile.good() ) {
+		cout << "Error writing " << outputName << endl;
+		exit( 1 );
+	}
+
+	if( DEBUGGING )
+		for( int i=0; i<(int)header.numEvents; i++ )
+			cout << "event " << i << ": deposits " << eventStart[i] << " to "
+				 << eventStart[i+1]-1 << endl;
+
+	cout << "Converted " << header.numDeposits << " deposits in "
+		 << header.numEvents << " events from " << inputName << " to "
+		 << outputName << endl;
+
+	return ( readAll ? 0 : 1 );
+}
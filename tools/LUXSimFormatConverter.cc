@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimFormatConverter.cc
+*
+* Converts a LUXSim .bin file written with /LUXSim/io/outputFormat 2 into the
+* legacy (version 1) format, so that the existing readers can be used on it.
+*
+* Version 2 files begin with the format tag -2, the number of records, and the
+* 64-bit offset of the name table at the end of the file. Each step carries
+* three int IDs into that table (particle name, creator process, step
+* process) where the legacy format has three length-prefixed strings.
+* Everything else is identical, so the conversion copies the file record by
+* record and expands the IDs.
+*
+* Usage: LUXSimFormatConverter <input.bin> [output.bin]
+*
+* The exit code is 0 if the file was converted (or already is in the legacy
+* format), and 1 otherwise.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Errors exit with 1 rather than 0 (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+using namespace std;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//
+//  Note that the input and output files are declared here with global scope,
+//  to avoid passing them to every copy method.
+//
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+ifstream inputFile;
+ofstream outputFile;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CopyBytes()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void CopyBytes( int numBytes )
+{
+	static vector<char> buffer;
+
+	if( numBytes <= 0 )
+		return;
+	if( (int)buffer.size() < numBytes )
+		buffer.resize( numBytes );
+
+	inputFile.read( &buffer[0], numBytes );
+	outputFile.write( &buffer[0], numBytes );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CopyInt()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int CopyInt()
+{
+	int value;
+	inputFile.read( (char *)(&value), sizeof(int) );
+	outputFile.write( (char *)(&value), sizeof(int) );
+
+	return value;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CopyString()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void CopyString()
+{
+	int stringSize = CopyInt();
+	CopyBytes( stringSize );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					WriteString()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void WriteString( const string &str )
+{
+	int stringSize = str.length();
+	outputFile.write( (char *)(&stringSize), sizeof(int) );
+	outputFile.write( str.c_str(), stringSize );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int main( int argc, char** argv )
+{
+	if( argc < 2 ) {
+		cout << "Usage: " << argv[0] << " <input.bin> [output.bin]" << endl;
+		exit( 1 );
+	}
+
+	string inputName = argv[1];
+	string outputName;
+	if( argc > 2 )
+		outputName = argv[2];
+	else if( inputName.length() > 4 &&
+			inputName.substr( inputName.length()-4 ) == ".bin" )
+		outputName = inputName.substr( 0, inputName.length()-4 ) +
+				"_legacy.bin";
+	else
+		outputName = inputName + "_legacy.bin";
+
+	inputFile.open( inputName.c_str(), ios::binary|ios::in );
+	if( !inputFile.is_open() ) {
+		cout << "Couldn't find the file " << inputName << endl;
+		exit( 1 );
+	}
+
+	//	Check the format tag. Legacy files start with the (non-negative) number
+	//	of records, so there is nothing to do for them.
+	int formatTag;
+	inputFile.read( (char *)(&formatTag), sizeof(int) );
+	if( formatTag >= 0 ) {
+		cout << inputName << " is already in the legacy format" << endl;
+		return 0;
+	}
+	if( formatTag != -2 ) {
+		cout << inputName << " has an unknown format tag (" << formatTag << ")"
+			 << endl;
+		exit( 1 );
+	}
+
+	int numRecords;
+	long long tableOffset;
+	inputFile.read( (char *)(&numRecords), sizeof(int) );
+	inputFile.read( (char *)(&tableOffset), sizeof(long long) );
+	if( tableOffset <= 0 ) {
+		cout << inputName << " has no name table. Did the run end cleanly?"
+			 << endl;
+		exit( 1 );
+	}
+
+	//	Read in the name table from the end of the file, then go back to where
+	//	the header strings start
+	streampos headerEnd = inputFile.tellg();
+	inputFile.seekg( tableOffset, ios::beg );
+
+	int numNames = -1;
+	inputFile.read( (char *)(&numNames), sizeof(int) );
+	if( !inputFile.good() || numNames < 0 ) {
+		cout << "Couldn't read the name table from " << inputName << endl;
+		exit( 1 );
+	}
+	vector<string> nameTable( numNames );
+	for( int i=0; i<numNames; i++ ) {
+		int stringSize;
+		inputFile.read( (char *)(&stringSize), sizeof(int) );
+		nameTable[i].resize( stringSize );
+		if( stringSize )
+			inputFile.read( &nameTable[i][0], stringSize );
+	}
+	if( !inputFile.good() ) {
+		cout << "Couldn't read the name table from " << inputName << endl;
+		exit( 1 );
+	}
+	if( DEBUGGING )
+		for( int i=0; i<numNames; i++ )
+			cout << "name " << i << " = " << nameTable[i] << endl;
+
+	inputFile.seekg( headerEnd );
+
+	outputFile.open( outputName.c_str(), ios::binary|ios::out );
+	if( !outputFile.is_open() ) {
+		cout << "Couldn't open " << outputName << " for writing" << endl;
+		exit( 1 );
+	}
+
+	//	Header: number of records, then production time, Geant4 version,
+	//	LUXSim version, uname, input commands, diffs and the detector component
+	//	table
+	outputFile.write( (char *)(&numRecords), sizeof(int) );
+	for( int i=0; i<7; i++ )
+		CopyString();
+
+	//	The size of the datalevel struct written by LUXSimOutput: four ints
+	//	and nine doubles
+	const int dataSize = 4*sizeof(int) + 9*sizeof(double);
+
+	for( int i=0; i<numRecords; i++ ) {
+		//	Primary particles: name, then energy, time, position and direction
+		int primaryParNum = CopyInt();
+		for( int j=0; j<primaryParNum; j++ ) {
+			CopyString();
+			CopyBytes( 8*sizeof(double) );
+		}
+
+		int recordLevel = CopyInt();
+		int optPhotRecordLevel = CopyInt();
+		int thermElecRecordLevel = CopyInt();
+		int volume = CopyInt();
+		int eventNum = CopyInt();
+		if( recordLevel > 0 ) CopyBytes( sizeof(double) );
+		if( optPhotRecordLevel > 0 ) CopyInt();
+		if( thermElecRecordLevel > 0 ) CopyInt();
+		int recordSize = CopyInt();
+
+		if( DEBUGGING )
+			cout << "record " << i << ": volume " << volume << ", event "
+				 << eventNum << ", " << recordSize << " steps" << endl;
+
+		for( int k=0; k<recordSize; k++ ) {
+			int nameIDs[3];
+			inputFile.read( (char *)(nameIDs), 3*sizeof(int) );
+			for( int n=0; n<3; n++ ) {
+				if( nameIDs[n] < 0 || nameIDs[n] >= numNames ) {
+					cout << "Name ID " << nameIDs[n] << " in record " << i
+						 << " is not in the name table" << endl;
+					exit( 1 );
+				}
+				WriteString( nameTable[nameIDs[n]] );
+			}
+			CopyBytes( dataSize );
+		}
+
+		if( !inputFile.good() ) {
+			cout << "Unexpected end of " << inputName << " in record " << i
+				 << endl;
+			exit( 1 );
+		}
+	}
+
+	inputFile.close();
+	outputFile.close();
+	if( !outputFile.good() ) {
+		cout << "Couldn't write all of " << outputName << endl;
+		exit( 1 );
+	}
+
+	cout << "Converted " << numRecords << " records from " << inputName
+		 << " to " << outputName << endl;
+
+	return 0;
+}
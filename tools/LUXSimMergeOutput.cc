@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////////////////////
+/*	LUXSimMergeOutput.cc
+*
+* Concatenates several legacy-format LUXSim .bin files into a single file, e.g.
+* the outputs of one job split across several processes. The header (time
+* stamp, versions, commands, diffs and detector component table) is taken from
+* the first file, the record counts are summed, and the event numbers of each
+* file are shifted past the events of the files before it. Files from shards
+* run with /LUXSim/randomFirstEvent already number their events from the start
+* of the whole job, so theirs are kept as they are.
+*
+* The number of events in a file is taken from the last /LUXSim/beamOn in its
+* recorded commands, or from its highest recorded event number if there isn't
+* one. Files written with /LUXSim/io/outputFormat 2 have to be run through
+* LUXSimFormatConverter first.
+*
+* Usage: LUXSimMergeOutput <output.bin> <input1.bin> [input2.bin ...]
+*
+* The exit code is 0 if the files were merged, and 1 otherwise.
+*
+********************************************************************************
+* Change log
+*	17 Oct 2026 - Initial submission (agent)
+*	17 Oct 2026 - Event numbers of files with a /LUXSim/randomFirstEvent are not
+*				  shifted (agent)
+*	17 Oct 2026 - Errors exit with 1 rather than 0 (agent)
+*/
+////////////////////////////////////////////////////////////////////////////////
+
+//
+//	C/C++ includes
+//
+#include <fstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+//
+//	Definitions
+//
+#define DEBUGGING 0
+
+using namespace std;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//
+//  Note that the input and output files are declared here with global scope,
+//  to avoid passing them to every copy method.
+//
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+ifstream inputFile;
+ofstream outputFile;
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadInt()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int ReadInt()
+{
+	int value;
+	inputFile.read( (char *)(&value), sizeof(int) );
+
+	return value;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					ReadString()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+string ReadString()
+{
+	int stringSize = ReadInt();
+	string str( stringSize, ' ' );
+	if( stringSize )
+		inputFile.read( &str[0], stringSize );
+
+	return str;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					WriteInt()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void WriteInt( int value )
+{
+	outputFile.write( (char *)(&value), sizeof(int) );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					WriteString()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void WriteString( const string &str )
+{
+	WriteInt( str.length() );
+	outputFile.write( str.c_str(), str.length() );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CopyBytes()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+void CopyBytes( int numBytes )
+{
+	static vector<char> buffer;
+
+	if( numBytes <= 0 )
+		return;
+	if( (int)buffer.size() < numBytes )
+		buffer.resize( numBytes );
+
+	inputFile.read( &buffer[0], numBytes );
+	outputFile.write( &buffer[0], numBytes );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					CopyInt()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int CopyInt()
+{
+	int value = ReadInt();
+	WriteInt( value );
+
+	return value;
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetNumEventsFromCommands()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int GetNumEventsFromCommands( const string &commands )
+{
+	//	Returns the argument of the last /LUXSim/beamOn command, or -1
+	const string beamOn = "/LUXSim/beamOn";
+	size_t pos = commands.rfind( beamOn );
+	if( pos == string::npos )
+		return -1;
+
+	return atoi( commands.c_str() + pos + beamOn.length() );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+//					GetFirstEventFromCommands()
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int GetFirstEventFromCommands( const string &commands )
+{
+	//	Returns the argument of the last /LUXSim/randomFirstEvent command, or
+	//	-1
+	const string firstEvent = "/LUXSim/randomFirstEvent";
+	size_t pos = commands.rfind( firstEvent );
+	if( pos == string::npos )
+		return -1;
+
+	return atoi( commands.c_str() + pos + firstEvent.length() );
+}
+
+//------++++++------++++++------++++++------++++++------++++++------++++++------
+int main( int argc, char** argv )
+{
+	if( argc < 3 ) {
+		cout << "Usage: " << argv[0]
+			 << " <output.bin> <input1.bin> [input2.bin ...]" << endl;
+		exit( 1 );
+	}
+
+	outputFile.open( argv[1], ios::binary|ios::out );
+	if( !outputFile.is_open() ) {
+		cout << "Couldn't open " << argv[1] << " for writing" << endl;
+		exit( 1 );
+	}
+
+	//	The size of the datalevel struct written by LUXSimOutput: four ints
+	//	and nine doubles
+	const int dataSize = 4*sizeof(int) + 9*sizeof(double);
+
+	int totalRecords = 0;
+	int eventOffset = 0;
+
+	for( int f=2; f<argc; f++ ) {
+		inputFile.open( argv[f], ios::binary|ios::in );
+		if( !inputFile.is_open() ) {
+			cout << "Couldn't find the file " << argv[f] << endl;
+			exit( 1 );
+		}
+
+		int numRecords = ReadInt();
+		if( numRecords < 0 ) {
+			cout << argv[f] << " is not in the legacy format. Convert it with "
+				 << "LUXSimFormatConverter first." << endl;
+			exit( 1 );
+		}
+
+		//	Header strings: production time, Geant4 version, LUXSim version,
+		//	uname, input commands, diffs and the detector component table.
+		//	Only the first file's header goes into the output.
+		vector<string> header( 7 );
+		for( int i=0; i<7; i++ )
+			header[i] = ReadString();
+		if( f == 2 ) {
+			WriteInt( 0 );
+			for( int i=0; i<7; i++ )
+				WriteString( header[i] );
+		}
+
+		//	A shard's event numbers already count from the start of the job
+		int firstEvent = GetFirstEventFromCommands( header[4] );
+		int fileOffset = ( firstEvent >= 0 ) ? 0 : eventOffset;
+
+		int maxEventNum = -1;
+		for( int i=0; i<numRecords; i++ ) {
+			int primaryParNum = CopyInt();
+			for( int j=0; j<primaryParNum; j++ ) {
+				int stringSize = CopyInt();
+				CopyBytes( stringSize );
+				CopyBytes( 8*sizeof(double) );
+			}
+
+			int recordLevel = CopyInt();
+			int optPhotRecordLevel = CopyInt();
+			int thermElecRecordLevel = CopyInt();
+			CopyInt();	//	volume
+			int eventNum = ReadInt();
+			if( eventNum > maxEventNum )
+				maxEventNum = eventNum;
+			WriteInt( eventNum + fileOffset );
+			if( recordLevel > 0 ) CopyBytes( sizeof(double) );
+			if( optPhotRecordLevel > 0 ) CopyInt();
+			if( thermElecRecordLevel > 0 ) CopyInt();
+			int recordSize = CopyInt();
+
+			for( int k=0; k<recordSize; k++ ) {
+				for( int n=0; n<3; n++ ) {
+					int stringSize = CopyInt();
+					CopyBytes( stringSize );
+				}
+				CopyBytes( dataSize );
+			}
+
+			if( !inputFile.good() ) {
+				cout << "Unexpected end of " << argv[f] << " in record " << i
+					 << endl;
+				exit( 1 );
+			}
+		}
+		inputFile.close();
+		inputFile.clear();
+
+		//	The event after the last one of this file
+		int endEvent = GetNumEventsFromCommands( header[4] );
+		if( firstEvent > 0 && endEvent >= 0 )
+			endEvent += firstEvent;
+		if( endEvent <= maxEventNum )
+			endEvent = maxEventNum + 1;
+		if( firstEvent < 0 )
+			endEvent += eventOffset;
+
+		if( DEBUGGING )
+			cout << argv[f] << ": " << numRecords << " records, event offset "
+				 << fileOffset << ", events up to " << endEvent << endl;
+
+		totalRecords += numRecords;
+		if( endEvent > eventOffset )
+			eventOffset = endEvent;
+	}
+
+	outputFile.seekp( 0, ios::beg );
+	WriteInt( totalRecords );
+	outputFile.close();
+	if( !outputFile.good() ) {
+		cout << "Couldn't write all of " << argv[1] << endl;
+		exit( 1 );
+	}
+
+	cout << "Merged " << totalRecords << " records from " << argc-2
+		 << " files (" << eventOffset << " events) into " << argv[1] << endl;
+
+	return 0;
+}